@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace RSim::Core
+{
+	/**
+	 * \brief Hands out memory by bumping an offset through a list of fixed-size blocks. Nothing is freed individually: Reset() rewinds
+	 * to the first block and keeps every block for reuse, so an arena that is reset every frame stops allocating once it has grown to
+	 * the frame's peak. Allocations never move.
+	 */
+	class LinearArena
+	{
+	public:
+		explicit LinearArena(std::size_t BlockSize = DefaultBlockSize) : m_BlockSize(BlockSize) {}
+		LinearArena(LinearArena const&) = delete;
+		LinearArena& operator=(LinearArena const&) = delete;
+		LinearArena(LinearArena&&) noexcept = default;
+		LinearArena& operator=(LinearArena&&) noexcept = default;
+
+		/**
+		 * \param Alignment Power of two no larger than alignof(std::max_align_t).
+		 */
+		[[nodiscard]] void* Allocate(std::size_t Size, std::size_t Alignment);
+
+		void Reset();
+
+		/**
+		 * \brief Bytes handed out since the last Reset(), including alignment padding.
+		 */
+		[[nodiscard]] std::size_t GetUsedSize() const { return m_UsedSize; }
+
+		static constexpr std::size_t DefaultBlockSize = 64 * 1024;
+	private:
+		struct Block
+		{
+			std::unique_ptr<std::byte[]> Memory;
+			std::size_t Size;
+		};
+
+		std::size_t m_BlockSize;
+		std::vector<Block> m_Blocks;
+		std::size_t m_CurrentBlock{ 0 };
+		std::size_t m_Offset{ 0 };
+		std::size_t m_UsedSize{ 0 };
+	};
+}
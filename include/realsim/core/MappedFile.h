@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <filesystem>
+
+namespace RSim::Core
+{
+	/**
+	 * \brief A read-only memory mapping of a whole file. The operating system pages the file in as it is read instead of copying it
+	 * into a buffer first. The view starts at a page boundary.
+	 */
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		MappedFile(MappedFile const&) = delete;
+		MappedFile& operator=(MappedFile const&) = delete;
+		MappedFile(MappedFile&& rhs) noexcept;
+		MappedFile& operator=(MappedFile&& rhs) noexcept;
+		~MappedFile();
+
+		/**
+		 * \return Whether the file could be opened and mapped. An empty file maps to a valid, empty view.
+		 */
+		bool Open(std::filesystem::path const& Path);
+		void Close();
+
+		[[nodiscard]] bool IsOpen() const { return m_IsOpen; }
+		[[nodiscard]] std::byte const* GetData() const { return m_pData; }
+		[[nodiscard]] std::size_t GetSize() const { return m_Size; }
+	private:
+		std::byte const* m_pData{ nullptr };
+		std::size_t m_Size{ 0 };
+		bool m_IsOpen{ false };
+#ifdef _WIN32
+		void* m_FileHandle{ nullptr };
+		void* m_MappingHandle{ nullptr };
+#endif
+	};
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace RSim::Core
+{
+	class ThreadPool;
+
+	/**
+	 * \brief A 64-bit key and the index of the item it was computed for.
+	 */
+	struct RadixSortEntry
+	{
+		uint64_t Key;
+		uint32_t Value;
+	};
+
+	/**
+	 * \brief Stable LSD radix sort of the entries by key, one byte per pass. Passes whose byte is the same for every key are skipped,
+	 * so keys that only use their low bits are cheap to sort.
+	 * Each pass splits the entries into fixed ranges: every task builds the histogram of its range, the histograms are scanned on the
+	 * calling thread and every task then scatters its range into its own slice of each bucket.
+	 * \param pPool Thread pool to run the passes on, nullptr sorts on the calling thread.
+	 * \param pScratch Buffer of at least Count entries, its contents are overwritten.
+	 */
+	void RadixSort(ThreadPool* pPool, RadixSortEntry* pEntries, RadixSortEntry* pScratch, std::size_t Count);
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace RSim::Core
+{
+	/**
+	 * \brief A fixed set of worker threads with a job queue each. A worker runs the newest job of its own queue first and, once that
+	 * is empty, steals the oldest job of another worker's queue. Jobs submitted from a worker go to that worker's queue, jobs submitted
+	 * from any other thread are spread over the queues round-robin.
+	 * Threads that wait for jobs to finish, in ParallelFor() or through RunPendingJob(), run queued jobs in the meantime, so jobs may
+	 * submit and wait for more jobs without tying up workers.
+	 */
+	class ThreadPool
+	{
+	public:
+		using Job = std::function<void()>;
+		/**
+		 * \brief Called once per task with the half-open item range [Begin, End) and the task index in [0, NumTasks).
+		 */
+		using RangeFunction = std::function<void(std::size_t Begin, std::size_t End, std::size_t TaskIndex)>;
+
+		/**
+		 * \param NumThreads Number of worker threads. Zero creates no workers, every job then runs on the calling thread.
+		 */
+		explicit ThreadPool(std::size_t NumThreads = DefaultNumThreads());
+		ThreadPool(ThreadPool const&) = delete;
+		ThreadPool& operator=(ThreadPool const&) = delete;
+		~ThreadPool();
+
+		/**
+		 * \brief Queues a job. Jobs run on workers, where nothing can catch what they throw, so they must not throw.
+		 */
+		void Submit(Job job);
+
+		/**
+		 * \brief Runs one queued job on the calling thread, the calling worker's own newest job first if it is a worker. The job may be
+		 * anyone's, so it is held to the same contract as on a worker: an exception that escapes it terminates the program.
+		 * \return Whether a job was run.
+		 */
+		bool RunPendingJob();
+
+		/**
+		 * \brief Splits [0, Count) into at most GetMaxParallelism() contiguous ranges of at least MinItemsPerTask items, runs them
+		 * on the workers and the calling thread, and returns when all of them are done. Safe to call from inside a job.
+		 * If tasks throw, the remaining tasks still run and the first exception is rethrown on the calling thread once all are done.
+		 * \return The number of tasks the range was split into.
+		 */
+		std::size_t ParallelFor(std::size_t Count, std::size_t MinItemsPerTask, RangeFunction const& Function);
+
+		[[nodiscard]] std::size_t GetNumThreads() const { return m_Workers.size(); }
+		/**
+		 * \brief Maximum number of tasks ParallelFor splits into: the workers plus the calling thread.
+		 */
+		[[nodiscard]] std::size_t GetMaxParallelism() const { return m_Workers.size() + 1; }
+
+		/**
+		 * \brief One worker per hardware thread, leaving one for the thread that submits work.
+		 */
+		[[nodiscard]] static std::size_t DefaultNumThreads();
+	private:
+		struct WorkerQueue
+		{
+			std::mutex Mutex;
+			std::deque<Job> Jobs;
+		};
+
+		void WorkerLoop(std::size_t WorkerIndex);
+		/**
+		 * \brief Pops the newest job of the given queue, or steals the oldest job of another one.
+		 */
+		bool TryPopJob(std::size_t QueueIndex, Job& job);
+	private:
+		std::vector<std::thread> m_Workers;
+		std::vector<std::unique_ptr<WorkerQueue>> m_Queues;
+		std::atomic<std::size_t> m_NextQueue{ 0 };
+		/**
+		 * \brief Jobs in the queues, the workers sleep while it is zero. Only changed while the queue the job goes into or comes out of
+		 * is locked, always locked before m_Mutex.
+		 */
+		std::size_t m_NumPendingJobs = 0;
+		std::mutex m_Mutex;
+		std::condition_variable m_HasJobs;
+		bool m_Exit = false;
+	};
+}
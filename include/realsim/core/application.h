@@ -9,6 +9,7 @@
 #include "realsim/core/Window.h"
 #include "realsim/core/Input.h"
 #include "realsim/core/Logger.h"
+#include "realsim/core/ThreadPool.h"
 
 #include "realsim/graphics/Renderer.h"
 #include "realsim/graphics/RealSimGraphics.h"
@@ -76,6 +77,10 @@ namespace RSim::Core
         std::unique_ptr<Window> m_MainWindow;
         std::vector<std::unique_ptr<Window>> m_OtherWindows;
 
+        /**
+         * \brief Shared by the renderer and the scene's systems, which run one after the other. Declared first so that it outlives both.
+         */
+        std::unique_ptr<ThreadPool> m_ThreadPool;
         std::unique_ptr<GFX::Renderer> m_Renderer;
 
         std::unique_ptr<ECS::Scene> m_Scene;
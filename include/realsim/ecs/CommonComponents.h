@@ -6,6 +6,8 @@
 #include <string_view>
 #include <Eigen/Eigen>
 
+#include "realsim/ecs/NamePool.h"
+
 namespace RSim::ECS
 {
     struct TransformComponent
@@ -31,6 +33,25 @@ namespace RSim::ECS
         DirectX::XMFLOAT3 Scale{1.0f,1.0f,1.0f};
     };
 
+    /**
+     * \brief World matrix of an entity: its local transform composed with the world transforms of its ancestors. Written by the
+     * TransformSystem, do not modify it directly.
+     */
+    struct WorldTransformComponent
+    {
+        [[nodiscard]] DirectX::XMMATRIX GetTransform() const noexcept { return DirectX::XMLoadFloat4x4(&World); }
+
+        DirectX::XMFLOAT4X4 World{ 1.0f, 0.0f, 0.0f, 0.0f,
+                                   0.0f, 1.0f, 0.0f, 0.0f,
+                                   0.0f, 0.0f, 1.0f, 0.0f,
+                                   0.0f, 0.0f, 0.0f, 1.0f };
+    };
+
+    /**
+     * \brief Tag of the entities whose world transform, and the world transforms of their descendants, are out of date.
+     */
+    struct DirtyTransformTag {};
+
     struct BoxComponent
     {
         DirectX::XMFLOAT2 ScreenPosition{0.0f,0.0f};
@@ -38,13 +59,19 @@ namespace RSim::ECS
         float Rotation{ 0.0f };
     };
 
+    /**
+     * \brief Interned name of an entity. Name points into the scene's NamePool and ID identifies it there, two entities of the same scene
+     * have the same name exactly when their IDs are equal. Set through Entity::SetName() or Scene::SetName(), which keep the name index
+     * up to date.
+     */
     struct NameComponent
     {
-        NameComponent() = default;
-        NameComponent(std::string name) : Name(std::move(name)) {}
+        static constexpr std::string_view DefaultName = "Unnamed Entity";
 
-        operator std::string_view() const { return std::string_view{Name}; }
+        operator std::string_view() const { return Name; }
 
-        std::string Name = "Unnamed Entity";
+        std::string_view Name = DefaultName;
+        NameID ID = InvalidNameID;
+        uint64_t Hash = NamePool::Hash(DefaultName);
     };
 }
@@ -8,11 +8,10 @@
 #include "realsim/core/Assert.h"
 
 #include "realsim/ecs/Scene.h"
+#include "realsim/ecs/Link.h"
 
 namespace RSim::ECS
 {
-    struct Link;
-
     /**
      * \brief 
      * ----------------------------------------------------------\n
@@ -46,28 +45,67 @@ namespace RSim::ECS
         [[nodiscard]] Entity GetFirstChild() const;
         [[nodiscard]] Entity GetLastChild() const;
         /**
+         * \brief Appends the entity as the last child in O(1). If it already has a parent, it is removed from that parent first.
     	 * \return The parent entity(*this) with the updated link.
     	 */
     	Entity AddChild(Entity Child);
         /**
-         * \brief Removes the given entity as a child.
+         * \brief Removes the given entity as a child in O(1), the remaining siblings keep their order. The siblings after it keep their
+         * indices until the children are renumbered, see RenumberChildren().
          * \param Child Child to remove.
          * \return The parent entity(*this).
          */
         Entity RemoveChild(Entity Child);
+        /**
+         * \brief Makes the children's indices dense again, and compacts the child array, after children were removed. Scene::SortHierarchy()
+         * and GetChildAt() call it, it does nothing unless a child was removed since the last time.
+         */
+        void RenumberChildren();
 
+        /**
+         * \brief O(1) with a child array, otherwise walks from the closer end of the sibling list. Renumbers the children first if some were
+         * removed.
+         */
         Entity GetChildAt(std::size_t Index);
+        /**
+         * \brief Finds a child by name through Scene::FindChild(), an integer comparison per child or a hash lookup with the name index.
+         */
         Entity GetChildByName(std::string_view Name);
+        /**
+         * \brief Finds a descendant by a '/' separated path of names relative to this entity, such as "Arm/Gripper".
+         */
+        Entity FindByPath(std::string_view Path);
 
         void RemoveChildAt(std::size_t Index);
         void TryRemoveChildAt(std::size_t Index);
 
+        /**
+         * \brief Keeps the children in a contiguous ChildArray as well as in the sibling list, for parents with many children that are
+         * accessed by index or iterated often.
+         */
+        void EnableChildArray();
+        void DisableChildArray();
+        [[nodiscard]] bool HasChildArray() const;
+
+        /**
+         * \brief Calls Function(Entity) for every child in sibling order. The function must not add or remove children of this entity.
+         */
+        template<typename Function>
+        void ForEachChild(Function&& function) const;
+
+        /**
+         * \brief Marks the world transform of the entity and its descendants dirty, use the const overload to only read it. Marking is not a
+         * structural change, so systems that declare Write<TransformComponent> may call it from several threads.
+         */
         [[nodiscard]] TransformComponent& GetLocalTransform();
         [[nodiscard]] TransformComponent const& GetLocalTransform() const;
         [[nodiscard]] NameComponent const& GetName() const;
         [[nodiscard]] Link const& GetLink() const;
 
-        void SetName(std::string Name) const;
+        /**
+         * \brief Interns the name in the scene's NamePool, see Scene::SetName().
+         */
+        void SetName(std::string_view Name) const;
 
         template<typename T>
         void RemoveComponent() const;
@@ -93,6 +131,25 @@ namespace RSim::ECS
         return m_Scene->AddComponent<T>(m_EntityHandle, std::forward<Args>(args)...);
     }
 
+    template<typename Function>
+    void Entity::ForEachChild(Function&& function) const
+    {
+        if (auto const* pChildArray = m_Scene->TryGet<ChildArray>(m_EntityHandle))
+        {
+            for (entt::entity const child : pChildArray->GetChildren())
+            {
+                if (child != entt::null)
+                    function(Entity{ m_Scene, child });
+            }
+            return;
+        }
+
+        for (entt::entity child = GetLink().GetFirstChild(); child != entt::null; child = m_Scene->GetComponent<Link>(child).GetNextSibling())
+        {
+            function(Entity{ m_Scene, child });
+        }
+    }
+
     template<typename T>
     void Entity::RemoveComponent() const
     {
@@ -0,0 +1,200 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "realsim/core/LinearArena.h"
+
+namespace RSim::ECS
+{
+    class Scene;
+
+    /**
+     * \brief Handle of an entity that an EntityCommandBuffer will create on playback. Only valid with the buffer that returned it.
+     */
+    struct DeferredEntity
+    {
+        uint32_t Index;
+    };
+
+    /**
+     * \brief Records structural changes, creating and destroying entities and emplacing and removing components, to apply them later at a
+     * sync point on one thread. Recording does not touch the registry, so it is safe while iterating views and from the systems the
+     * SystemScheduler runs in parallel. Component payloads are constructed in a LinearArena, recording a command does not allocate once
+     * the buffer has warmed up.
+     * A buffer must only be recorded into from one thread at a time. Work split with ThreadPool::ParallelFor records into ForTask(TaskIndex),
+     * the task buffers are played back after this buffer's own commands in task order, so the result does not depend on which thread
+     * ran which task.
+     */
+    class EntityCommandBuffer
+    {
+    public:
+        EntityCommandBuffer() = default;
+        EntityCommandBuffer(EntityCommandBuffer const&) = delete;
+        EntityCommandBuffer& operator=(EntityCommandBuffer const&) = delete;
+        EntityCommandBuffer(EntityCommandBuffer&&) noexcept = default;
+        EntityCommandBuffer& operator=(EntityCommandBuffer&&) noexcept = default;
+        ~EntityCommandBuffer();
+
+        /**
+         * \brief Records the creation of an entity through Scene::CreateEntity().
+         */
+        DeferredEntity Create();
+
+        /**
+         * \brief Records the destruction of the entity and its descendants through Scene::Destroy(). Entities that are already gone at
+         * playback are skipped.
+         */
+        void Destroy(entt::entity Entity);
+        void Destroy(DeferredEntity Entity);
+
+        /**
+         * \brief Records emplacing, or replacing, a component constructed from the arguments now.
+         */
+        template<typename T, typename... Args>
+        void Emplace(entt::entity Entity, Args&&... args);
+        template<typename T, typename... Args>
+        void Emplace(DeferredEntity Entity, Args&&... args);
+
+        template<typename T>
+        void Remove(entt::entity Entity);
+        template<typename T>
+        void Remove(DeferredEntity Entity);
+
+        /**
+         * \brief Makes ForTask() valid for task indices in [0, NumTasks). Call it before the tasks start recording.
+         */
+        void ReserveTasks(std::size_t NumTasks);
+        [[nodiscard]] EntityCommandBuffer& ForTask(std::size_t TaskIndex) { return *m_TaskBuffers[TaskIndex]; }
+
+        /**
+         * \brief Applies the commands in the order they were recorded, then the task buffers' in task order, and clears them.
+         */
+        void Playback(Scene& Scene);
+
+        /**
+         * \brief Drops the recorded commands without applying them.
+         */
+        void Clear();
+
+        [[nodiscard]] bool IsEmpty() const;
+    private:
+        enum class CommandType : uint8_t
+        {
+            Create,
+            Destroy,
+            Emplace,
+            Remove
+        };
+
+        using ApplyFunction = void(*)(entt::registry& Registry, entt::entity Entity, void* pPayload);
+        using DestroyFunction = void(*)(void* pPayload);
+
+        /**
+         * \brief Either an existing entity or, if Deferred is not InvalidDeferred, the Deferred-th entity this buffer creates.
+         */
+        struct CommandTarget
+        {
+            entt::entity Entity;
+            uint32_t Deferred;
+        };
+
+        struct Command
+        {
+            CommandType Type;
+            CommandTarget Target;
+            ApplyFunction Apply;
+            /**
+             * \brief Destroys the payload when the command is dropped or its entity is gone, nullptr for trivially destructible payloads.
+             */
+            DestroyFunction DestroyPayload;
+            void* pPayload;
+        };
+
+        static constexpr uint32_t InvalidDeferred = UINT32_MAX;
+
+        static CommandTarget MakeTarget(entt::entity Entity) { return CommandTarget{ Entity, InvalidDeferred }; }
+        static CommandTarget MakeTarget(DeferredEntity Entity) { return CommandTarget{ entt::null, Entity.Index }; }
+
+        template<typename T, typename... Args>
+        void RecordEmplace(CommandTarget Target, Args&&... args);
+        template<typename T>
+        void RecordRemove(CommandTarget Target);
+
+        [[nodiscard]] entt::entity Resolve(CommandTarget const& Target) const;
+    private:
+        std::vector<Command> m_Commands;
+        Core::LinearArena m_Arena{ 16 * 1024 };
+        uint32_t m_NumCreated{ 0 };
+        std::vector<entt::entity> m_Created;
+        std::vector<std::unique_ptr<EntityCommandBuffer>> m_TaskBuffers;
+    };
+
+    template<typename T, typename... Args>
+    void EntityCommandBuffer::Emplace(entt::entity Entity, Args&&... args)
+    {
+        RecordEmplace<T>(MakeTarget(Entity), std::forward<Args>(args)...);
+    }
+
+    template<typename T, typename... Args>
+    void EntityCommandBuffer::Emplace(DeferredEntity Entity, Args&&... args)
+    {
+        RecordEmplace<T>(MakeTarget(Entity), std::forward<Args>(args)...);
+    }
+
+    template<typename T>
+    void EntityCommandBuffer::Remove(entt::entity Entity)
+    {
+        RecordRemove<T>(MakeTarget(Entity));
+    }
+
+    template<typename T>
+    void EntityCommandBuffer::Remove(DeferredEntity Entity)
+    {
+        RecordRemove<T>(MakeTarget(Entity));
+    }
+
+    template<typename T, typename... Args>
+    void EntityCommandBuffer::RecordEmplace(CommandTarget Target, Args&&... args)
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned components cannot be stored in the command arena.");
+
+        Command command{ CommandType::Emplace, Target, nullptr, nullptr, nullptr };
+        if constexpr (std::is_empty_v<T>)
+        {
+            command.Apply = [](entt::registry& Registry, entt::entity Entity, void*) { Registry.emplace_or_replace<T>(Entity); };
+        }
+        else
+        {
+            void* const pMemory = m_Arena.Allocate(sizeof(T), alignof(T));
+            if constexpr (std::is_constructible_v<T, Args&&...>)
+                command.pPayload = new (pMemory) T(std::forward<Args>(args)...);
+            else
+                command.pPayload = new (pMemory) T{ std::forward<Args>(args)... };
+            command.Apply = [](entt::registry& Registry, entt::entity Entity, void* pPayload)
+            {
+                T& payload = *static_cast<T*>(pPayload);
+                Registry.emplace_or_replace<T>(Entity, std::move(payload));
+            };
+            if constexpr (!std::is_trivially_destructible_v<T>)
+            {
+                command.DestroyPayload = [](void* pPayload) { static_cast<T*>(pPayload)->~T(); };
+            }
+        }
+        m_Commands.push_back(command);
+    }
+
+    template<typename T>
+    void EntityCommandBuffer::RecordRemove(CommandTarget Target)
+    {
+        Command command{ CommandType::Remove, Target, nullptr, nullptr, nullptr };
+        command.Apply = [](entt::registry& Registry, entt::entity Entity, void*) { Registry.remove<T>(Entity); };
+        m_Commands.push_back(command);
+    }
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <vector>
 #include <entt/entt.hpp>
 
 namespace RSim::ECS
@@ -10,6 +11,13 @@ namespace RSim::ECS
 		Link() = default;
 		Link(entt::entity First, entt::entity Prev, entt::entity Next, entt::entity Parent) :
 		FirstChild(First),PreviousSibling(Prev),NextSibling(Next),Parent(Parent) {}
+		/**
+		 * \brief Every field at once, for code that rebuilds whole hierarchies in bulk such as the SceneSerializer. The caller is responsible
+		 * for the links being consistent with each other.
+		 */
+		Link(entt::entity First, entt::entity Last, entt::entity Prev, entt::entity Next, entt::entity Parent, std::size_t NumChildren,
+			std::size_t ChildIndex) :
+		FirstChild(First),PreviousSibling(Prev),NextSibling(Next),LastChild(Last),Parent(Parent),NumChildren(NumChildren),ChildIndex(ChildIndex) {}
 
 		[[nodiscard]] entt::entity GetFirstChild() const { return FirstChild; }
 		[[nodiscard]] entt::entity GetPreviousSibling() const { return PreviousSibling; }
@@ -17,6 +25,15 @@ namespace RSim::ECS
 		[[nodiscard]] entt::entity GetLastChild() const { return LastChild; }
 		[[nodiscard]] entt::entity GetParent() const { return Parent; }
 		[[nodiscard]] std::size_t GetNumChildren() const { return NumChildren; }
+		/**
+		 * \brief Position of the entity among its siblings. Indices increase along the sibling list, but after a RemoveChild() the later
+		 * siblings keep theirs until the parent is renumbered by Scene::SortHierarchy(), Entity::GetChildAt() or Entity::RenumberChildren().
+		 */
+		[[nodiscard]] std::size_t GetChildIndex() const { return ChildIndex; }
+		/**
+		 * \brief Whether children were removed since the children's indices were last made dense again.
+		 */
+		[[nodiscard]] bool HasStaleChildIndices() const { return ChildIndicesStale; }
 
 		static constexpr std::size_t InvalidChildIndex() { return std::numeric_limits<std::size_t>::max(); }
 	private:
@@ -30,5 +47,20 @@ namespace RSim::ECS
 		entt::entity Parent{entt::null};
 		std::size_t NumChildren = 0;
 		std::size_t ChildIndex = InvalidChildIndex();	
+		bool ChildIndicesStale = false;
+	};
+
+	/**
+	 * \brief Optional component that mirrors an entity's children, in sibling order, in a contiguous array for O(1) indexed access and
+	 * linear iteration without chasing sibling links. Added with Entity::EnableChildArray() and maintained by Entity alongside the Link.
+	 * Each child sits at its ChildIndex, so a removed child leaves a null entry behind until the parent is renumbered.
+	 */
+	struct ChildArray
+	{
+		friend class Entity;
+
+		[[nodiscard]] std::vector<entt::entity> const& GetChildren() const { return Children; }
+	private:
+		std::vector<entt::entity> Children;
 	};
 }
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace RSim::ECS
+{
+    using NameID = uint32_t;
+    constexpr NameID InvalidNameID = UINT32_MAX;
+
+    /**
+     * \brief Stores every distinct name once and hands out a small ID for it, so that names can be compared and hashed as integers.
+     * The characters live in fixed-size blocks that are never moved or freed while the pool is alive, the views returned by
+     * GetString() stay valid for the lifetime of the pool.
+     */
+    class NamePool
+    {
+    public:
+        /**
+         * \brief 64-bit FNV-1a hash of the name.
+         */
+        [[nodiscard]] static constexpr uint64_t Hash(std::string_view Name)
+        {
+            uint64_t hash = 14695981039346656037ull;
+            for (char const c : Name)
+            {
+                hash ^= (uint64_t)(unsigned char)c;
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        /**
+         * \return The ID of the name, adding it to the pool if it is not there yet.
+         */
+        NameID Intern(std::string_view Name);
+
+        /**
+         * \return The ID of the name, InvalidNameID if it was never interned. A name that is not in the pool cannot belong to any entity.
+         */
+        [[nodiscard]] NameID Find(std::string_view Name) const;
+
+        [[nodiscard]] std::string_view GetString(NameID ID) const { return m_Entries[ID].String; }
+        [[nodiscard]] uint64_t GetHash(NameID ID) const { return m_Entries[ID].Hash; }
+        [[nodiscard]] std::size_t Size() const { return m_Entries.size(); }
+
+        /**
+         * \brief Size of a character block, longer names get a block of their own.
+         */
+        static constexpr std::size_t BlockSize = 16 * 1024;
+    private:
+        struct Entry
+        {
+            std::string_view String;
+            uint64_t Hash;
+        };
+
+        struct Hasher
+        {
+            std::size_t operator()(std::string_view Name) const { return (std::size_t)NamePool::Hash(Name); }
+        };
+
+        std::vector<Entry> m_Entries;
+        std::unordered_map<std::string_view, NameID, Hasher> m_Lookup;
+        std::vector<std::unique_ptr<char[]>> m_Blocks;
+        std::size_t m_BlockOffset{ BlockSize };
+    };
+}
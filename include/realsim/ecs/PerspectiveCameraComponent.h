@@ -42,9 +42,20 @@ namespace RSim::ECS
 		}
 
 		bool IsPrimaryCamera = false;
+		/**
+		 * \brief Cameras other than the primary one are only rendered while they are active.
+		 */
+		bool IsActive = false;
 		float FOVHalfAngle = 30.0f;
 		float NearZ = 0.1f;
 		float FarZ = 1000.0f;
+		/**
+		 * \brief Rectangle of the output the camera renders into, as fractions of the output's size.
+		 */
+		float ViewportX = 0.0f;
+		float ViewportY = 0.0f;
+		float ViewportWidth = 1.0f;
+		float ViewportHeight = 1.0f;
 	private:
 		DirectX::XMMATRIX m_ViewMatrix = DirectX::XMMatrixIdentity();
 		DirectX::XMMATRIX m_InvViewMatrix = DirectX::XMMatrixIdentity();
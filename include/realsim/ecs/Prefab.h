@@ -0,0 +1,145 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <entt/entt.hpp>
+#include "realsim/core/Assert.h"
+#include "realsim/ecs/CommonComponents.h"
+
+namespace RSim::ECS
+{
+    class Scene;
+
+    /**
+     * \brief Template of an entity subtree that is described once and instantiated many times. Instantiate() creates every entity of all
+     * copies with one bulk create, inserts each component of each template entity into its pool for all copies with one range insert, and
+     * computes the links of all copies in one pass, instead of going through Scene::CreateEntity() and AddChild() entity by entity.
+     * Template entities are called nodes and are identified by the index AddEntity() returns. Node 0 is the root.
+     */
+    class Prefab
+    {
+    public:
+        static constexpr uint32_t InvalidNode = UINT32_MAX;
+
+        Prefab() = default;
+        Prefab(Prefab const& Other);
+        Prefab(Prefab&&) noexcept = default;
+        Prefab& operator=(Prefab const& Other);
+        Prefab& operator=(Prefab&&) noexcept = default;
+        ~Prefab() = default;
+
+        /**
+         * \brief Describes the subtree rooted at Root: its transforms, names, child arrays, BoxComponents and PerspectiveCameraComponents.
+         */
+        [[nodiscard]] static Prefab FromSubtree(Scene& Scene, entt::entity Root);
+
+        /**
+         * \brief Adds a node as the last child of Parent. The first node is the root and must not have a parent, every other node must.
+         * \return Index of the node.
+         */
+        uint32_t AddEntity(std::string_view Name, TransformComponent const& Transform = {}, uint32_t Parent = InvalidNode);
+
+        /**
+         * \brief Gives every copy of the node a copy of Value. Adding a type twice to the same node keeps the last value.
+         */
+        template<typename T>
+        void AddComponent(uint32_t Node, T const& Value);
+
+        /**
+         * \brief Gives every copy of the node a ChildArray, see Entity::EnableChildArray().
+         */
+        void EnableChildArray(uint32_t Node);
+
+        /**
+         * \brief Creates Count copies of the template in the scene.
+         * \param OutEntities Receives the created entities, node-major: the copy i of node n is at n * Count + i, so the first Count are the
+         * roots.
+         * \param Parent Entity the roots are appended to as children, null leaves them as separate roots without a parent or siblings.
+         */
+        void Instantiate(Scene& Scene, std::size_t Count, std::vector<entt::entity>& OutEntities, entt::entity Parent = entt::null) const;
+
+        [[nodiscard]] std::size_t GetNumEntities() const { return m_Nodes.size(); }
+    private:
+        /**
+         * \brief Node with its link in the template, every entity field is a node index.
+         */
+        struct TemplateNode
+        {
+            std::string Name;
+            TransformComponent Transform;
+            uint32_t Parent{ InvalidNode };
+            uint32_t FirstChild{ InvalidNode };
+            uint32_t LastChild{ InvalidNode };
+            uint32_t PreviousSibling{ InvalidNode };
+            uint32_t NextSibling{ InvalidNode };
+            uint32_t NumChildren{ 0 };
+            uint32_t ChildIndex{ InvalidNode };
+            bool HasChildArray{ false };
+        };
+
+        struct ComponentPoolBase
+        {
+            virtual ~ComponentPoolBase() = default;
+            [[nodiscard]] virtual entt::id_type GetTypeID() const = 0;
+            [[nodiscard]] virtual std::unique_ptr<ComponentPoolBase> Clone() const = 0;
+            /**
+             * \brief Inserts the component of each node that has one into the node's Count copies.
+             */
+            virtual void Instantiate(entt::registry& Registry, entt::entity const* pEntities, std::size_t Count) const = 0;
+        };
+
+        template<typename T>
+        struct ComponentPool final : ComponentPoolBase
+        {
+            [[nodiscard]] entt::id_type GetTypeID() const override { return entt::type_hash<T>::value(); }
+            [[nodiscard]] std::unique_ptr<ComponentPoolBase> Clone() const override { return std::make_unique<ComponentPool>(*this); }
+
+            void Instantiate(entt::registry& Registry, entt::entity const* pEntities, std::size_t Count) const override
+            {
+                for (auto const& [node, value] : Values)
+                {
+                    // The copies of a node are contiguous, one range insert covers all of them
+                    entt::entity const* pCopies = pEntities + (std::size_t)node * Count;
+                    Registry.insert<T>(pCopies, pCopies + Count, value);
+                }
+            }
+
+            std::vector<std::pair<uint32_t, T>> Values;
+        };
+    private:
+        std::vector<TemplateNode> m_Nodes;
+        std::vector<std::unique_ptr<ComponentPoolBase>> m_Pools;
+    };
+
+    template<typename T>
+    void Prefab::AddComponent(uint32_t Node, T const& Value)
+    {
+        RSIM_ASSERTM(Node < m_Nodes.size(), "The prefab has no such node.");
+
+        ComponentPool<T>* pPool = nullptr;
+        for (auto const& pool : m_Pools)
+        {
+            if (pool->GetTypeID() == entt::type_hash<T>::value())
+                pPool = static_cast<ComponentPool<T>*>(pool.get());
+        }
+        if (!pPool)
+        {
+            pPool = static_cast<ComponentPool<T>*>(m_Pools.emplace_back(std::make_unique<ComponentPool<T>>()).get());
+        }
+
+        for (auto& [node, value] : pPool->Values)
+        {
+            if (node == Node)
+            {
+                value = Value;
+                return;
+            }
+        }
+        pPool->Values.emplace_back(Node, Value);
+    }
+}
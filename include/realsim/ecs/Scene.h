@@ -1,7 +1,15 @@
 #pragma once
 
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
 #include <entt/entt.hpp>
 #include "realsim/ecs/CommonComponents.h"
+#include "realsim/ecs/NamePool.h"
+#include "realsim/ecs/SystemScheduler.h"
+#include "realsim/ecs/TransformSystem.h"
 
 namespace RSim::ECS
 {
@@ -9,6 +17,9 @@ namespace RSim::ECS
 
     class Scene
     {
+        friend class Entity;
+        friend class SceneHistory;
+        friend class Prefab;
     public:
         Scene();
 
@@ -24,10 +35,99 @@ namespace RSim::ECS
 
         auto FromEnTT(entt::entity entity) -> Entity;
 
+        /**
+         * \brief Destroys the entity together with all of its descendants, see DestroySubtree().
+         */
         void Destroy(Entity entity);
 
+        /**
+         * \brief Detaches the entity from its parent, collects its subtree with an iterative breadth-first walk and destroys the whole
+         * subtree with a single bulk registry call.
+         * \return The number of entities destroyed.
+         */
+        std::size_t DestroySubtree(Entity root);
+
+        /**
+         * \brief Sorts the hierarchy pools if the hierarchy changed since the last update, see SortHierarchy(), then runs the scene's
+         * systems through the scheduler. Once they are done, the TransformSystem brings the world transforms of the entities marked dirty
+         * up to date, including the ones the systems moved in this update.
+         */
         void Update(float dt);
 
+        [[nodiscard]] SystemScheduler& GetScheduler() { return m_Scheduler; }
+
+        /**
+         * \brief Thread pool the scheduler and the built-in systems run on, nullptr runs everything on the thread that calls Update().
+         */
+        void SetThreadPool(Core::ThreadPool* pPool);
+
+        /**
+         * \brief Flags the entity's world transform, and its descendants', to be recomputed in the next Update(). Not a structural change,
+         * safe to call from systems running in parallel, see TransformSystem::MarkDirty().
+         */
+        void MarkTransformDirty(entt::entity entity);
+
+        [[nodiscard]] TransformSystem& GetTransformSystem() { return m_TransformSystem; }
+
+        /**
+         * \brief Sorts the Link, TransformComponent and WorldTransformComponent pools into depth-first order: every root is followed by
+         * its whole subtree, and a parent always comes before its children. Iterating those pools is then a parent-before-child walk over
+         * contiguous memory. Parents whose children were removed get their children renumbered on the way, see Entity::RenumberChildren().
+         * Does nothing if the hierarchy has not changed since the last sort. Update() calls it before running the systems, call it directly
+         * to sort before other code walks the pools, SceneSerializer::Save() does.
+         * \return Whether the pools were sorted.
+         */
+        bool SortHierarchy();
+
+        /**
+         * \brief Called when entities are created, destroyed or re-linked, the next SortHierarchy() then sorts the pools again.
+         */
+        void InvalidateHierarchyOrder() { m_HierarchySorted = false; }
+        [[nodiscard]] bool IsHierarchySorted() const { return m_HierarchySorted; }
+
+        /**
+         * \brief Interns the name and assigns it to the entity.
+         */
+        void SetName(entt::entity entity, std::string_view name);
+
+        /**
+         * \brief Interns the name and returns a component for it without assigning it to an entity, for code that inserts names in bulk.
+         * The name index does not see names inserted this way, rebuild it by disabling and enabling it.
+         */
+        [[nodiscard]] NameComponent InternName(std::string_view name);
+
+        [[nodiscard]] NamePool const& GetNamePool() const { return m_NamePool; }
+
+        /**
+         * \brief Builds a (parent, name) to entity hash index that FindChild() and FindByPath() use instead of walking the children. The
+         * index is kept up to date by SetName(), AddChild() and RemoveChild() until it is disabled.
+         */
+        void EnableNameIndex();
+        void DisableNameIndex();
+        [[nodiscard]] bool IsNameIndexEnabled() const { return m_NameIndexEnabled; }
+
+        /**
+         * \brief Finds a child of the parent by name, or a root entity if the parent is null. With several matching siblings, any one of
+         * them may be returned.
+         * \return The entity, or a null entity if there is none.
+         */
+        [[nodiscard]] Entity FindChild(entt::entity parent, std::string_view name);
+
+        /**
+         * \brief Finds an entity by a '/' separated path of names such as "Robot/Arm/Gripper", starting at the children of the parent, or
+         * at the root entities if the parent is null. Empty path segments are ignored.
+         * \return The entity, or a null entity if any segment does not match.
+         */
+        [[nodiscard]] Entity FindByPath(std::string_view path, entt::entity parent = entt::null);
+
+        /**
+         * \brief Announces that the entity's component is about to be changed through a reference. The registry's on_update<T> listeners,
+         * such as SceneHistory, then see the value from before the change. Changes made with replace() or emplace_or_replace() without
+         * announcing them first are seen afterwards.
+         */
+        template<typename T>
+        void WillModify(entt::entity entity) { m_Registry.patch<T>(entity); }
+
         template<typename T>
         auto GetComponent(entt::entity entity) -> T &;
 
@@ -45,11 +145,55 @@ namespace RSim::ECS
 
     	void Shutdown();
     private:
+        /**
+         * \brief Keeps the hierarchy consistent when an entity is destroyed directly through the registry: the entity is unlinked from its
+         * parent and its descendants are destroyed with it.
+         */
         void OnDestroyLink(entt::registry& registry, entt::entity entity);
 
+        /**
+         * \brief Appends the descendants of the entity, not the entity itself, to m_DestroyList in breadth-first order.
+         */
+        void CollectDescendants(entt::entity entity);
+
+        /**
+         * \brief Adds the entity to, or removes it from, the name index under its current parent. Do nothing if the index is disabled
+         * or the entity has no name or link.
+         */
+        void IndexName(entt::entity entity);
+        void UnindexName(entt::entity entity);
+        void OnDestroyName(entt::registry& registry, entt::entity entity);
+
+        [[nodiscard]] entt::entity FindChildID(entt::entity parent, NameID name);
+
+        [[nodiscard]] static uint64_t NameIndexKey(entt::entity parent, NameID name)
+        {
+            return (uint64_t)entt::to_integral(parent) << 32 | name;
+        }
+
 
     private:
         entt::registry m_Registry{};
+        TransformSystem m_TransformSystem{};
+        SystemScheduler m_Scheduler{};
+
+        bool m_HierarchySorted{ false };
+        /**
+         * \brief Scratch space of SortHierarchy(), kept to avoid reallocating on every sort.
+         */
+        std::vector<entt::entity> m_DepthFirstStack{};
+        std::vector<uint32_t> m_DepthFirstRanks{};
+
+        std::vector<entt::entity> m_DestroyList{};
+        /**
+         * \brief Set while a collected subtree is being destroyed, or while SceneHistory restores raw links, OnDestroyLink and
+         * OnDestroyName then have nothing to fix up.
+         */
+        bool m_SuspendHierarchyHooks{ false };
+
+        NamePool m_NamePool{};
+        bool m_NameIndexEnabled{ false };
+        std::unordered_multimap<uint64_t, entt::entity> m_NameIndex{};
     };
 
     template<typename T>
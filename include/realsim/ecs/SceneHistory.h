@@ -0,0 +1,224 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "realsim/core/LinearArena.h"
+
+namespace RSim::ECS
+{
+    class Scene;
+
+    /**
+     * \brief Records what changes in a scene tick by tick, so that any of the last Capacity ticks can be restored. Instead of copying the
+     * registry, it listens to the construct, update and destroy signals of the tracked component types and keeps the value a component
+     * had before its first change in the tick, in a per-tick arena. Memory is proportional to what changed, not to the size of the scene.
+     * Restoring undoes the recorded changes newest first, recreating destroyed entities with their old handles.
+     * Changes made through references are only seen if they are announced with Scene::WillModify(), which Entity does for transforms
+     * and links. Systems running in parallel may announce changes at the same time, recording is serialized by a mutex.
+     * World transforms are not recorded, the restored entities get one back if they lost it and are marked dirty instead.
+     */
+    class SceneHistory
+    {
+    public:
+        /**
+         * \param Capacity Number of past ticks that can be restored.
+         */
+        SceneHistory(Scene& Scene, std::size_t Capacity);
+        SceneHistory(SceneHistory const&) = delete;
+        SceneHistory& operator=(SceneHistory const&) = delete;
+        ~SceneHistory();
+
+        /**
+         * \brief Starts recording the component type. TransformComponent, Link, NameComponent, BoxComponent, PerspectiveCameraComponent and
+         * ChildArray are tracked from the start.
+         */
+        template<typename T>
+        void Track();
+
+        /**
+         * \brief Ends the current tick, the changes made from now on belong to the next one. The oldest tick is dropped once Capacity
+         * ticks have been recorded.
+         */
+        void CommitTick();
+
+        /**
+         * \brief Puts the scene back in the state it was in when Tick began and continues recording from there, the ticks after it are
+         * dropped.
+         * \return Whether the tick was still recorded.
+         */
+        bool Restore(uint64_t Tick);
+
+        [[nodiscard]] uint64_t GetCurrentTick() const { return m_CurrentTick; }
+        [[nodiscard]] uint64_t GetOldestRestorableTick() const { return m_CurrentTick - m_NumCommitted; }
+
+        /**
+         * \brief Number of component values recorded for the tick in progress.
+         */
+        [[nodiscard]] std::size_t GetNumCurrentChanges() const { return CurrentDelta().Records.size(); }
+    private:
+        struct TrackedType
+        {
+            entt::id_type ID;
+            /**
+             * \brief Puts the recorded value back, or removes the component if pBefore is nullptr.
+             */
+            void(*Restore)(entt::registry& Registry, entt::entity Entity, void const* pBefore);
+            void(*DestroyValue)(void* pValue);
+            void(*Disconnect)(entt::registry& Registry, SceneHistory& History);
+        };
+
+        struct Record
+        {
+            entt::entity Entity;
+            uint32_t Type;
+            /**
+             * \brief The component before the change, nullptr if the entity did not have it.
+             */
+            void* pBefore;
+        };
+
+        /**
+         * \brief Record::Type of an entity created in the tick, which is destroyed again when the tick is undone.
+         */
+        static constexpr uint32_t CreatedRecord = UINT32_MAX;
+
+        struct TickDelta
+        {
+            std::vector<Record> Records;
+            Core::LinearArena Arena{ 16 * 1024 };
+        };
+
+        [[nodiscard]] entt::registry& GetRegistry();
+
+        template<typename T>
+        [[nodiscard]] uint32_t FindType() const;
+
+        template<typename T>
+        void OnChange(entt::registry& Registry, entt::entity Entity);
+        template<typename T>
+        void OnConstruct(entt::registry& Registry, entt::entity Entity);
+        void OnConstructLink(entt::registry& Registry, entt::entity Entity);
+
+        /**
+         * \brief Whether this is the first change of the entity's component in the current tick, only that one has to be recorded.
+         */
+        bool IsFirstChange(entt::entity Entity, uint32_t Type);
+
+        /**
+         * \brief Copies the component into the current tick's arena, aligning it by hand if it needs more than the arena guarantees.
+         */
+        template<typename T>
+        [[nodiscard]] void* CopyValue(T const& Value);
+
+        void Undo(TickDelta& Delta);
+        void Clear(TickDelta& Delta);
+
+        [[nodiscard]] TickDelta& CurrentDelta() { return m_Deltas[m_CurrentTick % m_Deltas.size()]; }
+        [[nodiscard]] TickDelta const& CurrentDelta() const { return m_Deltas[m_CurrentTick % m_Deltas.size()]; }
+    private:
+        Scene& m_Scene;
+        std::vector<TrackedType> m_Types;
+        /**
+         * \brief Capacity committed ticks plus the one in progress, indexed by tick modulo its size.
+         */
+        std::vector<TickDelta> m_Deltas;
+        uint64_t m_CurrentTick{ 0 };
+        std::size_t m_NumCommitted{ 0 };
+        std::unordered_set<uint64_t> m_ChangedThisTick;
+        /**
+         * \brief Guards m_ChangedThisTick and the current tick's records and arena while changes are recorded.
+         */
+        std::mutex m_RecordMutex;
+        bool m_Restoring{ false };
+    };
+
+    template<typename T>
+    uint32_t SceneHistory::FindType() const
+    {
+        // A handful of tracked types, a linear search is the cheapest lookup
+        entt::id_type const id = entt::type_hash<T>::value();
+        for (uint32_t i = 0; i < (uint32_t)m_Types.size(); ++i)
+        {
+            if (m_Types[i].ID == id)
+                return i;
+        }
+        return UINT32_MAX;
+    }
+
+    template<typename T>
+    void* SceneHistory::CopyValue(T const& Value)
+    {
+        Core::LinearArena& arena = CurrentDelta().Arena;
+        if constexpr (alignof(T) <= alignof(std::max_align_t))
+        {
+            return new (arena.Allocate(sizeof(T), alignof(T))) T(Value);
+        }
+        else
+        {
+            auto const address = reinterpret_cast<std::uintptr_t>(arena.Allocate(sizeof(T) + alignof(T) - 1, 1));
+            return new (reinterpret_cast<void*>((address + alignof(T) - 1) & ~(std::uintptr_t)(alignof(T) - 1))) T(Value);
+        }
+    }
+
+    template<typename T>
+    void SceneHistory::OnChange(entt::registry& Registry, entt::entity Entity)
+    {
+        uint32_t const type = FindType<T>();
+        std::lock_guard lock(m_RecordMutex);
+        if (m_Restoring || !IsFirstChange(Entity, type))
+            return;
+
+        void* const pBefore = CopyValue(Registry.get<T>(Entity));
+        CurrentDelta().Records.push_back(Record{ Entity, type, pBefore });
+    }
+
+    template<typename T>
+    void SceneHistory::OnConstruct(entt::registry&, entt::entity Entity)
+    {
+        uint32_t const type = FindType<T>();
+        std::lock_guard lock(m_RecordMutex);
+        if (m_Restoring || !IsFirstChange(Entity, type))
+            return;
+
+        CurrentDelta().Records.push_back(Record{ Entity, type, nullptr });
+    }
+
+    template<typename T>
+    void SceneHistory::Track()
+    {
+        static_assert(std::is_copy_constructible_v<T>, "Tracked components are recorded by copy.");
+        if (FindType<T>() != UINT32_MAX)
+            return;
+
+        TrackedType type{};
+        type.ID = entt::type_hash<T>::value();
+        type.Restore = [](entt::registry& Registry, entt::entity Entity, void const* pBefore)
+        {
+            if (pBefore)
+                Registry.emplace_or_replace<T>(Entity, *static_cast<T const*>(pBefore));
+            else if (Registry.valid(Entity))
+                Registry.remove<T>(Entity);
+        };
+        type.DestroyValue = [](void* pValue) { static_cast<T*>(pValue)->~T(); };
+        type.Disconnect = [](entt::registry& Registry, SceneHistory& History)
+        {
+            Registry.on_construct<T>().disconnect(&History);
+            Registry.on_update<T>().disconnect(&History);
+            Registry.on_destroy<T>().disconnect(&History);
+        };
+        m_Types.push_back(type);
+
+        entt::registry& registry = GetRegistry();
+        registry.on_construct<T>().template connect<&SceneHistory::OnConstruct<T>>(*this);
+        registry.on_update<T>().template connect<&SceneHistory::OnChange<T>>(*this);
+        // Destroy listeners run before the component is removed, the value is still there to record
+        registry.on_destroy<T>().template connect<&SceneHistory::OnChange<T>>(*this);
+    }
+}
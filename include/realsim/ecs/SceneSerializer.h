@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace RSim::ECS
+{
+    class Scene;
+
+    /**
+     * \brief Saves and loads scenes in a binary format laid out for loading in bulk. Every component type is written as one pool: the
+     * file indices of the entities that have it followed by the components as a contiguous array, so loading is one bulk create of all
+     * entities and one range insert per pool straight from the mapped file. Entity handles inside Link are stored as file indices and
+     * remapped on load, names are stored as indices into a string table.
+     * Saved are the entities that have a Link, which are all the entities created through the Scene, with their TransformComponent,
+     * WorldTransformComponent, Link, NameComponent, BoxComponent, PerspectiveCameraComponent and whether they have a ChildArray.
+     */
+    class SceneSerializer
+    {
+    public:
+        [[nodiscard]] static std::vector<std::byte> SaveToMemory(Scene& Scene);
+        static bool Save(Scene& Scene, std::filesystem::path const& Path);
+
+        /**
+         * \brief Adds the entities of the snapshot to the scene, next to the ones already in it.
+         * \param pData Snapshot aligned to at least 16 bytes.
+         * \return Whether the snapshot was valid, nothing is added to the scene if it was not.
+         */
+        static bool LoadFromMemory(Scene& Scene, std::byte const* pData, std::size_t Size);
+        /**
+         * \brief Maps the file into memory and loads it with LoadFromMemory().
+         */
+        static bool Load(Scene& Scene, std::filesystem::path const& Path);
+
+        static constexpr char FileType[4] = { 'S','C','N','E' };
+        static constexpr uint32_t Version = 1;
+    };
+}
@@ -0,0 +1,179 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "realsim/ecs/EntityCommandBuffer.h"
+
+namespace RSim::Core
+{
+    class ThreadPool;
+}
+
+namespace RSim::ECS
+{
+    class Scene;
+
+    /**
+     * \brief The component types a system reads and writes. Two systems conflict, and run one after the other in the order they were
+     * added, when one writes a type the other reads or writes. A system that creates or destroys entities, or adds or removes components,
+     * must be Exclusive: it then runs with no other system.
+     * Declaring Link or NameComponent also declares the state the Scene keeps next to the registry, with the same access: the name
+     * index and the hierarchy order, which Entity::AddChild(), RemoveChild() and Scene::SetName() update, and FindChild() and FindByPath()
+     * read. A system that writes links therefore conflicts with one that writes or reads names, and the other way around. Marking
+     * transforms dirty is safe from any system, see TransformSystem::MarkDirty().
+     */
+    class SystemAccess
+    {
+    public:
+        template<typename... Component>
+        SystemAccess& Read()
+        {
+            (Add<Component>(m_Reads), ...);
+            return *this;
+        }
+
+        template<typename... Component>
+        SystemAccess& Write()
+        {
+            (Add<Component>(m_Writes), ...);
+            return *this;
+        }
+
+        SystemAccess& Exclusive()
+        {
+            m_Exclusive = true;
+            return *this;
+        }
+
+        [[nodiscard]] bool ConflictsWith(SystemAccess const& Other) const;
+
+        /**
+         * \brief Creates the storage of every declared component type. Views only read the registry once the storage exists, so
+         * doing it on the scheduling thread lets the systems create views concurrently.
+         */
+        void CreateStorage(entt::registry& Registry) const;
+    private:
+        template<typename Component>
+        void Add(std::vector<entt::id_type>& Types)
+        {
+            Types.push_back(entt::type_hash<Component>::value());
+            AddImpliedAccess(Types, entt::type_hash<Component>::value());
+            m_CreateStorage.push_back([](entt::registry& Registry) { (void)Registry.view<Component>(); });
+        }
+
+        /**
+         * \brief Adds the scene state that is accessed along with the component type.
+         */
+        static void AddImpliedAccess(std::vector<entt::id_type>& Types, entt::id_type Type);
+
+        static bool Intersects(std::vector<entt::id_type> const& Lhs, std::vector<entt::id_type> const& Rhs);
+    private:
+        std::vector<entt::id_type> m_Reads;
+        std::vector<entt::id_type> m_Writes;
+        std::vector<void(*)(entt::registry&)> m_CreateStorage;
+        bool m_Exclusive{ false };
+    };
+
+    /**
+     * \brief Smoothed wall-clock time of a system, measured from the moment it starts running.
+     */
+    struct SystemTiming
+    {
+        float LastMs = 0.0f;
+        float AverageMs = 0.0f;
+    };
+
+    /**
+     * \brief Runs the scene's systems once per Run(). Every frame the enabled systems are ordered into a dependency graph from their
+     * declared access, a system depends on every earlier conflicting system. Systems whose dependencies are done are submitted to the
+     * thread pool, so systems that touch different components run in parallel while the result stays the same as running them one by
+     * one in the order they were added. The calling thread helps run systems until all of them are done.
+     * Every system records its structural changes into its own EntityCommandBuffer. Once all systems are done, the buffers are played
+     * back on the calling thread in the order the systems were added.
+     * If a system throws, the systems that have not started by then are skipped, the ones already running finish, no recorded command
+     * is played back and Run() rethrows the first exception on the calling thread.
+     */
+    class SystemScheduler
+    {
+    public:
+        using SystemID = uint32_t;
+        using SystemFunction = std::function<void(Scene& Scene, float dt, EntityCommandBuffer& Commands)>;
+
+        SystemID AddSystem(std::string Name, SystemAccess Access, SystemFunction Function);
+
+        void SetEnabled(SystemID ID, bool Enabled) { m_Systems[ID].Enabled = Enabled; }
+        [[nodiscard]] bool IsEnabled(SystemID ID) const { return m_Systems[ID].Enabled; }
+
+        [[nodiscard]] std::string const& GetName(SystemID ID) const { return m_Systems[ID].Name; }
+        [[nodiscard]] SystemTiming const& GetTiming(SystemID ID) const { return m_Systems[ID].Timing; }
+        [[nodiscard]] std::size_t GetNumSystems() const { return m_Systems.size(); }
+
+        /**
+         * \param pPool Thread pool to run the systems on, nullptr runs them one by one on the calling thread.
+         */
+        void SetThreadPool(Core::ThreadPool* pPool) { m_ThreadPool = pPool; }
+
+        void Run(Scene& Scene, float dt);
+
+        /**
+         * \brief Smoothing factor of the exponential moving average in SystemTiming::AverageMs.
+         */
+        static constexpr float TimingSmoothing = 0.1f;
+    private:
+        struct System
+        {
+            std::string Name;
+            SystemAccess Access;
+            SystemFunction Function;
+            SystemTiming Timing;
+            EntityCommandBuffer Commands;
+            bool Enabled{ true };
+        };
+
+        /**
+         * \brief A node of the frame's dependency graph, the dependents of node i are m_Dependents[FirstDependent, FirstDependent + NumDependents).
+         */
+        struct Node
+        {
+            SystemID SystemIndex;
+            uint32_t FirstDependent;
+            uint32_t NumDependents;
+            uint32_t NumDependencies;
+        };
+
+        void BuildGraph();
+        void RunSystem(Scene& Scene, float dt, System& System);
+        /**
+         * \brief Runs the system unless an earlier one has thrown, and keeps what it throws for FinishRun().
+         */
+        void TryRunSystem(Scene& Scene, float dt, System& System);
+        void RunNode(Scene& Scene, float dt, uint32_t NodeIndex);
+        /**
+         * \brief Plays the commands back, or discards them and rethrows if a system has thrown.
+         */
+        void FinishRun(Scene& Scene);
+        void PlaybackCommands(Scene& Scene);
+    private:
+        std::vector<System> m_Systems;
+        Core::ThreadPool* m_ThreadPool{ nullptr };
+
+        std::vector<Node> m_Nodes;
+        std::vector<uint32_t> m_Dependents;
+        std::unique_ptr<std::atomic<uint32_t>[]> m_RemainingDependencies;
+        std::size_t m_RemainingCapacity{ 0 };
+        std::atomic<uint32_t> m_NumRemainingNodes{ 0 };
+
+        std::atomic<bool> m_Failed{ false };
+        std::exception_ptr m_FirstException{};
+        std::mutex m_ExceptionMutex;
+    };
+}
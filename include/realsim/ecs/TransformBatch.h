@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include <DirectXMath.h>
+#include "realsim/ecs/CommonComponents.h"
+
+namespace RSim::ECS
+{
+    /**
+     * \brief Structure-of-arrays copy of a batch of TransformComponents, every translation, rotation and scale component in its own
+     * contiguous array, so that the local matrices of LaneCount transforms are built at once with AVX2. Builds without AVX2 enabled
+     * (/arch:AVX2, -mavx2), and the transforms left over after the last full group of lanes, go through a scalar path that computes the
+     * same formulas.
+     * The components themselves stay in the registry as TransformComponents, one struct per entity, because everything else reads and
+     * writes a transform as a whole: Entity, the serializer, prefabs and the scene history. The batch is a gather of the transforms one
+     * update needs, its arrays only grow and are overwritten in place, so filling it allocates nothing once it has reached its peak size.
+     */
+    class TransformBatch
+    {
+    public:
+        static constexpr std::size_t LaneCount = 8;
+
+        void Clear();
+        /**
+         * \brief Sets the number of transforms in the batch, the new ones have to be written with Set() before the matrices are built.
+         */
+        void Resize(std::size_t Count);
+        void Set(std::size_t Index, TransformComponent const& Transform);
+        void Add(TransformComponent const& Transform);
+
+        [[nodiscard]] std::size_t Size() const { return m_Size; }
+
+        /**
+         * \brief Writes the local matrix of every transform in the batch, equal to TransformComponent::GetTransform(), to pOut[0, Size()).
+         */
+        void BuildMatrices(DirectX::XMFLOAT4X4* pOut) const;
+        /**
+         * \brief BuildMatrices() without SIMD, on every CPU.
+         */
+        void BuildMatricesScalar(DirectX::XMFLOAT4X4* pOut) const;
+
+        /**
+         * \brief Whether BuildMatrices() was compiled with AVX2.
+         */
+        [[nodiscard]] static bool IsAVX2Enabled();
+    private:
+        void BuildMatricesScalar(std::size_t Begin, std::size_t End, DirectX::XMFLOAT4X4* pOut) const;
+        void BuildMatricesAVX2(std::size_t End, DirectX::XMFLOAT4X4* pOut) const;
+    private:
+        enum Component { TX, TY, TZ, QX, QY, QZ, QW, SX, SY, SZ, NumComponents };
+
+        std::vector<float> m_Components[NumComponents];
+        std::size_t m_Size{ 0 };
+    };
+}
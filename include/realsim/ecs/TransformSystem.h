@@ -0,0 +1,95 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <DirectXMath.h>
+#include <entt/entt.hpp>
+#include "realsim/ecs/TransformBatch.h"
+
+namespace RSim::Core
+{
+    class ThreadPool;
+}
+
+namespace RSim::ECS
+{
+    class Scene;
+
+    /**
+     * \brief Keeps every WorldTransformComponent equal to the entity's local transform composed with its parent's world transform.
+     * Only the subtrees under entities marked with MarkDirty(), or tagged with DirtyTransformTag directly, are recomputed. A subtree is walked breadth-first, so parents are
+     * always computed before their children and every level is visited in one contiguous sweep, with the local matrices of the level built
+     * as one TransformBatch. Once the walk reaches enough
+     * independent subtrees, they are split across the thread pool, if one is set.
+     */
+    class TransformSystem
+    {
+    public:
+        TransformSystem();
+
+        /**
+         * \brief Tags the entities marked with MarkDirty() since the last update with DirtyTransformTag, then recomputes the world
+         * transforms of the tagged subtrees. Must not run at the same time as MarkDirty().
+         */
+        void Update(Scene& Scene);
+
+        /**
+         * \brief Queues the entity's world transform, and its descendants', to be recomputed by the next Update(). Marking is not a
+         * structural change of the registry: each thread appends to a list of its own, and the lists are turned into DirtyTransformTags at
+         * the start of Update(). Safe to call from several threads at once, such as from systems running in parallel or from inside a
+         * ParallelFor().
+         */
+        void MarkDirty(entt::entity Entity);
+
+        /**
+         * \param pPool Thread pool to spread independent subtrees over, nullptr updates on the calling thread.
+         */
+        void SetThreadPool(Core::ThreadPool* pPool) { m_ThreadPool = pPool; }
+
+        [[nodiscard]] std::size_t GetNumUpdatedLastFrame() const { return m_NumUpdated; }
+
+        /**
+         * \brief Minimum number of independent subtrees a task is given.
+         */
+        static constexpr std::size_t MinSubtreesPerTask = 64;
+
+        /**
+         * \brief Buffers reused from frame to frame, one per task.
+         */
+        struct Scratch
+        {
+            std::vector<entt::entity> Queue;
+            TransformBatch Batch;
+            std::vector<DirectX::XMFLOAT4X4> LocalMatrices;
+        };
+    private:
+        /**
+         * \brief The entities one thread marked dirty since the last update.
+         */
+        struct DirtyList
+        {
+            std::thread::id Thread;
+            std::vector<entt::entity> Entities;
+        };
+
+        DirtyList& FindDirtyList();
+    private:
+        /**
+         * \brief Tells the systems apart in the per-thread cache of MarkDirty(), unlike addresses IDs are never reused.
+         */
+        uint64_t m_ID;
+        std::mutex m_DirtyListsMutex;
+        std::vector<std::unique_ptr<DirtyList>> m_DirtyLists;
+
+        Core::ThreadPool* m_ThreadPool{ nullptr };
+        std::vector<entt::entity> m_Frontier;
+        std::vector<entt::entity> m_NextFrontier;
+        Scratch m_Scratch;
+        std::vector<Scratch> m_TaskScratch;
+        std::size_t m_NumUpdated{ 0 };
+    };
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+#include "realsim/graphics/FencedObjectPool.h"
+
+namespace RSim::Graphics
+{
+	/**
+	 * \brief This class provides 'on-demand' command allocators, that are pooled.
+	 * Mostly inspired by the Microsoft MiniEngine from the Microsoft's DirectX-Graphics-Samples.
+	 * The graphics API is reached only through the Traits, so the same pool runs on D3D12(CommandAllocatorPool) and on the null
+	 * device(NullCommandAllocatorPool). The Traits provide:
+	 *   DeviceType, ListType and AllocatorType, a shared handle to an allocator,
+	 *   static AllocatorType Create(DeviceType* pDevice, ListType Type, std::size_t Index),
+	 *   static void Reset(AllocatorType const& Allocator).
+	 */
+	template<typename Traits>
+	class BasicCommandAllocatorPool
+	{
+	public:
+		using DeviceType = typename Traits::DeviceType;
+		using ListType = typename Traits::ListType;
+		using AllocatorType = typename Traits::AllocatorType;
+
+		BasicCommandAllocatorPool(DeviceType* pDevice, ListType CommandType) : m_CommandType(CommandType), m_Device(pDevice) {}
+		BasicCommandAllocatorPool(BasicCommandAllocatorPool const&) = delete;
+		BasicCommandAllocatorPool& operator=(BasicCommandAllocatorPool const&) = delete;
+		BasicCommandAllocatorPool(BasicCommandAllocatorPool&& rhs) noexcept
+			:
+			m_CommandType(rhs.m_CommandType),
+			m_Device(rhs.m_Device),
+			m_NumAllocators(rhs.m_NumAllocators),
+			m_ReadyAllocators(std::move(rhs.m_ReadyAllocators))
+		{
+			rhs.m_NumAllocators = 0;
+		}
+		BasicCommandAllocatorPool& operator=(BasicCommandAllocatorPool&& rhs) noexcept
+		{
+			m_CommandType = rhs.m_CommandType;
+			m_Device = rhs.m_Device;
+			m_NumAllocators = rhs.m_NumAllocators;
+			m_ReadyAllocators = std::move(rhs.m_ReadyAllocators);
+			rhs.m_NumAllocators = 0;
+			return *this;
+		}
+		~BasicCommandAllocatorPool() = default;
+
+		AllocatorType RequestCommandAllocator(uint64_t CompletedFenceValue)
+		{
+			std::lock_guard lockGuard(m_AllocatorMutex);
+
+			// Check if there are ready(previously discarded) allocators whose fence value is smaller than the completed fence value(frame number),
+			// which means the GPU is done with them and they are now ready to use.
+			if (auto ReadyAllocator = m_ReadyAllocators.TryAcquire(CompletedFenceValue))
+			{
+				Traits::Reset(*ReadyAllocator);
+				return std::move(*ReadyAllocator);
+			}
+
+			// If there aren't ready allocators to be used
+			return Traits::Create(m_Device, m_CommandType, m_NumAllocators++);
+		}
+
+		void DiscardAllocator(uint64_t FenceValue, AllocatorType const& CommandAllocator)
+		{
+			std::lock_guard lockGuard(m_AllocatorMutex);
+
+			m_ReadyAllocators.Discard(FenceValue, CommandAllocator);
+		}
+
+		/**
+		 * \brief Destroys the oldest allocators the GPU is done with until at most NumToKeep of them are left waiting for reuse.
+		 * \return The number of allocators that were destroyed.
+		 */
+		size_t ReleaseIdleAllocators(uint64_t CompletedFenceValue, size_t NumToKeep)
+		{
+			std::lock_guard lockGuard(m_AllocatorMutex);
+
+			// The idle allocators are the oldest completed ones, at the front of the queue. Dropping the queue's handle destroys them,
+			// the ones that are in use or waiting for the GPU are held by their contexts and the queue.
+			size_t const NumCompleted = m_ReadyAllocators.GetNumCompletedObjects(CompletedFenceValue);
+			size_t const NumReleased = NumCompleted > NumToKeep ? NumCompleted - NumToKeep : 0;
+			m_ReadyAllocators.DropOldest(NumReleased);
+			m_NumAllocators -= NumReleased;
+			return NumReleased;
+		}
+
+		/**
+		 * \brief Number of allocators the pool has created and not released.
+		 */
+		[[nodiscard]] inline size_t Size() const { return m_NumAllocators; }
+	private:
+		ListType m_CommandType;
+
+		DeviceType* m_Device{nullptr};
+		size_t m_NumAllocators{ 0 };
+		FencedObjectPool<AllocatorType> m_ReadyAllocators;
+		std::mutex m_AllocatorMutex;
+	};
+}
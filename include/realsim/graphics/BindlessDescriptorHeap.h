@@ -0,0 +1,132 @@
+#pragma once
+#include <d3d12.h>
+#include <wrl.h>
+#include <cstdint>
+#include <mutex>
+
+#include "realsim/graphics/CPUDescriptorAllocator.h"
+#include "realsim/graphics/DynamicDescriptorAllocator.h"
+#include "realsim/graphics/FreeListAllocator.h"
+
+namespace RSim::Graphics
+{
+	/**
+	 * \brief Root constants a bindless material is drawn with, the layout has to match MaterialConstants in Shaders/bindless.psh.
+	 * Switching materials sets these instead of binding descriptor tables.
+	 */
+	struct BindlessMaterialConstants
+	{
+		/**
+		 * \brief Index of the diffuse map's SRV in the resource heap.
+		 */
+		uint32_t DiffuseMapIndex;
+		/**
+		 * \brief Index of the sampler in the sampler heap.
+		 */
+		uint32_t SamplerIndex;
+		float Shininess;
+	};
+
+	/**
+	 * \brief A shader-visible descriptor heap holding the descriptors the shaders index into on the bindless path. The heap is bound once
+	 * per command list through a descriptor table whose unbounded range starts at the first descriptor of the heap, after that a
+	 * descriptor is addressed by its index, which the shaders receive in root constants.
+	 * Descriptors are allocated from a FreeListGPUAllocator: freed descriptors are reused only once the graphics queue has passed the
+	 * fence value they were freed with, so a descriptor is never overwritten while a frame in flight can still read it.
+	 * The last NumDynamicDescriptors descriptors of the heap are managed by a DynamicDescriptorAllocator instead. They hold the descriptors
+	 * used by one frame only, which are staged from CPU descriptor heaps and copied in with a single CopyDescriptors call per frame.
+	 * All member functions are thread-safe.
+	 */
+	class BindlessDescriptorHeap
+	{
+	public:
+		static constexpr uint32_t InvalidIndex = UINT32_MAX;
+		/**
+		 * \brief Descriptors the dynamic region hands to a frame at once.
+		 */
+		static constexpr uint32_t DynamicChunkSize = 256;
+
+		/**
+		 * \param Type CBV_SRV_UAV or sampler, the types that can be shader-visible.
+		 * \param NumDynamicDescriptors Size of the dynamic region at the end of the heap, part of NumDescriptors.
+		 */
+		BindlessDescriptorHeap(ID3D12Device2* pDevice, D3D12_DESCRIPTOR_HEAP_TYPE Type, uint32_t NumDescriptors, LPCWSTR Name,
+			uint32_t NumDynamicDescriptors = 0);
+		BindlessDescriptorHeap(BindlessDescriptorHeap const&) = delete;
+		BindlessDescriptorHeap& operator=(BindlessDescriptorHeap const&) = delete;
+		~BindlessDescriptorHeap();
+
+		/**
+		 * \brief Allocates NumDescriptors contiguous descriptors.
+		 * \return Index of the first one, InvalidIndex if the heap has no such range left.
+		 */
+		[[nodiscard]] uint32_t Allocate(uint32_t NumDescriptors = 1);
+		/**
+		 * \brief Returns the descriptors to the heap once the GPU has passed FenceValue.
+		 */
+		void Free(uint32_t Index, uint32_t NumDescriptors, uint64_t FenceValue);
+		/**
+		 * \brief Makes the descriptors freed with a fence value up to CompletedFenceValue, and the dynamic descriptors of the frames
+		 * that ended with one, available again.
+		 */
+		void ReleaseStaleDescriptors(uint64_t CompletedFenceValue);
+
+		/**
+		 * \brief Allocate() and create the view or sampler in the allocated descriptor.
+		 * \return Its index, InvalidIndex if the heap is full.
+		 */
+		[[nodiscard]] uint32_t CreateShaderResourceView(ID3D12Resource* pResource, D3D12_SHADER_RESOURCE_VIEW_DESC const* pDesc);
+		[[nodiscard]] uint32_t CreateUnorderedAccessView(ID3D12Resource* pResource, D3D12_UNORDERED_ACCESS_VIEW_DESC const* pDesc);
+		[[nodiscard]] uint32_t CreateConstantBufferView(D3D12_CONSTANT_BUFFER_VIEW_DESC const& Desc);
+		[[nodiscard]] uint32_t CreateSampler(D3D12_SAMPLER_DESC const& Desc);
+
+		/**
+		 * \brief Allocates contiguous descriptors of the current frame for every descriptor of the NumSources allocations, in order, and
+		 * queues the copies of the source descriptors, which live in the non-shader-visible heaps of a CPUDescriptorAllocator, into them.
+		 * The copies are made by FlushDynamicCopies().
+		 * \return Index of the first one, InvalidIndex if the dynamic region is full.
+		 */
+		[[nodiscard]] uint32_t StageDynamicDescriptors(DescriptorAllocation const* pSources, uint32_t NumSources);
+		/**
+		 * \brief Copies every descriptor staged since the last flush with one CopyDescriptors call. Has to be called before the command
+		 * lists that use them are executed.
+		 */
+		void FlushDynamicCopies();
+		/**
+		 * \brief Ends the frame of the dynamic region, its descriptors are reused once the GPU has passed FenceValue.
+		 */
+		void EndFrame(uint64_t FenceValue);
+
+		[[nodiscard]] D3D12_CPU_DESCRIPTOR_HANDLE GetCPUHandle(uint32_t Index) const;
+		[[nodiscard]] D3D12_GPU_DESCRIPTOR_HANDLE GetGPUHandle(uint32_t Index) const;
+		/**
+		 * \brief What the bindless descriptor table is set to.
+		 */
+		[[nodiscard]] D3D12_GPU_DESCRIPTOR_HANDLE GetTableStart() const { return m_GPUStart; }
+
+		[[nodiscard]] ID3D12DescriptorHeap* GetHeap() const { return m_Heap.Get(); }
+		[[nodiscard]] D3D12_DESCRIPTOR_HEAP_TYPE GetType() const { return m_Type; }
+		[[nodiscard]] uint32_t GetNumDescriptors() const { return m_NumDescriptors; }
+		/**
+		 * \brief Free descriptors outside of the dynamic region.
+		 */
+		[[nodiscard]] uint32_t GetNumFreeDescriptors() const;
+		[[nodiscard]] uint32_t GetNumDynamicDescriptors() const { return m_NumDynamicDescriptors; }
+	private:
+		[[nodiscard]] uint32_t CheckedAllocate();
+	private:
+		ID3D12Device2* m_pDevice;
+		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_Heap;
+		D3D12_DESCRIPTOR_HEAP_TYPE m_Type;
+		uint32_t m_NumDescriptors;
+		uint32_t m_NumDynamicDescriptors;
+		UINT m_DescriptorSize;
+		D3D12_CPU_DESCRIPTOR_HANDLE m_CPUStart{};
+		D3D12_GPU_DESCRIPTOR_HANDLE m_GPUStart{};
+
+		mutable std::mutex m_Mutex;
+		FreeListGPUAllocator m_Allocator;
+		DynamicDescriptorAllocator m_DynamicAllocator;
+		DescriptorCopyBatch m_DynamicCopies;
+	};
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <d3d12.h>
+#include <wrl.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "realsim/graphics/FreeListAllocator.h"
+
+namespace RSim::Graphics
+{
+	/**
+	 * \brief A range of contiguous descriptors in one of the pages of a CPUDescriptorAllocator.
+	 */
+	struct DescriptorAllocation
+	{
+		D3D12_CPU_DESCRIPTOR_HANDLE Handle{};
+		uint32_t NumDescriptors{ 0 };
+		uint32_t PageIndex{ 0 };
+		uint32_t Offset{ 0 };
+		uint32_t DescriptorSize{ 0 };
+
+		[[nodiscard]] bool IsValid() const { return NumDescriptors != 0; }
+		[[nodiscard]] D3D12_CPU_DESCRIPTOR_HANDLE GetHandle(uint32_t Index = 0) const
+		{
+			return D3D12_CPU_DESCRIPTOR_HANDLE{ Handle.ptr + (SIZE_T)Index * DescriptorSize };
+		}
+		/**
+		 * \brief CPU handle of the first descriptor of the page's heap, which tells the heap apart from those of every other page and
+		 * allocator.
+		 */
+		[[nodiscard]] D3D12_CPU_DESCRIPTOR_HANDLE GetPageStart() const
+		{
+			return D3D12_CPU_DESCRIPTOR_HANDLE{ Handle.ptr - (SIZE_T)Offset * DescriptorSize };
+		}
+	};
+
+	/**
+	 * \brief Persistent descriptors in non-shader-visible heaps: render target and depth stencil views, and the CBV/SRV/UAVs and
+	 * samplers that are copied into a shader-visible heap when they are used. The descriptors are allocated from pages of
+	 * DescriptorsPerPage descriptors, each with its own FreeListAllocator, and a new page is created once no page can hold a request.
+	 * Descriptors of non-shader-visible heaps are read when a command is recorded or when they are copied, so they can be freed and
+	 * reused right away.
+	 * All member functions are thread-safe.
+	 */
+	class CPUDescriptorAllocator
+	{
+	public:
+		CPUDescriptorAllocator(ID3D12Device2* pDevice, D3D12_DESCRIPTOR_HEAP_TYPE Type, uint32_t DescriptorsPerPage);
+		CPUDescriptorAllocator(CPUDescriptorAllocator const&) = delete;
+		CPUDescriptorAllocator& operator=(CPUDescriptorAllocator const&) = delete;
+
+		/**
+		 * \brief Allocates NumDescriptors contiguous descriptors, requests larger than a page get a page of their own size.
+		 */
+		[[nodiscard]] DescriptorAllocation Allocate(uint32_t NumDescriptors = 1);
+		void Free(DescriptorAllocation& Allocation);
+
+		[[nodiscard]] D3D12_DESCRIPTOR_HEAP_TYPE GetType() const { return m_Type; }
+		[[nodiscard]] uint32_t GetDescriptorSize() const { return m_DescriptorSize; }
+		[[nodiscard]] std::size_t GetNumPages() const;
+	private:
+		struct Page
+		{
+			Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> Heap;
+			D3D12_CPU_DESCRIPTOR_HANDLE Start{};
+			FreeListAllocator Allocator;
+
+			explicit Page(uint32_t NumDescriptors) : Allocator(NumDescriptors) {}
+		};
+
+		Page& CreatePage(uint32_t NumDescriptors);
+	private:
+		ID3D12Device2* m_pDevice;
+		D3D12_DESCRIPTOR_HEAP_TYPE m_Type;
+		uint32_t m_DescriptorsPerPage;
+		uint32_t m_DescriptorSize;
+
+		mutable std::mutex m_Mutex;
+		std::vector<std::unique_ptr<Page>> m_Pages{};
+	};
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <d3d12.h>
+#include <wrl.h>
+#include <vector>
+#include <cstdint>
+#include <mutex>
+
+#include "realsim/graphics/CommandAllocator.h"
+#include "realsim/graphics/Exception.h"
+
+namespace RSim::Graphics
+{
+	/**
+	 * \brief An open command list and the allocator it records into. Obtained from and given back to a CommandContextManager.
+	 */
+	struct CommandContext
+	{
+		Microsoft::WRL::ComPtr<ID3D12CommandAllocator> CmdAllocator;
+		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList2> CmdList;
+
+		[[nodiscard]] bool IsValid() const { return CmdList != nullptr; }
+	};
+
+	/**
+	 * \brief Hands out command contexts for a single queue type. Allocators are recycled through a CommandAllocatorPool once the fence value
+	 * they were discarded with completes; command lists are recycled right away since a list can be reset as soon as it has been submitted.
+	 * The number of allocators follows the recording parallelism: ReleaseIdleAllocators drops the ones above the recent peak.
+	 * All member functions are thread-safe.
+	 */
+	class CommandContextManager
+	{
+	public:
+		CommandContextManager(ID3D12Device2* pDevice, D3D12_COMMAND_LIST_TYPE CommandType);
+		CommandContextManager(CommandContextManager const&) = delete;
+		CommandContextManager& operator=(CommandContextManager const&) = delete;
+
+		/**
+		 * \brief Returns an open command list reset with an allocator the GPU is no longer using.
+		 */
+		[[nodiscard]] CommandContext RequestContext(uint64_t CompletedFenceValue, ID3D12PipelineState* pInitialState = nullptr);
+
+		/**
+		 * \brief Gives the context back. Its allocator is not reused before FenceValue completes. The context is left empty.
+		 */
+		void DiscardContext(uint64_t FenceValue, CommandContext& Context);
+
+		/**
+		 * \brief Drops the completed allocators beyond the highest number of contexts that were in use at once since the last call.
+		 * Meant to be called once per frame.
+		 */
+		void ReleaseIdleAllocators(uint64_t CompletedFenceValue);
+
+		[[nodiscard]] size_t GetNumActiveContexts() const;
+		[[nodiscard]] size_t GetNumAllocators() const { return m_AllocatorPool.Size(); }
+	private:
+		ID3D12Device2* m_Device{ nullptr };
+		D3D12_COMMAND_LIST_TYPE m_CommandType;
+
+		CommandAllocatorPool m_AllocatorPool;
+		std::vector<Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList2>> m_FreeCmdLists;
+		size_t m_NumCmdLists{ 0 };
+		size_t m_NumActiveContexts{ 0 };
+		size_t m_PeakActiveContexts{ 0 };
+		mutable std::mutex m_Mutex;
+	};
+}
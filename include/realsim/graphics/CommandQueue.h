@@ -13,6 +13,7 @@
 #include <cstdint>
 
 #include "realsim/graphics/CommandAllocator.h"
+#include "realsim/graphics/CommandContext.h"
 #include "realsim/graphics/Exception.h"
 #include "realsim/Core/Assert.h"
 
@@ -57,6 +58,29 @@ namespace RSim::Graphics
 		 */
 		uint64_t ExecuteCommandList(ID3D12CommandList* pCommandList);
 
+		/**
+		 * \brief Closes all of the given command lists and submits them, in order, with a single ID3D12CommandQueue::ExecuteCommandLists call
+		 * followed by a single signal.
+		 * \return Returns the signaled fence value, which covers every list in the batch.
+		 */
+		uint64_t ExecuteCommandLists(ID3D12CommandList* const* ppCommandLists, uint32_t NumCommandLists);
+
+		/**
+		 * \brief Returns an open command list of this queue's type, backed by an allocator the GPU is done with. Thread-safe, so every
+		 * recording thread can request its own context.
+		 */
+		[[nodiscard]] CommandContext RequestContext(ID3D12PipelineState* pInitialState = nullptr);
+
+		/**
+		 * \brief Gives a context back once it has been submitted. FenceValue is the value returned by the Execute call that submitted it.
+		 */
+		void DiscardContext(uint64_t FenceValue, CommandContext& Context);
+
+		/**
+		 * \brief Lets the context pool shrink back to the parallelism that was actually used since the last call. Call once per frame.
+		 */
+		void ReleaseIdleContexts();
+
 		[[nodiscard]] inline Microsoft::WRL::ComPtr<ID3D12CommandQueue> const& GetCommandQueue() const { return m_CmdQueue; }
 
 		[[nodiscard]] inline uint64_t GetLastCompletedFenceValue() const { return m_LastCompletedFenceValue; }
@@ -76,7 +100,7 @@ namespace RSim::Graphics
 		std::mutex m_EventMutex;
 		std::mutex m_FenceMutex;
 
-		std::unique_ptr<CommandAllocatorPool> m_AllocatorPool;
+		std::unique_ptr<CommandContextManager> m_ContextManager;
 	};
 
 
@@ -0,0 +1,112 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "realsim/graphics/FreeListAllocator.h"
+
+namespace RSim::Graphics
+{
+	/**
+	 * \brief Hands out the per-frame descriptors of a range of a shader-visible heap. The range is split into chunks of ChunkSize
+	 * descriptors: descriptors are bump allocated from the frame's current chunk and a new chunk is taken from a FreeListGPUAllocator when
+	 * it runs out. EndFrame() frees all chunks of the frame with the frame's fence value, so they are reused once the GPU is done with
+	 * the frame. Frames end in fence order, so the chunks are handed out and retired like a ring buffer.
+	 * The descriptors are addressed by their index in the heap. It does not touch the graphics API and is not thread-safe.
+	 */
+	class DynamicDescriptorAllocator
+	{
+	public:
+		static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+		/**
+		 * \param FirstDescriptor Heap index of the first descriptor of the range.
+		 */
+		DynamicDescriptorAllocator(uint32_t FirstDescriptor, uint32_t NumDescriptors, uint32_t ChunkSize);
+		DynamicDescriptorAllocator(DynamicDescriptorAllocator const&) = delete;
+		DynamicDescriptorAllocator& operator=(DynamicDescriptorAllocator const&) = delete;
+
+		/**
+		 * \brief Allocates NumDescriptors contiguous descriptors for the current frame, requests larger than a chunk get a chunk of
+		 * their own size.
+		 * \return Heap index of the first one, InvalidIndex if no chunk is left.
+		 */
+		[[nodiscard]] uint32_t Allocate(uint32_t NumDescriptors);
+		/**
+		 * \brief Frees the chunks of the current frame once the GPU has passed FenceValue and starts a new frame.
+		 */
+		void EndFrame(uint64_t FenceValue);
+		/**
+		 * \brief Makes the chunks of the frames whose fence value is up to CompletedFenceValue available again.
+		 */
+		void ReleaseCompletedFrames(uint64_t CompletedFenceValue);
+
+		[[nodiscard]] uint32_t GetFirstDescriptor() const { return m_FirstDescriptor; }
+		[[nodiscard]] uint32_t GetNumDescriptors() const { return (uint32_t)m_Chunks.GetMaxSize(); }
+		[[nodiscard]] uint32_t GetChunkSize() const { return m_ChunkSize; }
+		/**
+		 * \brief Descriptors in chunks that are neither used by the current frame nor waiting for the GPU.
+		 */
+		[[nodiscard]] uint32_t GetNumFreeDescriptors() const { return (uint32_t)m_Chunks.GetFreeSize(); }
+		[[nodiscard]] std::size_t GetNumFrameChunks() const { return m_FrameChunks.size(); }
+	private:
+		FreeListGPUAllocator m_Chunks;
+		uint32_t m_FirstDescriptor;
+		uint32_t m_ChunkSize;
+		/**
+		 * \brief Chunks of the current frame, the last one is the one allocated from.
+		 */
+		std::vector<FreeListAllocator::Allocation> m_FrameChunks{};
+		uint32_t m_CurrentChunkUsed{ 0 };
+	};
+
+	/**
+	 * \brief Collects descriptor copies so they can be issued with a single ID3D12Device::CopyDescriptors call. Descriptors are given by
+	 * their CPU handle's address and the heap they live in, any value that identifies the heap such as the address of its first descriptor.
+	 * Consecutive copies whose sources or destinations are adjacent in the same heap are merged into one range, a range never spans two
+	 * heaps even where their addresses happen to follow each other. The source and destination ranges are merged independently since
+	 * CopyDescriptors only needs both sides to cover the same number of descriptors.
+	 * The starts are laid out like arrays of D3D12_CPU_DESCRIPTOR_HANDLE, which is a single SIZE_T.
+	 */
+	class DescriptorCopyBatch
+	{
+	public:
+		explicit DescriptorCopyBatch(uint32_t DescriptorSize) : m_DescriptorSize(DescriptorSize) {}
+
+		/**
+		 * \brief Queues the copy of NumDescriptors descriptors starting at SourceStart in SourceHeap to the ones starting at DestStart in
+		 * DestHeap.
+		 */
+		void Add(std::size_t SourceStart, std::size_t SourceHeap, std::size_t DestStart, std::size_t DestHeap, uint32_t NumDescriptors);
+		void Clear();
+
+		[[nodiscard]] bool IsEmpty() const { return m_NumDescriptors == 0; }
+		[[nodiscard]] uint32_t GetNumDescriptors() const { return m_NumDescriptors; }
+		[[nodiscard]] uint32_t GetDescriptorSize() const { return m_DescriptorSize; }
+
+		[[nodiscard]] std::vector<std::size_t> const& GetSourceStarts() const { return m_SourceStarts; }
+		[[nodiscard]] std::vector<uint32_t> const& GetSourceSizes() const { return m_SourceSizes; }
+		[[nodiscard]] std::vector<std::size_t> const& GetDestStarts() const { return m_DestStarts; }
+		[[nodiscard]] std::vector<uint32_t> const& GetDestSizes() const { return m_DestSizes; }
+
+		/**
+		 * \brief Performs the copies the way CopyDescriptors does, on descriptors that are host memory(e.g. those of the null device).
+		 */
+		void EmulateCopy() const;
+	private:
+		static void AddRange(std::vector<std::size_t>& Starts, std::vector<uint32_t>& Sizes, std::size_t& LastHeap, std::size_t Start,
+			std::size_t Heap, uint32_t NumDescriptors, uint32_t DescriptorSize);
+	private:
+		uint32_t m_DescriptorSize;
+		uint32_t m_NumDescriptors{ 0 };
+		std::vector<std::size_t> m_SourceStarts{};
+		std::vector<uint32_t> m_SourceSizes{};
+		std::vector<std::size_t> m_DestStarts{};
+		std::vector<uint32_t> m_DestSizes{};
+		/**
+		 * \brief Heaps of the last source and destination range, only those can be extended.
+		 */
+		std::size_t m_LastSourceHeap{ 0 };
+		std::size_t m_LastDestHeap{ 0 };
+	};
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <utility>
+
+namespace RSim::Graphics
+{
+	/**
+	 * \brief A FIFO of objects that the GPU may still be using, each tagged with the fence value that has to complete before it can be reused.
+	 * It does not depend on the graphics API, so the same retirement logic backs CommandAllocatorPool and can be driven by the null device.
+	 * Not thread-safe; the owner is expected to guard it.
+	 */
+	template<typename T>
+	class FencedObjectPool
+	{
+	public:
+		/**
+		 * \brief Queues an object for reuse once FenceValue is completed. Fence values must be discarded in non-decreasing order.
+		 */
+		void Discard(uint64_t FenceValue, T Object)
+		{
+			m_PendingObjects.emplace_back(FenceValue, std::move(Object));
+		}
+
+		/**
+		 * \brief Pops the oldest discarded object if its fence value has been reached.
+		 * \return std::nullopt if there is no object that the GPU is done with.
+		 */
+		[[nodiscard]] std::optional<T> TryAcquire(uint64_t CompletedFenceValue)
+		{
+			if (m_PendingObjects.empty() || m_PendingObjects.front().first > CompletedFenceValue)
+				return std::nullopt;
+
+			std::optional<T> Object{ std::move(m_PendingObjects.front().second) };
+			m_PendingObjects.pop_front();
+			return Object;
+		}
+
+		/**
+		 * \brief Number of discarded objects the GPU is done with, i.e. the ones TryAcquire would hand out in a row.
+		 */
+		[[nodiscard]] std::size_t GetNumCompletedObjects(uint64_t CompletedFenceValue) const
+		{
+			std::size_t NumCompleted = 0;
+			while (NumCompleted < m_PendingObjects.size() && m_PendingObjects[NumCompleted].first <= CompletedFenceValue)
+				++NumCompleted;
+			return NumCompleted;
+		}
+
+		/**
+		 * \brief Destroys the NumObjects oldest discarded objects, which must not be more than GetNumCompletedObjects().
+		 */
+		void DropOldest(std::size_t NumObjects)
+		{
+			m_PendingObjects.erase(m_PendingObjects.begin(), m_PendingObjects.begin() + (std::ptrdiff_t)NumObjects);
+		}
+
+		[[nodiscard]] std::size_t GetNumPendingObjects() const { return m_PendingObjects.size(); }
+		[[nodiscard]] bool IsEmpty() const { return m_PendingObjects.empty(); }
+	private:
+		std::deque<std::pair<uint64_t, T>> m_PendingObjects;
+	};
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include "realsim/graphics/RendererConfiguration.h"
+
+namespace RSim::Graphics
+{
+	/**
+	 * \brief Per-frame timings, exponentially smoothed.
+	 */
+	struct FramePacingStatistics
+	{
+		/**
+		 * \brief CPU time from the start of one frame to the start of the next.
+		 */
+		float CPUFrameTimeMs = 0.0f;
+		/**
+		 * \brief Part of CPUFrameTimeMs spent blocked on the swap chain or on the GPU.
+		 */
+		float CPUWaitTimeMs = 0.0f;
+		/**
+		 * \brief Fraction of the frame the CPU spent doing work rather than waiting, 1.0 means the CPU is the bottleneck.
+		 */
+		float CPUBusyRatio = 0.0f;
+		/**
+		 * \brief Number of submitted frames the GPU has not finished, sampled at the end of the frame. Close to MaxFrameLatency means the
+		 * GPU is the bottleneck and the CPU is running ahead of it.
+		 */
+		float FramesInFlight = 0.0f;
+		uint64_t FrameCount = 0;
+	};
+
+	/**
+	 * \brief The bookkeeping part of FramePacer: the fence values of the last frames, which of them the CPU has to wait for to stay
+	 * within MaxFrameLatency frames of the GPU, and the statistics. It does not touch the graphics API.
+	 */
+	class FrameLatencyTracker
+	{
+	public:
+		explicit FrameLatencyTracker(uint32_t MaxFrameLatency);
+
+		/**
+		 * \brief Clamps the latency to [1, NumFramesInFlight].
+		 */
+		void SetMaxFrameLatency(uint32_t MaxFrameLatency);
+
+		/**
+		 * \brief Fence value of the frame MaxFrameLatency frames back, which has to complete before the next frame starts.
+		 * std::nullopt while fewer frames than that have been submitted.
+		 */
+		[[nodiscard]] std::optional<uint64_t> GetFenceValueToWaitFor() const;
+
+		/**
+		 * \brief Records the fence value that completes the frame and updates the statistics.
+		 * \param CompletedFenceValue The queue's completed fence value at the end of the frame.
+		 */
+		void EndFrame(uint64_t FrameFenceValue, uint64_t CompletedFenceValue, float FrameTimeMs, float WaitTimeMs);
+
+		[[nodiscard]] uint32_t GetMaxFrameLatency() const { return m_MaxFrameLatency; }
+		[[nodiscard]] uint64_t GetFrameNumber() const { return m_FrameNumber; }
+		[[nodiscard]] FramePacingStatistics const& GetStatistics() const { return m_Statistics; }
+	private:
+		uint32_t m_MaxFrameLatency{ 1 };
+		/**
+		 * \brief Fence values of the last NumFramesInFlight frames, indexed by frame number modulo NumFramesInFlight.
+		 */
+		std::array<uint64_t, NumFramesInFlight> m_FrameFenceValues{};
+		uint64_t m_FrameNumber{ 0 };
+		FramePacingStatistics m_Statistics{};
+	};
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <d3d12.h>
+#include <chrono>
+#include <cstdint>
+
+#include "realsim/graphics/CommandQueue.h"
+#include "realsim/graphics/FrameLatencyTracker.h"
+#include "realsim/graphics/RendererConfiguration.h"
+#include "realsim/graphics/SwapChain.h"
+
+namespace RSim::Graphics
+{
+	/**
+	 * \brief Decides when the CPU may start a new frame. Instead of waiting for the GPU right after every present, the CPU only blocks
+	 * when it would get more than MaxFrameLatency frames ahead, first on the swap chain's frame latency waitable object and then on the
+	 * fence of the frame that is MaxFrameLatency frames old.
+	 */
+	class FramePacer
+	{
+	public:
+		FramePacer(SwapChain const& swapChain, CommandQueue& queue, FramePacingDesc const& desc, bool tearingSupported);
+		FramePacer(FramePacer const&) = delete;
+		FramePacer& operator=(FramePacer const&) = delete;
+		~FramePacer();
+
+		/**
+		 * \brief Blocks until a new frame can be started without exceeding the frame latency.
+		 */
+		void BeginFrame();
+
+		/**
+		 * \brief Records the fence value that completes the frame, call it after the frame has been presented.
+		 */
+		void EndFrame(uint64_t frameFenceValue);
+
+		void SetDesc(FramePacingDesc const& desc);
+
+		[[nodiscard]] FramePacingDesc const& GetDesc() const { return m_Desc; }
+		[[nodiscard]] FramePacingStatistics const& GetStatistics() const { return m_Tracker.GetStatistics(); }
+		[[nodiscard]] UINT GetSyncInterval() const;
+		[[nodiscard]] UINT GetPresentFlags() const;
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		static float ToMilliseconds(Clock::duration duration);
+		/**
+		 * \brief Time BeginFrame waits for the swap chain before it gives up and starts the frame anyway.
+		 */
+		static constexpr DWORD FrameLatencyWaitTimeoutMs = 1000;
+	private:
+		SwapChain const& m_SwapChain;
+		CommandQueue& m_Queue;
+		FramePacingDesc m_Desc;
+		bool m_TearingSupported;
+
+		HANDLE m_FrameLatencyWaitableObject{ nullptr };
+		FrameLatencyTracker m_Tracker;
+
+		Clock::time_point m_FrameStart{};
+		Clock::duration m_FrameWaitTime{};
+	};
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include <cstdint>
 #include <deque>
+#include <limits>
 #include <map>
 
 #include "realsim/core/Assert.h"
@@ -31,7 +32,7 @@ namespace RSim::Graphics
 
 			FreeBlockInfo(OffsetType Size) : Size(Size) {}
 		};
-	protected:
+	public:
 		struct Allocation
 		{
 			Allocation(OffsetType Offset, OffsetType Size) : Offset{Offset} , Size{Size} {}
@@ -42,7 +43,7 @@ namespace RSim::Graphics
 
 			[[nodiscard]] bool IsValid() const
 			{
-				return *this == InvalidAllocation();
+				return Size != InvalidOffset();
 			}
 
 			bool operator==(Allocation&& rhs) const noexcept
@@ -63,8 +64,8 @@ namespace RSim::Graphics
 		void Free(OffsetType Offset, OffsetType Size);
 		void Free(Allocation& allocation);
 
-		[[nodiscard]] OffsetType IsFull() const { return m_FreeSize == 0; }
-		[[nodiscard]] OffsetType IsEmpty() const { return m_MaxSize==m_FreeSize; }
+		[[nodiscard]] bool IsFull() const { return m_FreeSize == 0; }
+		[[nodiscard]] bool IsEmpty() const { return m_MaxSize==m_FreeSize; }
 		[[nodiscard]] OffsetType GetMaxSize() const { return m_MaxSize; }
 		/**
 		 * \brief Due to fragmentation, allocations can still fail even if the return value is greater than the requested allocation size.
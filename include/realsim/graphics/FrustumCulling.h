@@ -0,0 +1,107 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace RSim::Core
+{
+	class ThreadPool;
+}
+
+namespace RSim::Graphics
+{
+	/**
+	 * \brief A plane n.x + d = 0 with the normal pointing into the frustum.
+	 */
+	struct FrustumPlane
+	{
+		float NormalX, NormalY, NormalZ, Distance;
+	};
+
+	struct Frustum
+	{
+		/**
+		 * \brief Left, right, bottom, top, near and far planes.
+		 */
+		std::array<FrustumPlane, 6> Planes;
+
+		/**
+		 * \brief Extracts the planes from a row-major, row-vector view-projection matrix (as produced by DirectXMath) whose clip space
+		 * depth range is [0, 1]. The planes are in the space the matrix transforms from, normally world space.
+		 */
+		[[nodiscard]] static Frustum FromViewProjection(float const (&ViewProjection)[4][4]);
+	};
+
+	/**
+	 * \brief World-space axis-aligned bounding boxes stored as structure-of-arrays so that the culling loop can load eight boxes'
+	 * worth of a coordinate with a single instruction. The arrays are padded to a multiple of the SIMD width with empty boxes that
+	 * lie at the origin; the padding is never reported as visible.
+	 */
+	class BoundingBoxes
+	{
+	public:
+		static constexpr std::size_t Padding = 8;
+
+		void Resize(std::size_t Count);
+		void Clear() { Resize(0); }
+
+		void Set(std::size_t Index, float CenterX, float CenterY, float CenterZ, float ExtentX, float ExtentY, float ExtentZ)
+		{
+			m_CenterX[Index] = CenterX; m_CenterY[Index] = CenterY; m_CenterZ[Index] = CenterZ;
+			m_ExtentX[Index] = ExtentX; m_ExtentY[Index] = ExtentY; m_ExtentZ[Index] = ExtentZ;
+		}
+
+		/**
+		 * \brief Transforms a local-space box by a row-major, row-vector world matrix and stores the box that encloses the result.
+		 */
+		void SetTransformed(std::size_t Index, float const (&World)[4][4], float const (&LocalCenter)[3], float const (&LocalExtent)[3]);
+
+		[[nodiscard]] std::size_t Size() const { return m_Count; }
+		[[nodiscard]] float const* CenterX() const { return m_CenterX.data(); }
+		[[nodiscard]] float const* CenterY() const { return m_CenterY.data(); }
+		[[nodiscard]] float const* CenterZ() const { return m_CenterZ.data(); }
+		[[nodiscard]] float const* ExtentX() const { return m_ExtentX.data(); }
+		[[nodiscard]] float const* ExtentY() const { return m_ExtentY.data(); }
+		[[nodiscard]] float const* ExtentZ() const { return m_ExtentZ.data(); }
+	private:
+		std::size_t m_Count = 0;
+		std::vector<float> m_CenterX, m_CenterY, m_CenterZ;
+		std::vector<float> m_ExtentX, m_ExtentY, m_ExtentZ;
+	};
+
+	/**
+	 * \brief Tests bounding boxes against a frustum and outputs the indices of the boxes that are at least partially inside, in
+	 * ascending order. The boxes are split into ranges that are culled in parallel, eight boxes at a time with AVX, four with SSE,
+	 * or one at a time when neither is available at compile time. Every range writes its visible indices into its own list and the
+	 * lists are concatenated at the end.
+	 * Conservative: a box that straddles two planes outside the frustum's corner may be reported visible.
+	 */
+	class FrustumCuller
+	{
+	public:
+		/**
+		 * \param pPool Thread pool to cull on, nullptr culls on the calling thread.
+		 * \return The number of visible boxes.
+		 */
+		std::size_t Cull(Frustum const& Frustum, BoundingBoxes const& Boxes, Core::ThreadPool* pPool);
+
+		[[nodiscard]] std::vector<uint32_t> const& GetVisibleIndices() const { return m_VisibleIndices; }
+
+		/**
+		 * \brief Scalar reference of the test the SIMD paths perform.
+		 */
+		[[nodiscard]] static bool IsVisible(Frustum const& Frustum, BoundingBoxes const& Boxes, std::size_t Index);
+
+		/**
+		 * \brief Minimum number of boxes a culling task is given.
+		 */
+		static constexpr std::size_t MinBoxesPerTask = 16384;
+	private:
+		static void CullRange(Frustum const& Frustum, BoundingBoxes const& Boxes, std::size_t Begin, std::size_t End,
+			std::vector<uint32_t>& VisibleIndices);
+	private:
+		std::vector<std::vector<uint32_t>> m_TaskVisibleIndices;
+		std::vector<uint32_t> m_VisibleIndices;
+	};
+}
@@ -0,0 +1,172 @@
+#pragma once
+#include <DirectXMath.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "realsim/graphics/FrustumCulling.h"
+#include "realsim/graphics/InstanceBatcher.h"
+
+namespace RSim::Graphics
+{
+	/**
+	 * \brief Same layout as D3D12_DRAW_INDEXED_ARGUMENTS, which is checked where the d3d12 headers are available.
+	 */
+	struct IndirectDrawArguments
+	{
+		uint32_t IndexCountPerInstance;
+		uint32_t InstanceCount;
+		uint32_t StartIndexLocation;
+		int32_t BaseVertexLocation;
+		uint32_t StartInstanceLocation;
+	};
+
+	/**
+	 * \brief One command of the indirect command signature: the root constant with the first instance of the group, as the instanced
+	 * shaders expect it, followed by the indexed draw. The layout has to match IndirectCommand in Shaders/gpu_cull.csh.
+	 */
+	struct IndirectCommand
+	{
+		uint32_t FirstInstance;
+		IndirectDrawArguments Draw;
+	};
+
+	static_assert(sizeof(IndirectDrawArguments) == 20, "The draw arguments must be laid out like D3D12_DRAW_INDEXED_ARGUMENTS.");
+	static_assert(sizeof(IndirectCommand) == 24, "The command signature's byte stride is the size of a command.");
+
+	/**
+	 * \brief Per-instance data of the GPU-driven path, read by the culling shader and by Shaders/instanced_indirect.vsh. The culling
+	 * shader computes the world bounds from the world matrix and the local bounds of the instance's mesh.
+	 */
+	struct GPUInstance
+	{
+		DirectX::XMFLOAT4X4 World;
+		DirectX::XMFLOAT4 Color;
+		uint32_t GroupIndex;
+		uint32_t MeshIndex;
+		uint32_t Padding[2];
+	};
+
+	/**
+	 * \brief A mesh as the GPU-driven path sees it: a range of the shared index buffer and its local bounds. Every mesh drawn by one
+	 * ExecuteIndirect has to live in the same vertex and index buffers, since the command signature does not change them.
+	 */
+	struct IndirectMesh
+	{
+		uint32_t NumIndices;
+		uint32_t FirstIndex;
+		int32_t BaseVertex;
+		uint32_t Padding0;
+		float LocalCenter[3];
+		uint32_t Padding1;
+		float LocalExtent[3];
+		uint32_t Padding2;
+	};
+
+	/**
+	 * \brief Root constants of the culling shaders, one set per view.
+	 */
+	struct CullConstants
+	{
+		FrustumPlane Planes[6];
+		uint32_t NumInstances;
+		uint32_t NumGroups;
+		uint32_t ViewIndex;
+		uint32_t Padding;
+	};
+
+	static constexpr uint32_t NumCullConstants = sizeof(CullConstants) / sizeof(uint32_t);
+
+	/**
+	 * \brief CPU side of the GPU-driven path. Build() groups the instances by InstanceGroupKey like the InstanceBatcher does, after which
+	 * the instance data and the tables the culling shader starts from are written into one upload buffer:
+	 *
+	 *   [GPUInstance x NumInstances][IndirectMesh x NumMeshes][IndirectCommand x NumGroups][uint32_t 0 x NumViews]
+	 *
+	 * each section starting at a multiple of SectionAlignment. The command template holds one command per group with its draw arguments
+	 * and an instance count of zero. Every frame it is copied over the group commands of every view, the culling pass counts the
+	 * visible instances of each group into them, and the compaction pass moves the groups that have any to the front of the view's
+	 * commands, counting them in the view's count. ExecuteIndirect then draws the view with its commands and count.
+	 * The work on the CPU is per instance only for writing the instance data, everything per draw happens on the GPU.
+	 * It does not touch the graphics API so it can be used, together with EmulateCulling(), without a device.
+	 */
+	class IndirectDrawBuilder
+	{
+	public:
+		/**
+		 * \brief Root SRV and UAV addresses of structured buffers are kept aligned to their largest stride.
+		 */
+		static constexpr std::size_t SectionAlignment = 256;
+		/**
+		 * \brief Threads per group of both culling shaders, [numthreads] in Shaders/gpu_cull.csh.
+		 */
+		static constexpr uint32_t ThreadGroupSize = 64;
+
+		/**
+		 * \brief Groups the instances and lays out the buffers.
+		 * \param pKeys Key of every instance, the MeshID indexes pMeshes.
+		 */
+		void Build(InstanceGroupKey const* pKeys, std::size_t NumInstances, IndirectMesh const* pMeshes, std::size_t NumMeshes,
+			std::size_t NumViews);
+
+		/**
+		 * \brief Writes the data of the DrawIndex'th instance given to Build() into its slot of the upload buffer. Instances have their
+		 * own slots, so they can be written from any number of threads.
+		 */
+		void WriteInstance(void* pUpload, std::size_t DrawIndex, DirectX::XMFLOAT4X4 const& World, DirectX::XMFLOAT4 const& Color) const;
+		/**
+		 * \brief Writes the meshes, the command template and the zeroed counts into the upload buffer.
+		 */
+		void WriteTables(void* pUpload) const;
+
+		[[nodiscard]] CullConstants GetCullConstants(std::size_t ViewIndex, Frustum const& ViewFrustum) const;
+
+		[[nodiscard]] std::size_t GetNumInstances() const { return m_Batcher.GetNumInstances(); }
+		[[nodiscard]] std::size_t GetNumGroups() const { return m_Batcher.GetGroups().size(); }
+		[[nodiscard]] std::size_t GetNumViews() const { return m_NumViews; }
+		[[nodiscard]] std::vector<InstanceGroup> const& GetGroups() const { return m_Batcher.GetGroups(); }
+
+		[[nodiscard]] std::size_t GetUploadSize() const { return m_UploadSize; }
+		[[nodiscard]] std::size_t GetInstancesOffset() const { return 0; }
+		[[nodiscard]] std::size_t GetMeshesOffset() const { return m_MeshesOffset; }
+		[[nodiscard]] std::size_t GetCommandTemplateOffset() const { return m_CommandTemplateOffset; }
+		[[nodiscard]] std::size_t GetCommandTemplateSize() const { return GetNumGroups() * sizeof(IndirectCommand); }
+		[[nodiscard]] std::size_t GetZeroCountsOffset() const { return m_ZeroCountsOffset; }
+
+		/**
+		 * \brief Sizes of the GPU buffers: the group commands and the compacted commands hold GetNumGroups() commands per view, the
+		 * visible instances GetNumInstances() indices per view and the counts one per view.
+		 */
+		[[nodiscard]] std::size_t GetCommandBufferSize() const { return m_NumViews * GetCommandTemplateSize(); }
+		[[nodiscard]] std::size_t GetVisibleInstanceBufferSize() const { return m_NumViews * GetNumInstances() * sizeof(uint32_t); }
+		[[nodiscard]] std::size_t GetCountBufferSize() const { return m_NumViews * sizeof(uint32_t); }
+
+		[[nodiscard]] std::size_t GetCommandOffset(std::size_t ViewIndex) const { return ViewIndex * GetCommandTemplateSize(); }
+		[[nodiscard]] static std::size_t GetCountOffset(std::size_t ViewIndex) { return ViewIndex * sizeof(uint32_t); }
+
+		[[nodiscard]] static uint32_t GetNumThreadGroups(std::size_t NumThreads)
+		{
+			return (uint32_t)((NumThreads + ThreadGroupSize - 1) / ThreadGroupSize);
+		}
+
+		/**
+		 * \brief Runs the culling and compaction passes of one view on the CPU the way Shaders/gpu_cull.csh does, on the buffers as the
+		 * GPU sees them. pGroupCommands has to hold the command template at the view's commands and pCounts a zero at the view's count.
+		 * Within a group the visible instances are in ascending order, on the GPU they are in the order the threads got their slots.
+		 */
+		static void EmulateCulling(CullConstants const& Constants, GPUInstance const* pInstances, IndirectMesh const* pMeshes,
+			IndirectCommand* pGroupCommands, uint32_t* pVisibleInstances, IndirectCommand* pCommands, uint32_t* pCounts);
+	private:
+		InstanceBatcher m_Batcher;
+		std::vector<IndirectMesh> m_Meshes;
+		/**
+		 * \brief Group of every instance slot.
+		 */
+		std::vector<uint32_t> m_SlotGroups;
+		std::size_t m_NumViews{ 0 };
+		std::size_t m_MeshesOffset{ 0 };
+		std::size_t m_CommandTemplateOffset{ 0 };
+		std::size_t m_ZeroCountsOffset{ 0 };
+		std::size_t m_UploadSize{ 0 };
+	};
+}
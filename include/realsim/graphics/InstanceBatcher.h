@@ -0,0 +1,65 @@
+#pragma once
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+
+namespace RSim::Graphics
+{
+	/**
+	 * \brief Per-instance data read by the instanced shaders through a StructuredBuffer, the layout has to match InstanceData in
+	 * Shaders/instanced.vsh.
+	 */
+	struct InstanceData
+	{
+		DirectX::XMFLOAT4X4 World;
+		DirectX::XMFLOAT4 Color;
+	};
+
+	/**
+	 * \brief Identifies what can be drawn with a single instanced draw: instances that share a key share their vertex/index buffers and
+	 * their pipeline state.
+	 */
+	struct InstanceGroupKey
+	{
+		uint32_t MeshID = 0;
+		uint32_t MaterialID = 0;
+
+		[[nodiscard]] uint64_t Hash() const { return (uint64_t)MeshID << 32 | MaterialID; }
+		bool operator==(InstanceGroupKey const& other) const { return Hash() == other.Hash(); }
+	};
+
+	struct InstanceGroup
+	{
+		InstanceGroupKey Key;
+		uint32_t FirstInstance = 0;
+		uint32_t NumInstances = 0;
+	};
+
+	/**
+	 * \brief Groups draws by InstanceGroupKey so that every group can be drawn with one instanced draw. Given the key of every draw,
+	 * Build() assigns each draw a slot in the instance buffer such that the instances of a group are contiguous; the per-instance data
+	 * can then be written into the slots from any number of threads since no two draws share a slot.
+	 * It does not touch the graphics API so it can be used without a device.
+	 */
+	class InstanceBatcher
+	{
+	public:
+		/**
+		 * \brief Groups the draws, groups keep the order in which their first draw appears and draws keep their relative order within a group.
+		 */
+		void Build(InstanceGroupKey const* pKeys, std::size_t NumDraws);
+
+		/**
+		 * \brief The slot in the instance buffer of the DrawIndex'th draw given to Build().
+		 */
+		[[nodiscard]] uint32_t GetInstanceIndex(std::size_t DrawIndex) const { return m_InstanceIndices[DrawIndex]; }
+		[[nodiscard]] std::vector<InstanceGroup> const& GetGroups() const { return m_Groups; }
+		[[nodiscard]] std::size_t GetNumInstances() const { return m_InstanceIndices.size(); }
+	private:
+		std::vector<InstanceGroup> m_Groups;
+		std::vector<uint32_t> m_InstanceIndices;
+		std::vector<uint32_t> m_DrawGroups;
+		std::unordered_map<uint64_t, uint32_t> m_GroupLookup;
+	};
+}
@@ -0,0 +1,282 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "realsim/core/Assert.h"
+#include "realsim/graphics/BasicCommandAllocatorPool.h"
+
+/*
+ * The null device is a host-only stand-in for the subset of ID3D12Device2 the renderer uses. It has no dependency on the Windows SDK
+ * so the queue, fence and pooling logic can be driven and profiled on machines without a GPU(e.g. the Linux build farm).
+ * Queues run their submissions on a 'GPU timeline' thread, fences complete after a configurable latency, and
+ * descriptor heaps and resources are plain host memory.
+ */
+namespace RSim::Graphics
+{
+	/**
+	 * \brief Same values as D3D12_COMMAND_LIST_TYPE, so the fence value encoding (Type << 56) used by CommandQueue carries over.
+	 */
+	enum class NullCommandListType : uint8_t
+	{
+		Direct = 0,
+		Bundle = 1,
+		Compute = 2,
+		Copy = 3
+	};
+
+	enum class NullDescriptorHeapType : uint8_t
+	{
+		CBV_SRV_UAV = 0,
+		Sampler = 1,
+		RTV = 2,
+		DSV = 3
+	};
+
+	struct NullDeviceDesc
+	{
+		/**
+		 * \brief Time between the GPU timeline reaching a Signal and the fence reporting the value as completed.
+		 */
+		std::chrono::microseconds FenceCompletionLatency{ 0 };
+		/**
+		 * \brief Simulated GPU time spent on every recorded command when a command list is executed.
+		 */
+		std::chrono::nanoseconds CommandExecutionTime{ 0 };
+		/**
+		 * \brief Size reported by NullDevice::GetDescriptorHandleIncrementSize for every heap type.
+		 */
+		uint32_t DescriptorSize = 32;
+	};
+
+	class NullFence
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		explicit NullFence(uint64_t InitialValue);
+		NullFence(NullFence const&) = delete;
+		NullFence& operator=(NullFence const&) = delete;
+
+		[[nodiscard]] uint64_t GetCompletedValue() const;
+
+		/**
+		 * \brief Sets the fence value from the CPU, immediately. Fence values only grow, a lower value than the completed one is ignored.
+		 */
+		void Signal(uint64_t Value);
+
+		/**
+		 * \brief Blocks the calling thread until the fence reaches Value. Equivalent of SetEventOnCompletion + WaitForSingleObject.
+		 */
+		void WaitForValue(uint64_t Value) const;
+	private:
+		friend class NullCommandQueue;
+
+		struct PendingSignal
+		{
+			uint64_t Value;
+			Clock::time_point CompletionTime;
+		};
+
+		/**
+		 * \brief Called from the GPU timeline. The value becomes visible to GetCompletedValue at CompletionTime.
+		 */
+		void ScheduleSignal(uint64_t Value, Clock::time_point CompletionTime);
+		void RetirePendingSignals(Clock::time_point Now) const;
+	private:
+		mutable std::mutex m_Mutex;
+		mutable std::condition_variable m_ValueChanged;
+		mutable uint64_t m_CompletedValue;
+		mutable std::deque<PendingSignal> m_PendingSignals;
+	};
+
+	class NullCommandAllocator
+	{
+	public:
+		explicit NullCommandAllocator(NullCommandListType Type) : m_Type(Type) {}
+		NullCommandAllocator(NullCommandAllocator const&) = delete;
+		NullCommandAllocator& operator=(NullCommandAllocator const&) = delete;
+
+		void Reset();
+
+		[[nodiscard]] NullCommandListType GetType() const { return m_Type; }
+		[[nodiscard]] uint64_t GetNumResets() const { return m_NumResets; }
+		[[nodiscard]] std::size_t GetNumRecordedCommands() const { return m_NumRecordedCommands; }
+	private:
+		friend class NullCommandList;
+
+		NullCommandListType m_Type;
+		uint64_t m_NumResets = 0;
+		std::size_t m_NumRecordedCommands = 0;
+	};
+
+	/**
+	 * \brief Records nothing but the number of commands, which is what the GPU timeline uses to simulate execution time.
+	 */
+	class NullCommandList
+	{
+	public:
+		NullCommandList(NullCommandListType Type, NullCommandAllocator* pAllocator);
+		NullCommandList(NullCommandList const&) = delete;
+		NullCommandList& operator=(NullCommandList const&) = delete;
+
+		void Reset(NullCommandAllocator* pAllocator);
+		void Close();
+
+		/**
+		 * \brief Stands in for any ID3D12GraphicsCommandList call(draws, state changes, barriers...).
+		 */
+		void RecordCommands(std::size_t NumCommands = 1);
+
+		[[nodiscard]] NullCommandListType GetType() const { return m_Type; }
+		[[nodiscard]] bool IsClosed() const { return m_IsClosed; }
+		[[nodiscard]] std::size_t GetNumCommands() const { return m_NumCommands; }
+	private:
+		NullCommandListType m_Type;
+		NullCommandAllocator* m_pAllocator{ nullptr };
+		std::size_t m_NumCommands = 0;
+		bool m_IsClosed = false;
+	};
+
+	class NullCommandQueue
+	{
+	public:
+		NullCommandQueue(NullDeviceDesc const& Desc, NullCommandListType Type);
+		NullCommandQueue(NullCommandQueue const&) = delete;
+		NullCommandQueue& operator=(NullCommandQueue const&) = delete;
+		~NullCommandQueue();
+
+		void ExecuteCommandLists(uint32_t NumCommandLists, NullCommandList* const* ppCommandLists);
+		/**
+		 * \brief Queues a GPU-side signal; the fence completes once the timeline reaches it plus the configured latency.
+		 */
+		void Signal(NullFence* pFence, uint64_t Value);
+		/**
+		 * \brief Queues a GPU-side wait; work submitted after this does not start until the fence reaches Value.
+		 */
+		void Wait(NullFence* pFence, uint64_t Value);
+
+		[[nodiscard]] NullCommandListType GetType() const { return m_Type; }
+		[[nodiscard]] uint64_t GetNumExecuteCalls() const { return m_NumExecuteCalls; }
+		[[nodiscard]] uint64_t GetNumExecutedCommandLists() const { return m_NumExecutedCommandLists; }
+		[[nodiscard]] uint64_t GetNumSignals() const { return m_NumSignals; }
+		/**
+		 * \brief Total simulated time the timeline spent executing command lists.
+		 */
+		[[nodiscard]] std::chrono::nanoseconds GetBusyTime() const { return std::chrono::nanoseconds(m_BusyTimeNs.load()); }
+	private:
+		struct Operation
+		{
+			enum class Type : uint8_t { Execute, Signal, Wait } OpType;
+			NullFence* pFence;
+			uint64_t Value;
+			std::size_t NumCommands;
+		};
+
+		void Push(Operation const& Op);
+		void RunTimeline();
+	private:
+		NullDeviceDesc m_Desc;
+		NullCommandListType m_Type;
+
+		std::mutex m_Mutex;
+		std::condition_variable m_HasOperations;
+		std::deque<Operation> m_Operations;
+		bool m_Exit = false;
+		std::thread m_Timeline;
+
+		std::atomic<uint64_t> m_NumExecuteCalls{ 0 };
+		std::atomic<uint64_t> m_NumExecutedCommandLists{ 0 };
+		std::atomic<uint64_t> m_NumSignals{ 0 };
+		std::atomic<uint64_t> m_BusyTimeNs{ 0 };
+	};
+
+	class NullDescriptorHeap
+	{
+	public:
+		NullDescriptorHeap(NullDescriptorHeapType Type, uint32_t NumDescriptors, uint32_t DescriptorSize, bool ShaderVisible, uint64_t GPUBaseAddress);
+
+		/**
+		 * \brief Host address of the first descriptor, the same role as D3D12_CPU_DESCRIPTOR_HANDLE::ptr.
+		 */
+		[[nodiscard]] std::size_t GetCPUDescriptorHandleForHeapStart() const { return reinterpret_cast<std::size_t>(m_Memory.data()); }
+		[[nodiscard]] uint64_t GetGPUDescriptorHandleForHeapStart() const;
+
+		[[nodiscard]] NullDescriptorHeapType GetType() const { return m_Type; }
+		[[nodiscard]] uint32_t GetNumDescriptors() const { return m_NumDescriptors; }
+		[[nodiscard]] bool IsShaderVisible() const { return m_ShaderVisible; }
+	private:
+		NullDescriptorHeapType m_Type;
+		uint32_t m_NumDescriptors;
+		bool m_ShaderVisible;
+		uint64_t m_GPUBaseAddress;
+		std::vector<std::byte> m_Memory;
+	};
+
+	class NullResource
+	{
+	public:
+		NullResource(std::size_t SizeInBytes, uint64_t GPUVirtualAddress);
+
+		[[nodiscard]] void* Map() { return m_Memory.data(); }
+		void Unmap() {}
+
+		[[nodiscard]] std::size_t GetSize() const { return m_Memory.size(); }
+		[[nodiscard]] uint64_t GetGPUVirtualAddress() const { return m_GPUVirtualAddress; }
+	private:
+		std::vector<std::byte> m_Memory;
+		uint64_t m_GPUVirtualAddress;
+	};
+
+	class NullDevice
+	{
+	public:
+		explicit NullDevice(NullDeviceDesc const& Desc = {});
+		NullDevice(NullDevice const&) = delete;
+		NullDevice& operator=(NullDevice const&) = delete;
+
+		[[nodiscard]] std::unique_ptr<NullCommandQueue> CreateCommandQueue(NullCommandListType Type) const;
+		[[nodiscard]] std::unique_ptr<NullFence> CreateFence(uint64_t InitialValue) const;
+		[[nodiscard]] std::shared_ptr<NullCommandAllocator> CreateCommandAllocator(NullCommandListType Type) const;
+		[[nodiscard]] std::unique_ptr<NullCommandList> CreateCommandList(NullCommandListType Type, NullCommandAllocator* pAllocator) const;
+		[[nodiscard]] std::unique_ptr<NullDescriptorHeap> CreateDescriptorHeap(NullDescriptorHeapType Type, uint32_t NumDescriptors, bool ShaderVisible);
+		[[nodiscard]] std::unique_ptr<NullResource> CreateCommittedResource(std::size_t SizeInBytes);
+
+		[[nodiscard]] uint32_t GetDescriptorHandleIncrementSize(NullDescriptorHeapType) const { return m_Desc.DescriptorSize; }
+		[[nodiscard]] NullDeviceDesc const& GetDesc() const { return m_Desc; }
+	private:
+		/**
+		 * \brief Hands out non-overlapping fake GPU virtual addresses.
+		 */
+		uint64_t ReserveGPUAddressRange(std::size_t SizeInBytes);
+	private:
+		NullDeviceDesc m_Desc;
+		uint64_t m_NextGPUVirtualAddress = 0x10000ULL;
+	};
+
+	/**
+	 * \brief Lets BasicCommandAllocatorPool hand out null command allocators, so the allocator recycling of the renderer can be driven
+	 * by null queues and fences.
+	 */
+	struct NullCommandAllocatorTraits
+	{
+		using DeviceType = NullDevice const;
+		using ListType = NullCommandListType;
+		using AllocatorType = std::shared_ptr<NullCommandAllocator>;
+
+		static AllocatorType Create(NullDevice const* pDevice, NullCommandListType Type, std::size_t)
+		{
+			return pDevice->CreateCommandAllocator(Type);
+		}
+		static void Reset(AllocatorType const& Allocator) { Allocator->Reset(); }
+	};
+
+	using NullCommandAllocatorPool = BasicCommandAllocatorPool<NullCommandAllocatorTraits>;
+}
@@ -0,0 +1,124 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <vector>
+
+#include "realsim/core/Assert.h"
+#include "realsim/core/Logger.h"
+
+namespace RSim::Graphics
+{
+	/**
+	 * \brief A pool allocator for fixed size blocks(e.g. 256-byte constant buffers). Blocks are grouped into slabs and every slab
+	 * keeps a bitset of its free blocks, so allocating and freeing a block is a bit scan instead of the map lookups FreeListAllocator does.
+	 * The pool grows by adding slabs; offsets are laid out as if the slabs were contiguous(SlabIndex * SlabSize + OffsetInSlab) so the
+	 * owner can map each slab to its own resource or heap.
+	 */
+	class PoolAllocator
+	{
+	public:
+		using OffsetType = std::size_t;
+
+		struct Allocation
+		{
+			Allocation(OffsetType Offset, OffsetType Size) : Offset{ Offset }, Size{ Size } {}
+			OffsetType Offset;
+			OffsetType Size;
+
+			static Allocation InvalidAllocation() { return Allocation{ InvalidOffset(), 0ULL }; }
+
+			[[nodiscard]] bool IsValid() const { return Offset != InvalidOffset(); }
+		};
+	private:
+		struct Slab
+		{
+			std::vector<uint64_t> FreeMask{};
+			OffsetType NumFreeBlocks = 0;
+			/**
+			 * \brief Index of the lowest mask word that may contain a free block.
+			 */
+			std::size_t FirstFreeWord = 0;
+			bool InFreeList = false;
+		};
+
+		static constexpr std::size_t BitsPerWord = 64;
+	public:
+		/**
+		 * \param BlockSize Size of a single block.
+		 * \param BlocksPerSlab Number of blocks each slab holds.
+		 * \param MaxSlabs Maximum number of slabs the pool can grow to.
+		 */
+		PoolAllocator(OffsetType BlockSize, OffsetType BlocksPerSlab, std::size_t MaxSlabs = std::numeric_limits<std::size_t>::max());
+		PoolAllocator(PoolAllocator const&) = delete;
+		PoolAllocator& operator=(PoolAllocator const&) = delete;
+		PoolAllocator(PoolAllocator&& rhs) noexcept;
+		PoolAllocator& operator=(PoolAllocator&& rhs) noexcept;
+		virtual ~PoolAllocator();
+
+		/**
+		 * \brief Allocates a single block, adding a new slab if all of the current slabs are full.
+		 * \return An invalid allocation if the pool is at MaxSlabs and full.
+		 */
+		[[nodiscard]] Allocation Allocate();
+		void Free(OffsetType Offset);
+		void Free(Allocation& allocation);
+
+		[[nodiscard]] OffsetType GetBlockSize() const { return m_BlockSize; }
+		[[nodiscard]] OffsetType GetBlocksPerSlab() const { return m_BlocksPerSlab; }
+		[[nodiscard]] OffsetType GetSlabSize() const { return m_BlockSize * m_BlocksPerSlab; }
+		[[nodiscard]] std::size_t GetNumSlabs() const { return m_Slabs.size(); }
+		[[nodiscard]] OffsetType GetNumAllocatedBlocks() const { return m_NumAllocatedBlocks; }
+		[[nodiscard]] bool IsEmpty() const { return m_NumAllocatedBlocks == 0; }
+
+		[[nodiscard]] std::size_t GetSlabIndex(OffsetType Offset) const { return Offset / GetSlabSize(); }
+		[[nodiscard]] OffsetType GetOffsetInSlab(OffsetType Offset) const { return Offset % GetSlabSize(); }
+
+		[[nodiscard]] static constexpr OffsetType InvalidOffset() { return std::numeric_limits<OffsetType>::max(); }
+	private:
+		/**
+		 * \brief Adds a new slab with all of its blocks free and puts it in the free list.
+		 * \return Index of the new slab.
+		 */
+		std::size_t AddSlab();
+	protected:
+		std::vector<Slab> m_Slabs{};
+		/**
+		 * \brief Indices of the slabs that have at least one free block. Used as a stack so the most recently freed slab is reused first.
+		 */
+		std::vector<std::size_t> m_SlabsWithFreeBlocks{};
+		OffsetType m_BlockSize = 0;
+		OffsetType m_BlocksPerSlab = 0;
+		std::size_t m_MaxSlabs = 0;
+		OffsetType m_NumAllocatedBlocks = 0;
+	};
+
+	class PoolGPUAllocator : public PoolAllocator
+	{
+	private:
+		struct StaleAllocation
+		{
+			OffsetType Offset;
+			uint64_t FenceValue;
+
+			StaleAllocation(OffsetType _Offset, uint64_t _FenceValue) : Offset(_Offset), FenceValue(_FenceValue) {}
+		};
+
+	public:
+		PoolGPUAllocator(OffsetType BlockSize, OffsetType BlocksPerSlab, std::size_t MaxSlabs = std::numeric_limits<std::size_t>::max());
+		PoolGPUAllocator(PoolGPUAllocator&& rhs) noexcept;
+		PoolGPUAllocator& operator=(PoolGPUAllocator&& rhs) noexcept;
+		PoolGPUAllocator(PoolGPUAllocator const&) = delete;
+		PoolGPUAllocator& operator=(PoolGPUAllocator const&) = delete;
+		~PoolGPUAllocator() override;
+
+		void Free(OffsetType Offset, uint64_t FenceValue);
+		void Free(PoolAllocator::Allocation& allocation, uint64_t FenceValue);
+
+		void ReleaseStaleAllocations(uint64_t LastCompletedFenceValue);
+
+		[[nodiscard]] std::size_t GetNumStaleAllocations() const { return m_StaleAllocations.size(); }
+	private:
+		std::deque<StaleAllocation> m_StaleAllocations{};
+	};
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "realsim/core/RadixSort.h"
+
+namespace RSim::Core
+{
+	class ThreadPool;
+}
+
+namespace RSim::Graphics
+{
+	enum class RenderPass : uint8_t
+	{
+		Opaque = 0,
+		Transparent = 1
+	};
+
+	/**
+	 * \brief Everything needed to record one (instanced) draw. The IDs index the renderer's pipeline state, root signature, material
+	 * and mesh tables.
+	 */
+	struct DrawPacket
+	{
+		uint32_t PipelineID = 0;
+		uint32_t RootSignatureID = 0;
+		uint32_t MaterialID = 0;
+		uint32_t MeshID = 0;
+		uint32_t FirstInstance = 0;
+		uint32_t NumInstances = 1;
+	};
+
+	/**
+	 * \brief The draw packets of a frame, sorted by a 64-bit key so that packets sharing state end up next to each other.
+	 * Opaque packets are ordered by pipeline state, root signature, material, mesh and finally front-to-back depth:
+	 *
+	 *	63      60 59           48 47       40 39           28 27           16 15            0
+	 *	[ pass   ][ pipeline      ][ root sig ][ material     ][ mesh         ][ depth        ]
+	 *
+	 * Transparent packets have to be blended back-to-front, so depth (inverted) comes right after the pass and the state fields follow.
+	 * Submit() is not thread-safe, Sort() uses the thread pool it is given.
+	 */
+	class RenderQueue
+	{
+	public:
+		static constexpr uint32_t PassBits = 4;
+		static constexpr uint32_t PipelineBits = 12;
+		static constexpr uint32_t RootSignatureBits = 8;
+		static constexpr uint32_t MaterialBits = 12;
+		static constexpr uint32_t MeshBits = 12;
+		static constexpr uint32_t DepthBits = 16;
+		static_assert(PassBits + PipelineBits + RootSignatureBits + MaterialBits + MeshBits + DepthBits == 64);
+
+		/**
+		 * \brief The packet's IDs have to fit into their fields, which is asserted.
+		 * \param NormalizedDepth View depth mapped to [0, 1], values outside are clamped. NaN is asserted against and sorts as 0.
+		 */
+		[[nodiscard]] static uint64_t MakeSortKey(RenderPass Pass, DrawPacket const& Packet, float NormalizedDepth);
+
+		void Clear();
+		void Submit(RenderPass Pass, DrawPacket const& Packet, float NormalizedDepth = 0.0f);
+		void Sort(Core::ThreadPool* pPool);
+
+		[[nodiscard]] std::size_t GetNumPackets() const { return m_Packets.size(); }
+		/**
+		 * \brief The packet at the given position in sort order, only valid after Sort().
+		 */
+		[[nodiscard]] DrawPacket const& GetSortedPacket(std::size_t SortedIndex) const { return m_Packets[m_SortEntries[SortedIndex].Value]; }
+		[[nodiscard]] uint64_t GetSortedKey(std::size_t SortedIndex) const { return m_SortEntries[SortedIndex].Key; }
+	private:
+		std::vector<DrawPacket> m_Packets;
+		std::vector<Core::RadixSortEntry> m_SortEntries;
+		std::vector<Core::RadixSortEntry> m_ScratchEntries;
+	};
+}
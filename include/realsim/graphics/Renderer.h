@@ -7,6 +7,7 @@
 
 #include "realsim/core/Window.h"
 #include "realsim/core/Logger.h"
+#include "realsim/core/ThreadPool.h"
 
 #include "realsim/graphics/GraphicsDevice.h"
 #include "realsim/graphics/SwapChain.h"
@@ -14,7 +15,16 @@
 #include "realsim/graphics/MemoryAllocation.h"
 #include "realsim/graphics/RendererConfiguration.h"
 #include "realsim/graphics/CommandAllocator.h"
+#include "realsim/graphics/CommandContext.h"
 #include "realsim/graphics/CommandQueue.h"
+#include "realsim/graphics/FramePacer.h"
+#include "realsim/graphics/InstanceBatcher.h"
+#include "realsim/graphics/IndirectDraw.h"
+#include "realsim/graphics/FrustumCulling.h"
+#include "realsim/graphics/ViewSetup.h"
+#include "realsim/graphics/BindlessDescriptorHeap.h"
+#include "realsim/graphics/CPUDescriptorAllocator.h"
+#include "realsim/graphics/RenderQueue.h"
 #include "realsim/graphics/RootSignature.h"
 #include "realsim/graphics/GraphicsResource.h"
 #include "realsim/graphics/UploadBuffer.h"
@@ -31,15 +41,119 @@ namespace RSim::Graphics
 	class Renderer
 	{
 	public:
-		Renderer(Core::Window const* outputWindow);
+		/**
+		 * \param threadPool Workers the draws are culled, batched and recorded on. Not owned: the application shares one pool between the
+		 * renderer and the scene's systems, which never run at the same time as Render(), so the two do not oversubscribe the CPU.
+		 */
+		Renderer(Core::Window const* outputWindow, Core::ThreadPool& threadPool, FramePacingDesc const& framePacing = {});
+		~Renderer();
 
-		void Clear(FLOAT const color[]) const;
-		void Render(ECS::Scene & Scene) const;
+		/**
+		 * \brief Waits until the frame latency allows a new frame to be recorded. Call it once per frame before Clear().
+		 */
+		void BeginFrame();
+		void Clear(FLOAT const color[]);
+		/**
+		 * \brief Records the draws of the scene for the primary camera and every active camera, each into its own viewport. The views
+		 * are set up once per frame by a ViewSetup and their constants uploaded to this frame's view constant buffer, so the draws only
+		 * carry their world matrices. Entities whose bounds are outside of a camera's frustum are culled for it. Visible entities
+		 * that share a mesh and a material are drawn with a single instanced draw, their transforms and colors are written into this
+		 * frame's instance buffer on the worker threads. The draws are split into contiguous ranges and each range is recorded into its
+		 * own pooled command list; the lists are submitted in order in Present().
+		 * With GPU-driven rendering enabled the culling and batching of the draws is left to the GPU instead, see RenderGPUDriven().
+		 */
+		void Render(ECS::Scene & Scene);
 		void Present();
 		void Resize(uint32_t width, uint32_t height);
+
+		void SetFramePacing(FramePacingDesc const& desc) { m_FramePacer->SetDesc(desc); }
+		[[nodiscard]] FramePacingDesc const& GetFramePacing() const { return m_FramePacer->GetDesc(); }
+		[[nodiscard]] FramePacingStatistics const& GetFramePacingStatistics() const { return m_FramePacer->GetStatistics(); }
+
+		/**
+		 * \brief Opts in to culling on the compute queue and drawing with ExecuteIndirect, off by default.
+		 */
+		void SetGPUDrivenRendering(bool Enable) { m_GPUDrivenRendering = Enable; }
+		[[nodiscard]] bool IsGPUDrivenRendering() const { return m_GPUDrivenRendering; }
+
+		/**
+		 * \brief The heaps bindless materials index into. They are bound to every recording context; free descriptors with the
+		 * graphics queue's next fence value, they are reused once the frame has completed.
+		 */
+		[[nodiscard]] BindlessDescriptorHeap& GetBindlessResourceHeap() const { return *m_BindlessResourceHeap; }
+		[[nodiscard]] BindlessDescriptorHeap& GetBindlessSamplerHeap() const { return *m_BindlessSamplerHeap; }
 	private:
 		void InitVariables();
 		void InitRenderingVar();
+		void InitGPUDrivenRendering();
+
+	private:
+		/**
+		 * \brief Requests a context from the graphics queue for a recording task and records the state shared by every draw in it,
+		 * including the view's viewport. Safe to call from the recording tasks as long as each uses its own ContextIndex.
+		 */
+		ID3D12GraphicsCommandList2* BeginRecordingContext(std::size_t ContextIndex, RenderView const& View);
+
+		/**
+		 * \brief The GPU-driven path of Render(). The CPU writes the data of every drawn entity and the per-group command template into
+		 * this frame's upload buffer; a compute list on the compute queue resets the commands from the template, culls the instances
+		 * of every view against its frustum and compacts the commands of the groups that have visible instances. The graphics queue waits
+		 * for it and every view is drawn with a single ExecuteIndirect whose command count is read from the count buffer, so the
+		 * commands recorded on the CPU do not depend on the number of instances or groups.
+		 */
+		void RenderGPUDriven(entt::registry& Registry);
+
+		/**
+		 * \brief Records the sorted packets [Begin, End) of the render queue, binding pipeline states, root signatures and meshes only
+		 * when they differ from the previous packet's.
+		 */
+		void RecordDrawPackets(ID3D12GraphicsCommandList2* gfxCmdList, std::size_t Begin, std::size_t End,
+			D3D12_GPU_VIRTUAL_ADDRESS viewConstantsAddress, D3D12_GPU_VIRTUAL_ADDRESS instanceBufferAddress) const;
+
+		/**
+		 * \brief Returns the current frame's buffer out of Buffers, grown to hold at least RequiredSize bytes. The buffers are indexed
+		 * by the back buffer index; the frame pacer never lets the CPU get more than NumFramesInFlight frames ahead, so the GPU is done
+		 * with the returned buffer.
+		 */
+		UploadBuffer& RequestFrameBuffer(std::array<std::unique_ptr<UploadBuffer>, NumFramesInFlight>& Buffers, std::size_t RequiredSize,
+			std::wstring const& Name);
+		/**
+		 * \brief RequestFrameBuffer() for buffers in the default heap that the GPU writes through unordered access views. They are
+		 * created in the common state and, being buffers, decay back to it after every ExecuteCommandLists.
+		 */
+		MemoryAllocation& RequestFrameGPUBuffer(std::array<std::unique_ptr<MemoryAllocation>, NumFramesInFlight>& Buffers,
+			std::size_t RequiredSize, LPCWSTR Name);
+
+		/**
+		 * \brief Size of the bindless heaps, the sampler heap is at the D3D12 limit for shader-visible sampler heaps.
+		 */
+		static constexpr uint32_t NumBindlessResourceDescriptors = 65536;
+		static constexpr uint32_t NumBindlessSamplerDescriptors = 2048;
+		/**
+		 * \brief Part of the bindless heaps used for the descriptors of a single frame.
+		 */
+		static constexpr uint32_t NumDynamicResourceDescriptors = 16384;
+		static constexpr uint32_t NumDynamicSamplerDescriptors = 512;
+		/**
+		 * \brief Page sizes of the CPU descriptor heaps.
+		 */
+		static constexpr uint32_t RTVDescriptorsPerPage = 64;
+		static constexpr uint32_t DSVDescriptorsPerPage = 16;
+
+		/**
+		 * \brief Minimum number of draws a recording task is given, below this the cost of an extra command list outweighs the parallelism.
+		 */
+		static constexpr std::size_t MinDrawsPerRecordingTask = 256;
+		/**
+		 * \brief Minimum number of instances whose data a task writes into the instance buffer.
+		 */
+		static constexpr std::size_t MinInstancesPerTask = 1024;
+
+		/**
+		 * \brief The quad in m_VB/m_IB is the only mesh and the instanced pipeline the only material for now.
+		 */
+		static constexpr uint32_t BoxMeshID = 0;
+		static constexpr uint32_t DefaultMaterialID = 0;
 
 	private:
 		void ClearDepthStencilView(D3D12_CLEAR_FLAGS flags, FLOAT depth) const;
@@ -82,26 +196,101 @@ namespace RSim::Graphics
 		std::unique_ptr<SwapChain> m_SwapChain{};
 		std::unique_ptr<MemoryAllocator> m_MemAllocator{};
 
-		std::unique_ptr<CommandAllocatorPool> m_CmdAllocatorPool{};
 		std::unique_ptr<CommandListController> m_CmdListController{};
+		/**
+		 * \brief Created with the swap chain in the constructor, which throws without a window, so it is never null.
+		 */
+		std::unique_ptr<FramePacer> m_FramePacer{};
 
 		Microsoft::WRL::ComPtr<ID3D12CommandQueue> m_CmdQueue;
-		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList2> m_CmdList;
-		Microsoft::WRL::ComPtr<ID3D12CommandAllocator> m_CmdAllocators[NumFramesInFlight];
-		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_RTVDescriptorHeap;
-		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_DSVDescriptorHeap;
+		/**
+		 * \brief The context the back buffer transition and clears are recorded into, submitted first every frame.
+		 */
+		CommandContext m_MainContext{};
+
+		Core::ThreadPool* m_ThreadPool{nullptr};
+		std::vector<CommandContext> m_RecordingContexts{};
+		/**
+		 * \brief Number of recording contexts used in the current frame, they are submitted after m_MainContext.
+		 */
+		std::size_t m_NumActiveRecordingContexts{0};
+		std::vector<entt::entity> m_DrawEntities{};
+		/**
+		 * \brief World matrices and world-space bounds of m_DrawEntities, same order.
+		 */
+		std::vector<DirectX::XMFLOAT4X4> m_WorldMatrices{};
+		BoundingBoxes m_DrawBounds{};
+		ViewSetup m_ViewSetup{};
+		/**
+		 * \brief One culler per view, same order as the ViewSetup's views.
+		 */
+		std::vector<FrustumCuller> m_ViewCullers{};
+		std::vector<InstanceGroupKey> m_DrawKeys{};
+		InstanceBatcher m_InstanceBatcher{};
+		std::array<std::unique_ptr<UploadBuffer>, NumFramesInFlight> m_InstanceBuffers{};
+		std::array<std::unique_ptr<UploadBuffer>, NumFramesInFlight> m_ViewConstantBuffers{};
+		RenderQueue m_RenderQueue{};
+
+		bool m_GPUDrivenRendering{ false };
+		IndirectDrawBuilder m_IndirectDrawBuilder{};
+		/**
+		 * \brief Meshes of the GPU-driven path, indexed by mesh ID like m_Meshes.
+		 */
+		std::vector<IndirectMesh> m_IndirectMeshes{};
+		std::array<std::unique_ptr<UploadBuffer>, NumFramesInFlight> m_IndirectUploadBuffers{};
+		std::array<std::unique_ptr<MemoryAllocation>, NumFramesInFlight> m_GroupCommandBuffers{};
+		std::array<std::unique_ptr<MemoryAllocation>, NumFramesInFlight> m_IndirectCommandBuffers{};
+		std::array<std::unique_ptr<MemoryAllocation>, NumFramesInFlight> m_VisibleInstanceBuffers{};
+		std::array<std::unique_ptr<MemoryAllocation>, NumFramesInFlight> m_IndirectCountBuffers{};
+		std::unique_ptr<RootSignature> m_CullRootSignature{};
+		Microsoft::WRL::ComPtr<ID3D12PipelineState> m_CullInstancesPipelineState;
+		Microsoft::WRL::ComPtr<ID3D12PipelineState> m_CompactCommandsPipelineState;
+		std::unique_ptr<RootSignature> m_IndirectRootSignature{};
+		Microsoft::WRL::ComPtr<ID3D12PipelineState> m_IndirectPipelineState;
+		Microsoft::WRL::ComPtr<ID3D12CommandSignature> m_IndirectCommandSignature;
+
+		struct MaterialBinding
+		{
+			uint32_t PipelineID;
+			uint32_t RootSignatureID;
+		};
+
+		struct MeshBinding
+		{
+			D3D12_VERTEX_BUFFER_VIEW VertexBufferView;
+			D3D12_INDEX_BUFFER_VIEW IndexBufferView;
+			UINT NumIndices;
+		};
+
+		/**
+		 * \brief Tables the IDs of draw packets index into.
+		 */
+		std::vector<ID3D12PipelineState*> m_PipelineStates{};
+		std::vector<ID3D12RootSignature*> m_RootSignatures{};
+		std::vector<MaterialBinding> m_Materials{};
+		std::vector<MeshBinding> m_Meshes{};
+		/**
+		 * \brief The command lists of the current frame in submission order, kept around to avoid reallocating every frame.
+		 */
+		std::vector<ID3D12CommandList*> m_SubmissionCmdLists{};
+		std::unique_ptr<CPUDescriptorAllocator> m_RTVAllocator{};
+		std::unique_ptr<CPUDescriptorAllocator> m_DSVAllocator{};
+		/**
+		 * \brief Render target views of the back buffers, one per back buffer, and the depth stencil view of the depth buffer.
+		 */
+		DescriptorAllocation m_BackBufferRTVs{};
+		DescriptorAllocation m_DepthBufferDSV{};
+		std::unique_ptr<BindlessDescriptorHeap> m_BindlessResourceHeap{};
+		std::unique_ptr<BindlessDescriptorHeap> m_BindlessSamplerHeap{};
 		UINT m_CurrentBackBufferIndex{0UL};
 		std::array<ID3D12Resource*, NumFramesInFlight> m_BackBuffers{nullptr};
 		std::unique_ptr<MemoryAllocation> m_DepthBuffer{};
 
 		Microsoft::WRL::ComPtr<ID3D12Fence> m_Fence;
 		HANDLE m_FenceEvent{INVALID_HANDLE_VALUE};
-		std::uint64_t m_FrameNumber{0ULL};
-		std::array<std::uint64_t, NumFramesInFlight> m_FrameFenceValues{};
 
 		DescriptorSize m_DescriptorSizes{};
 
-		D3D12_VIEWPORT m_Viewport{ CD3DX12_VIEWPORT(0.0f,0.0f,800,600) };
 		D3D12_RECT m_ScissorRect{ CD3DX12_RECT{0,0,LONG_MAX,LONG_MAX} };
 
 
@@ -113,9 +302,7 @@ namespace RSim::Graphics
 		std::unique_ptr<UploadBuffer> m_VertexBuffer{};
 		std::unique_ptr<UploadBuffer> m_IndexBuffer{};
 		std::unique_ptr<MemoryAllocation> m_IBResource{};
-		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList2> m_CopyCmdList;
 		Microsoft::WRL::ComPtr<ID3D12PipelineState> m_PipelineState;
-		Microsoft::WRL::ComPtr<ID3D12CommandAllocator> m_CopyCmdAllocator;
 
 		std::array<DirectX::XMFLOAT3, 4> vertices = { { {0.5f,-0.5f,0.0f},{0.5f,0.5f,0.0f},{-0.5f,0.5f,0.0f},{-0.5f,-0.5f,0.0f} } };
 		std::array<uint32_t, 6> indices = { 0,1,2,0,2,3 };
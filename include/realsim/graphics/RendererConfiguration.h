@@ -5,4 +5,30 @@
 namespace RSim::Graphics
 {
 	static constexpr size_t NumFramesInFlight = 3ULL;
+
+	enum class PresentMode : uint8_t
+	{
+		/**
+		 * \brief Present on vertical blank.
+		 */
+		VSync,
+		/**
+		 * \brief Present immediately, frames that are not displayed before the next one is ready are discarded by the flip model.
+		 */
+		Uncapped,
+		/**
+		 * \brief Present immediately and allow tearing. Falls back to Uncapped if the display does not support tearing.
+		 */
+		Tearing
+	};
+
+	struct FramePacingDesc
+	{
+		PresentMode Mode = PresentMode::VSync;
+		/**
+		 * \brief Number of frames the CPU is allowed to get ahead of the display, clamped to [1, NumFramesInFlight].
+		 * Lower values reduce input latency, higher values let the CPU and the GPU overlap more.
+		 */
+		uint32_t MaxFrameLatency = 2;
+	};
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <filesystem>
 #include <cstdint>
 #include <optional>
+#include <vector>
 
 #include "realsim/core/Logger.h"
 
@@ -51,6 +52,13 @@ namespace RSim::Graphics
 
         static std::optional<std::pair<int32_t, int32_t>> ValidateShaderRegisterAndRegisterSpace(YAML::Node const& node, std::string_view parameterName);
 
+        /**
+         * \brief Checks what D3D12 would reject when the root signature is created, with a message naming the table: samplers mixed with
+         * other descriptors, a range appended after an unbounded one and overlapping shader registers. Warns about unbounded ranges
+         * whose descriptors are not volatile.
+         */
+        static bool ValidateDescriptorRanges(std::vector<CD3DX12_DESCRIPTOR_RANGE1> const& ranges, std::string_view parameterName);
+
     private:
         D3D12_ROOT_SIGNATURE_FLAGS m_RootSignatureFlags;
         std::vector<RootParameter> m_RootParameters{};
@@ -37,6 +37,10 @@ namespace RSim::Graphics
 
 		[[nodiscard]] static ShaderCompilationParameters VertexShaderDefaults(LPCWSTR ShaderPath);
 		[[nodiscard]] static ShaderCompilationParameters PixelShaderDefaults(LPCWSTR ShaderPath);
+		/**
+		 * \brief A compute shader file can hold several kernels, EntryPoint selects the one to compile.
+		 */
+		[[nodiscard]] static ShaderCompilationParameters ComputeShaderDefaults(LPCWSTR ShaderPath, LPCSTR EntryPoint = "main");
 	};
 
 	class ShaderCompiler
@@ -27,12 +27,21 @@ namespace RSim::Graphics
 
         [[nodiscard]] UINT GetCurrentBackBufferIndex() const;
 
+        /**
+         * \brief Gets the back buffers and creates their render target views in NumFramesInFlight contiguous descriptors starting at FirstRTV.
+         */
         void CreateBackBuffersFromSwapChain(ID3D12Device* pDevice, 
             std::array<ID3D12Resource*, NumFramesInFlight>& pBackBufferResources,
-            ID3D12DescriptorHeap* pDescHeap) const;
+            D3D12_CPU_DESCRIPTOR_HANDLE FirstRTV) const;
 
         void Present(UINT syncInterval, UINT presentFlags) const;
 
+        /**
+         * \brief The handle is signaled when the swap chain is ready for a new frame. Owned by the caller, who has to close it.
+         */
+        [[nodiscard]] HANDLE GetFrameLatencyWaitableObject() const;
+        void SetMaximumFrameLatency(UINT maxLatency) const;
+
     private:
         Microsoft::WRL::ComPtr<IDXGISwapChain1> m_DXGISwapChain;
         GraphicsDevice const& m_Device;
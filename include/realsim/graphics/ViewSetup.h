@@ -0,0 +1,96 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include <DirectXMath.h>
+#include <entt/entt.hpp>
+
+#include "realsim/graphics/FrustumCulling.h"
+#include "realsim/math/Alignment.h"
+
+namespace RSim::Graphics
+{
+	/**
+	 * \brief Per-view constants read by the shaders from a constant buffer, the layout has to match ViewConstants in
+	 * Shaders/instanced.vsh. Row-major, row-vector matrices as produced by DirectXMath.
+	 */
+	struct ViewConstants
+	{
+		DirectX::XMFLOAT4X4 View;
+		DirectX::XMFLOAT4X4 Projection;
+		DirectX::XMFLOAT4X4 ViewProjection;
+		DirectX::XMFLOAT4 CameraPosition;
+	};
+
+	/**
+	 * \brief A camera prepared for rendering: its constants, its world-space frustum and the rectangle of the output it renders into, in
+	 * pixels.
+	 */
+	struct RenderView
+	{
+		entt::entity Camera{ entt::null };
+		ViewConstants Constants{};
+		Frustum ViewFrustum{};
+		float ViewportX{ 0.0f };
+		float ViewportY{ 0.0f };
+		float ViewportWidth{ 0.0f };
+		float ViewportHeight{ 0.0f };
+	};
+
+	/**
+	 * \brief The per-frame view setup stage of the renderer. Build() computes the view, projection and frustum of every camera that is
+	 * rendered once per frame, so that per-draw work is left to the model matrix. The constants of all views are written into one constant
+	 * buffer, ConstantsStride bytes apart, which the draws of a view bind at the view's offset.
+	 * A view whose camera, projection parameters and viewport are the same as in the previous frame keeps its constants and frustum.
+	 */
+	class ViewSetup
+	{
+	public:
+		/**
+		 * \brief Constant buffer views have to start at multiples of D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT.
+		 */
+		static constexpr std::size_t ConstantsAlignment = 256;
+		static constexpr std::size_t ConstantsStride = Math::AlignUp(sizeof(ViewConstants), ConstantsAlignment);
+
+		/**
+		 * \brief Sets up a view for the primary camera, followed by one for every active camera, each in its own viewport of the output.
+		 * \return The number of views.
+		 */
+		std::size_t Build(entt::registry& Registry, float OutputWidth, float OutputHeight);
+
+		[[nodiscard]] std::vector<RenderView> const& GetViews() const { return m_Views; }
+		/**
+		 * \brief Number of views whose matrices and frustum had to be computed in the last Build(), the others were reused.
+		 */
+		[[nodiscard]] std::size_t GetNumRecomputedViews() const { return m_NumRecomputed; }
+
+		[[nodiscard]] std::size_t GetConstantsSize() const { return m_Views.size() * ConstantsStride; }
+		[[nodiscard]] static std::size_t GetConstantsOffset(std::size_t ViewIndex) { return ViewIndex * ConstantsStride; }
+		/**
+		 * \brief Writes the constants of every view at GetConstantsOffset(), pDestination must hold GetConstantsSize() bytes.
+		 */
+		void WriteConstants(void* pDestination) const;
+	private:
+		/**
+		 * \brief What the constants of a view were computed from.
+		 */
+		struct ViewInputs
+		{
+			DirectX::XMFLOAT4X4 ViewMatrix;
+			float FOVHalfAngle;
+			float NearZ;
+			float FarZ;
+			float ViewportX, ViewportY, ViewportWidth, ViewportHeight;
+
+			[[nodiscard]] bool operator==(ViewInputs const& Other) const;
+		};
+
+		void AddView(entt::registry& Registry, entt::entity Camera, float OutputWidth, float OutputHeight);
+	private:
+		std::vector<RenderView> m_Views;
+		std::vector<ViewInputs> m_Inputs;
+		std::vector<RenderView> m_PreviousViews;
+		std::vector<ViewInputs> m_PreviousInputs;
+		std::size_t m_NumRecomputed{ 0 };
+	};
+}
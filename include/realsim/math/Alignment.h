@@ -1,68 +1,62 @@
 #pragma once
 
 #include <DirectXMath.h>
-#include <intrin.h>
+#include <cstddef>
+#include <cstdint>
 
-#define INLINE __forceinline
+#include "realsim/math/Bits.h"
+
+#define INLINE RSIM_FORCEINLINE
 
 namespace Math
 {
-    template <typename T> __forceinline T AlignUpWithMask(T value, size_t mask)
+    template <typename T> constexpr RSIM_FORCEINLINE T AlignUpWithMask(T value, size_t mask)
     {
         return (T)(((size_t)value + mask) & ~mask);
     }
 
-    template <typename T> __forceinline T AlignDownWithMask(T value, size_t mask)
+    template <typename T> constexpr RSIM_FORCEINLINE T AlignDownWithMask(T value, size_t mask)
     {
         return (T)((size_t)value & ~mask);
     }
 
-    template <typename T> __forceinline T AlignUp(T value, size_t alignment)
+    /**
+     * \brief Rounds the value up to a multiple of the alignment, which must be a power of two.
+     */
+    template <typename T> constexpr RSIM_FORCEINLINE T AlignUp(T value, size_t alignment)
     {
         return AlignUpWithMask(value, alignment - 1);
     }
 
-    template <typename T> __forceinline T AlignDown(T value, size_t alignment)
+    /**
+     * \brief Rounds the value down to a multiple of the alignment, which must be a power of two.
+     */
+    template <typename T> constexpr RSIM_FORCEINLINE T AlignDown(T value, size_t alignment)
     {
         return AlignDownWithMask(value, alignment - 1);
     }
 
-    template <typename T> __forceinline bool IsAligned(T value, size_t alignment)
+    template <typename T> constexpr RSIM_FORCEINLINE bool IsAligned(T value, size_t alignment)
     {
         return 0 == ((size_t)value & (alignment - 1));
     }
 
-    template <typename T> __forceinline T DivideByMultiple(T value, size_t alignment)
+    template <typename T> constexpr RSIM_FORCEINLINE T DivideByMultiple(T value, size_t alignment)
     {
         return (T)((value + alignment - 1) / alignment);
     }
 
-    template <typename T> __forceinline bool IsPowerOfTwo(T value)
-    {
-        return 0 == (value & (value - 1));
-    }
-
-    template <typename T> __forceinline bool IsDivisible(T value, T divisor)
+    template <typename T> constexpr RSIM_FORCEINLINE bool IsDivisible(T value, T divisor)
     {
         return (value / divisor) * divisor == value;
     }
 
-    __forceinline uint8_t Log2(uint64_t value)
-    {
-        unsigned long mssb; // most significant set bit
-        unsigned long lssb; // least significant set bit
-
-        // If perfect power of two (only one set bit), return index of bit.  Otherwise round up
-        // fractional log by adding 1 to most signicant set bit's index.
-        if (_BitScanReverse64(&mssb, value) > 0 && _BitScanForward64(&lssb, value) > 0)
-            return uint8_t(mssb + (mssb == lssb ? 0 : 1));
-        else
-            return 0;
-    }
-
-    template <typename T> __forceinline T AlignPowerOfTwo(T value)
+    /**
+     * \brief The smallest power of two that is greater than or equal to the value, 0 for zero.
+     */
+    template <typename T> constexpr RSIM_FORCEINLINE T AlignPowerOfTwo(T value)
     {
-        return value == 0 ? 0 : 1 << Log2(value);
+        return value == 0 ? 0 : (T)NextPowerOfTwo((uint64_t)value);
     }
 
     using namespace DirectX;
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define RSIM_BITS_MSVC 1
+#endif
+
+#if defined(_MSC_VER)
+#define RSIM_FORCEINLINE __forceinline
+#else
+#define RSIM_FORCEINLINE inline __attribute__((always_inline))
+#endif
+
+/**
+ * \brief Bit utilities usable in constant expressions on every compiler. GCC and Clang use their builtins, MSVC uses its bit scan
+ * intrinsics at run time and portable loops in constant expressions.
+ */
+namespace Math
+{
+    /**
+     * \brief Number of zero bits below the least significant set bit, 64 for zero.
+     */
+    constexpr RSIM_FORCEINLINE uint32_t CountTrailingZeros(uint64_t value)
+    {
+        if (value == 0)
+            return 64;
+#if RSIM_BITS_MSVC
+        if (!__builtin_is_constant_evaluated())
+        {
+            unsigned long lssb = 0;
+            _BitScanForward64(&lssb, value);
+            return uint32_t(lssb);
+        }
+        uint32_t count = 0;
+        for (; (value & 1) == 0; value >>= 1)
+            ++count;
+        return count;
+#else
+        return uint32_t(__builtin_ctzll(value));
+#endif
+    }
+
+    /**
+     * \brief Number of zero bits above the most significant set bit, 64 for zero.
+     */
+    constexpr RSIM_FORCEINLINE uint32_t CountLeadingZeros(uint64_t value)
+    {
+        if (value == 0)
+            return 64;
+#if RSIM_BITS_MSVC
+        if (!__builtin_is_constant_evaluated())
+        {
+            unsigned long mssb = 0;
+            _BitScanReverse64(&mssb, value);
+            return 63 - uint32_t(mssb);
+        }
+        uint32_t count = 0;
+        for (; (value & (uint64_t(1) << 63)) == 0; value <<= 1)
+            ++count;
+        return count;
+#else
+        return uint32_t(__builtin_clzll(value));
+#endif
+    }
+
+    /**
+     * \brief Number of set bits.
+     */
+    constexpr RSIM_FORCEINLINE uint32_t PopCount(uint64_t value)
+    {
+#if RSIM_BITS_MSVC
+        // __popcnt64 needs a CPU with POPCNT, the SWAR count compiles to a handful of instructions everywhere
+        value = value - ((value >> 1) & 0x5555555555555555ULL);
+        value = (value & 0x3333333333333333ULL) + ((value >> 2) & 0x3333333333333333ULL);
+        value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        return uint32_t((value * 0x0101010101010101ULL) >> 56);
+#else
+        return uint32_t(__builtin_popcountll(value));
+#endif
+    }
+
+    /**
+     * \brief Whether the value has at most one bit set, so zero counts as a power of two.
+     */
+    template <typename T> constexpr RSIM_FORCEINLINE bool IsPowerOfTwo(T value)
+    {
+        return 0 == (value & (value - 1));
+    }
+
+    /**
+     * \brief floor(log2(value)), the index of the most significant set bit. The value must not be zero.
+     */
+    constexpr RSIM_FORCEINLINE uint8_t Log2Floor(uint64_t value)
+    {
+        return uint8_t(63 - CountLeadingZeros(value));
+    }
+
+    /**
+     * \brief ceil(log2(value)), 0 for zero and one.
+     */
+    constexpr RSIM_FORCEINLINE uint8_t Log2(uint64_t value)
+    {
+        return value <= 1 ? 0 : uint8_t(64 - CountLeadingZeros(value - 1));
+    }
+
+    /**
+     * \brief The smallest power of two that is greater than or equal to the value, 1 for zero. The value must not be greater than 2^63.
+     */
+    constexpr RSIM_FORCEINLINE uint64_t NextPowerOfTwo(uint64_t value)
+    {
+        return uint64_t(1) << Log2(value);
+    }
+}
@@ -0,0 +1,39 @@
+#include "realsim/core/LinearArena.h"
+
+#include <algorithm>
+
+namespace RSim::Core
+{
+	void* LinearArena::Allocate(std::size_t Size, std::size_t Alignment)
+	{
+		while (true)
+		{
+			if (m_CurrentBlock < m_Blocks.size())
+			{
+				Block const& block = m_Blocks[m_CurrentBlock];
+				std::size_t const alignedOffset = (m_Offset + Alignment - 1) & ~(Alignment - 1);
+				if (alignedOffset <= block.Size && Size <= block.Size - alignedOffset)
+				{
+					m_UsedSize += alignedOffset + Size - m_Offset;
+					m_Offset = alignedOffset + Size;
+					return block.Memory.get() + alignedOffset;
+				}
+
+				// Skip to the next block, a block that is too small for this allocation is used again after the next reset
+				++m_CurrentBlock;
+				m_Offset = 0;
+				continue;
+			}
+
+			std::size_t const blockSize = std::max(m_BlockSize, Size);
+			m_Blocks.push_back(Block{ std::make_unique<std::byte[]>(blockSize), blockSize });
+		}
+	}
+
+	void LinearArena::Reset()
+	{
+		m_CurrentBlock = 0;
+		m_Offset = 0;
+		m_UsedSize = 0;
+	}
+}
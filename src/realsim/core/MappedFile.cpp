@@ -0,0 +1,137 @@
+#include "realsim/core/MappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace RSim::Core
+{
+	MappedFile::MappedFile(MappedFile&& rhs) noexcept
+	{
+		*this = std::move(rhs);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& rhs) noexcept
+	{
+		if (this != &rhs)
+		{
+			Close();
+			m_pData = std::exchange(rhs.m_pData, nullptr);
+			m_Size = std::exchange(rhs.m_Size, 0);
+			m_IsOpen = std::exchange(rhs.m_IsOpen, false);
+#ifdef _WIN32
+			m_FileHandle = std::exchange(rhs.m_FileHandle, nullptr);
+			m_MappingHandle = std::exchange(rhs.m_MappingHandle, nullptr);
+#endif
+		}
+		return *this;
+	}
+
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+#ifdef _WIN32
+	bool MappedFile::Open(std::filesystem::path const& Path)
+	{
+		Close();
+
+		HANDLE const file = CreateFileW(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file, &size))
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		m_FileHandle = file;
+		m_Size = (std::size_t)size.QuadPart;
+		m_IsOpen = true;
+		// A mapping of an empty file cannot be created
+		if (m_Size == 0)
+			return true;
+
+		m_MappingHandle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (m_MappingHandle)
+			m_pData = static_cast<std::byte const*>(MapViewOfFile(m_MappingHandle, FILE_MAP_READ, 0, 0, 0));
+
+		if (!m_pData)
+		{
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (m_pData)
+			UnmapViewOfFile(m_pData);
+		if (m_MappingHandle)
+			CloseHandle(m_MappingHandle);
+		if (m_FileHandle)
+			CloseHandle(m_FileHandle);
+
+		m_pData = nullptr;
+		m_MappingHandle = nullptr;
+		m_FileHandle = nullptr;
+		m_Size = 0;
+		m_IsOpen = false;
+	}
+#else
+	bool MappedFile::Open(std::filesystem::path const& Path)
+	{
+		Close();
+
+		int const file = open(Path.c_str(), O_RDONLY);
+		if (file < 0)
+			return false;
+
+		struct stat status{};
+		if (fstat(file, &status) != 0)
+		{
+			close(file);
+			return false;
+		}
+
+		m_Size = (std::size_t)status.st_size;
+		if (m_Size != 0)
+		{
+			void* const pData = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, file, 0);
+			if (pData == MAP_FAILED)
+			{
+				close(file);
+				m_Size = 0;
+				return false;
+			}
+			m_pData = static_cast<std::byte const*>(pData);
+		}
+		// The mapping stays valid after the descriptor is closed
+		close(file);
+		m_IsOpen = true;
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (m_pData)
+			munmap(const_cast<std::byte*>(m_pData), m_Size);
+
+		m_pData = nullptr;
+		m_Size = 0;
+		m_IsOpen = false;
+	}
+#endif
+}
@@ -0,0 +1,116 @@
+#include "realsim/core/RadixSort.h"
+#include "realsim/core/ThreadPool.h"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+
+namespace RSim::Core
+{
+	namespace
+	{
+		constexpr std::size_t RadixBits = 8;
+		constexpr std::size_t NumBuckets = 1 << RadixBits;
+		constexpr std::size_t NumPasses = 64 / RadixBits;
+		/**
+		 * \brief Below this many entries per task, the per-task histograms cost more than the parallelism saves.
+		 */
+		constexpr std::size_t MinEntriesPerTask = 16384;
+
+		using Histogram = std::array<std::size_t, NumBuckets>;
+	}
+
+	void RadixSort(ThreadPool* pPool, RadixSortEntry* pEntries, RadixSortEntry* pScratch, std::size_t Count)
+	{
+		if (Count < 2)
+			return;
+
+		std::size_t const maxTasks = pPool ? pPool->GetMaxParallelism() : 1;
+		std::size_t const numTasks = std::clamp<std::size_t>(Count / MinEntriesPerTask, 1, maxTasks);
+
+		auto const taskRange = [=](std::size_t taskIndex)
+		{
+			return std::make_pair(Count * taskIndex / numTasks, Count * (taskIndex + 1) / numTasks);
+		};
+		// Every task always gets the same range, the scatter of a pass relies on it matching the range its histogram was built from.
+		auto const runTasks = [&](auto const& function)
+		{
+			if (numTasks == 1)
+			{
+				function(0);
+				return;
+			}
+			pPool->ParallelFor(numTasks, 1, [&](std::size_t Begin, std::size_t End, std::size_t)
+			{
+				for (std::size_t taskIndex = Begin; taskIndex < End; ++taskIndex)
+					function(taskIndex);
+			});
+		};
+
+		// Bits that differ from the first key anywhere in the array, a pass over a byte with none of them set would not move anything.
+		std::vector<uint64_t> taskVaryingBits(numTasks, 0);
+		runTasks([&](std::size_t taskIndex)
+		{
+			auto const [begin, end] = taskRange(taskIndex);
+			uint64_t varyingBits = 0;
+			for (std::size_t i = begin; i < end; ++i)
+				varyingBits |= pEntries[i].Key ^ pEntries[0].Key;
+			taskVaryingBits[taskIndex] = varyingBits;
+		});
+		uint64_t varyingBits = 0;
+		for (uint64_t const bits : taskVaryingBits)
+			varyingBits |= bits;
+
+		std::vector<Histogram> histograms(numTasks);
+		RadixSortEntry* pSource = pEntries;
+		RadixSortEntry* pDestination = pScratch;
+
+		for (std::size_t pass = 0; pass < NumPasses; ++pass)
+		{
+			std::size_t const shift = pass * RadixBits;
+			if (((varyingBits >> shift) & (NumBuckets - 1)) == 0)
+				continue;
+
+			runTasks([&](std::size_t taskIndex)
+			{
+				auto const [begin, end] = taskRange(taskIndex);
+				Histogram& histogram = histograms[taskIndex];
+				histogram.fill(0);
+				for (std::size_t i = begin; i < end; ++i)
+					++histogram[(pSource[i].Key >> shift) & (NumBuckets - 1)];
+			});
+
+			// Turn the counts into write offsets: bucket-major, then task-major so that the sort stays stable.
+			std::size_t offset = 0;
+			for (std::size_t bucket = 0; bucket < NumBuckets; ++bucket)
+			{
+				for (Histogram& histogram : histograms)
+				{
+					std::size_t const count = histogram[bucket];
+					histogram[bucket] = offset;
+					offset += count;
+				}
+			}
+
+			runTasks([&](std::size_t taskIndex)
+			{
+				auto const [begin, end] = taskRange(taskIndex);
+				Histogram& offsets = histograms[taskIndex];
+				for (std::size_t i = begin; i < end; ++i)
+					pDestination[offsets[(pSource[i].Key >> shift) & (NumBuckets - 1)]++] = pSource[i];
+			});
+
+			std::swap(pSource, pDestination);
+		}
+
+		if (pSource != pEntries)
+		{
+			runTasks([&](std::size_t taskIndex)
+			{
+				auto const [begin, end] = taskRange(taskIndex);
+				std::copy(pSource + begin, pSource + end, pEntries + begin);
+			});
+		}
+	}
+}
@@ -0,0 +1,209 @@
+#include "realsim/core/ThreadPool.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace RSim::Core
+{
+	namespace
+	{
+		/**
+		 * \brief The pool the calling thread is a worker of, and its index there.
+		 */
+		thread_local ThreadPool const* t_WorkerPool = nullptr;
+		thread_local std::size_t t_WorkerIndex = 0;
+
+		/**
+		 * \brief Runs a job the way a worker does, where an exception that escapes it terminates the program wherever the job ran.
+		 */
+		void RunJob(ThreadPool::Job const& Job) noexcept
+		{
+			Job();
+		}
+	}
+
+	ThreadPool::ThreadPool(std::size_t NumThreads)
+	{
+		m_Queues.reserve(NumThreads);
+		for (std::size_t i = 0; i < NumThreads; ++i)
+		{
+			m_Queues.push_back(std::make_unique<WorkerQueue>());
+		}
+		m_Workers.reserve(NumThreads);
+		for (std::size_t i = 0; i < NumThreads; ++i)
+		{
+			m_Workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard lock(m_Mutex);
+			m_Exit = true;
+		}
+		m_HasJobs.notify_all();
+		for (auto& worker : m_Workers)
+		{
+			worker.join();
+		}
+	}
+
+	void ThreadPool::Submit(Job job)
+	{
+		if (m_Workers.empty())
+		{
+			job();
+			return;
+		}
+
+		std::size_t const QueueIndex = t_WorkerPool == this ? t_WorkerIndex : m_NextQueue++ % m_Queues.size();
+		{
+			// Counted while the queue is still locked, so the count never covers a job that is not in a queue yet, and a worker that
+			// wakes up always finds one
+			std::lock_guard queueLock(m_Queues[QueueIndex]->Mutex);
+			m_Queues[QueueIndex]->Jobs.push_back(std::move(job));
+			std::lock_guard lock(m_Mutex);
+			++m_NumPendingJobs;
+		}
+		m_HasJobs.notify_one();
+	}
+
+	bool ThreadPool::TryPopJob(std::size_t QueueIndex, Job& job)
+	{
+		std::size_t const NumQueues = m_Queues.size();
+		for (std::size_t i = 0; i < NumQueues; ++i)
+		{
+			WorkerQueue& queue = *m_Queues[(QueueIndex + i) % NumQueues];
+			std::lock_guard queueLock(queue.Mutex);
+			if (queue.Jobs.empty())
+				continue;
+
+			// The owner takes its newest job, which is the most likely to still be in cache; thieves take the oldest
+			if (i == 0)
+			{
+				job = std::move(queue.Jobs.back());
+				queue.Jobs.pop_back();
+			}
+			else
+			{
+				job = std::move(queue.Jobs.front());
+				queue.Jobs.pop_front();
+			}
+
+			std::lock_guard lock(m_Mutex);
+			--m_NumPendingJobs;
+			return true;
+		}
+		return false;
+	}
+
+	bool ThreadPool::RunPendingJob()
+	{
+		if (m_Queues.empty())
+			return false;
+
+		Job job;
+		std::size_t const QueueIndex = t_WorkerPool == this ? t_WorkerIndex : m_NextQueue.load() % m_Queues.size();
+		if (!TryPopJob(QueueIndex, job))
+			return false;
+
+		RunJob(job);
+		return true;
+	}
+
+	std::size_t ThreadPool::ParallelFor(std::size_t Count, std::size_t MinItemsPerTask, RangeFunction const& Function)
+	{
+		if (Count == 0)
+			return 0;
+
+		MinItemsPerTask = std::max<std::size_t>(MinItemsPerTask, 1);
+		std::size_t const NumTasks = std::min(GetMaxParallelism(), (Count + MinItemsPerTask - 1) / MinItemsPerTask);
+		std::size_t const ItemsPerTask = Count / NumTasks;
+		std::size_t const Remainder = Count % NumTasks;
+
+		auto const TaskRange = [=](std::size_t TaskIndex)
+		{
+			// The first 'Remainder' tasks take one extra item.
+			std::size_t const Begin = TaskIndex * ItemsPerTask + std::min(TaskIndex, Remainder);
+			return std::make_pair(Begin, Begin + ItemsPerTask + (TaskIndex < Remainder ? 1 : 0));
+		};
+
+		// A task that throws must not take the others down with it: the first exception is kept, every task still runs to completion,
+		// and only then is the exception rethrown on the calling thread, whose stack the tasks reference.
+		std::exception_ptr FirstException;
+		std::mutex ExceptionMutex;
+		auto const CaptureException = [&]
+		{
+			std::lock_guard lock(ExceptionMutex);
+			if (!FirstException)
+				FirstException = std::current_exception();
+		};
+
+		std::atomic<std::size_t> NumRemaining{ NumTasks - 1 };
+		for (std::size_t TaskIndex = 1; TaskIndex < NumTasks; ++TaskIndex)
+		{
+			Submit([&, TaskIndex]
+			{
+				try
+				{
+					auto const [Begin, End] = TaskRange(TaskIndex);
+					Function(Begin, End, TaskIndex);
+				}
+				catch (...)
+				{
+					CaptureException();
+				}
+				NumRemaining.fetch_sub(1, std::memory_order_release);
+			});
+		}
+
+		// The calling thread takes the first range instead of idling.
+		try
+		{
+			auto const [Begin, End] = TaskRange(0);
+			Function(Begin, End, 0);
+		}
+		catch (...)
+		{
+			CaptureException();
+		}
+
+		// Then helps with whatever is queued, which may be this loop's remaining tasks or work they submitted. Only this loop's own
+		// tasks have their exceptions captured, by the tasks themselves, any other job has to keep to the no-throw contract of Submit().
+		while (NumRemaining.load(std::memory_order_acquire) != 0)
+		{
+			if (!RunPendingJob())
+				std::this_thread::yield();
+		}
+
+		if (FirstException)
+			std::rethrow_exception(FirstException);
+		return NumTasks;
+	}
+
+	std::size_t ThreadPool::DefaultNumThreads()
+	{
+		std::size_t const HardwareThreads = std::thread::hardware_concurrency();
+		return HardwareThreads > 1 ? HardwareThreads - 1 : 0;
+	}
+
+	void ThreadPool::WorkerLoop(std::size_t WorkerIndex)
+	{
+		t_WorkerPool = this;
+		t_WorkerIndex = WorkerIndex;
+		while (true)
+		{
+			{
+				std::unique_lock lock(m_Mutex);
+				m_HasJobs.wait(lock, [this] { return m_Exit || m_NumPendingJobs != 0; });
+				if (m_NumPendingJobs == 0)
+					return;
+			}
+
+			Job job;
+			if (TryPopJob(WorkerIndex, job))
+				RunJob(job);
+		}
+	}
+}
@@ -29,6 +29,8 @@ namespace RSim::Core
 		Application::LogLibraryVersion();
 		Application::RSIM_SetConsoleTitle("RealSim Interactive - Console");
 
+		// One pool for the whole frame, the scene update and the rendering take turns on it
+		m_ThreadPool = std::make_unique<ThreadPool>();
 		if (ReturnCode init = OnInit(); init != REALSIM_EXIT_SUCCESS)
 		{
 			rsim_error("Initialization has failed!");
@@ -37,6 +39,7 @@ namespace RSim::Core
 		SDL_Event e;
 
 		m_Scene = std::make_unique<ECS::Scene>();
+		m_Scene->SetThreadPool(m_ThreadPool.get());
 		m_Camera = m_Scene->CreateEntity();
 		m_Camera.SetName("Scene Primary Camera");
 		pCamera = &m_Camera.AddComponent<ECS::PerspectiveCameraComponent>(true);
@@ -58,9 +61,13 @@ namespace RSim::Core
 
 		while (m_Running)
 		{
+			// Wait before polling the input so that it is as fresh as possible when the frame is displayed.
+			m_Renderer->BeginFrame();
 			this->CalculateUpdateStatistics();
 
-			m_MainWindow->SetTitle(fmt::format("RealSim Interactive - FPS:{0:.2f}",m_UpdateStats.GetFramesPerSecond()));
+			auto const& pacingStats = m_Renderer->GetFramePacingStatistics();
+			m_MainWindow->SetTitle(fmt::format("RealSim Interactive - FPS:{0:.2f} CPU Busy:{1:.0f}% Frames In Flight:{2:.1f}",
+				m_UpdateStats.GetFramesPerSecond(), pacingStats.CPUBusyRatio * 100.0f, pacingStats.FramesInFlight));
 
 			while(SDL_PollEvent(&e) != 0)
 			{
@@ -68,6 +75,7 @@ namespace RSim::Core
 			}
 
 			this->OnUpdate();
+			m_Scene->Update(m_UpdateStats.GetFrameTimeSeconds());
 
 			FLOAT const color[] = { 0.2f / 2.0f,0.2f / 2.0f,0.2f / 2.0f,1.0f};
 			m_Renderer->Clear(color);
@@ -94,7 +102,7 @@ namespace RSim::Core
 
 	ReturnCode Application::OnInit()
 	{
-		m_Renderer = std::make_unique<GFX::Renderer>(m_MainWindow.get());
+		m_Renderer = std::make_unique<GFX::Renderer>(m_MainWindow.get(), *m_ThreadPool);
 		return REALSIM_EXIT_SUCCESS;
 	}
 
@@ -1,10 +1,28 @@
 #include "realsim/ecs/Entity.h"
 #include "realsim/ecs/Link.h"
 
+#include <cstddef>
+#include <initializer_list>
+
 #define FromEnTT(EnTTHandle) RSim::ECS::Entity{m_Scene, (EnTTHandle)}
 
 namespace RSim::ECS
 {
+    namespace
+    {
+        /**
+         * \brief Announces the links that are about to change, so that change tracking sees their previous values.
+         */
+        void WillModifyLinks(Scene& Scene, std::initializer_list<entt::entity> Entities)
+        {
+            for (entt::entity const entity : Entities)
+            {
+                if (entity != entt::null)
+                    Scene.WillModify<Link>(entity);
+            }
+        }
+    }
+
     Entity const Entity::Null = { nullptr,entt::null };
 
     Entity::Entity(Scene *pScene, entt::entity entity) : m_EntityHandle(entity), m_Scene(pScene)
@@ -25,14 +43,15 @@ namespace RSim::ECS
 
     Entity Entity::GetTopParent() const
     {
-        Link link = GetLink();
-        entt::entity Parent = link.Parent;
+        // Walks up until the entity without a parent, which is the top parent (or *this if it has no parent)
+        entt::entity Top = m_EntityHandle;
+        entt::entity Parent = GetLink().Parent;
         while(Parent != entt::null)
         {
-            link = m_Scene->GetComponent<Link>(Parent);
-            Parent = link.Parent;
+            Top = Parent;
+            Parent = m_Scene->GetComponent<Link>(Parent).Parent;
         }
-        return FromEnTT(Parent);
+        return FromEnTT(Top);
     }
 
     Entity Entity::GetNextSibling() const
@@ -62,48 +81,53 @@ namespace RSim::ECS
     Entity Entity::AddChild(Entity Child)
     {
         RSIM_ASSERTM(*this != Child, "An entity cannot be both its parent and child.");
+        if (Child.GetLink().Parent != entt::null)
+        {
+            // Re-parenting: detach from the current parent first
+            FromEnTT(Child.GetLink().Parent).RemoveChild(Child);
+        }
+
+        WillModifyLinks(*m_Scene, { Child, *this, GetLink().LastChild });
         Link& childLink = Child.GetComponent<Link>();
         Link& parentLink = GetComponent<Link>();
-        // Set the child's parent to this
+        // Set the child's parent to this, re-keying its name in the scene's name index
+        m_Scene->UnindexName(Child);
     	childLink.Parent = *this;
-        
-        if(parentLink.NumChildren == 0)
-        {
-            // The parent does not have any children until now, so set the first and last child to the added child
-            parentLink.FirstChild = Child;
-            parentLink.LastChild = Child;
-            // Since we'll only have one child, siblings do not exist
-            parentLink.PreviousSibling = entt::null;
-            parentLink.NextSibling = entt::null;
-            // Increase the # children and set the child index to zero
-            parentLink.NumChildren++;
+        m_Scene->IndexName(Child);
+        // The child's world transform now depends on this entity's
+        m_Scene->MarkTransformDirty(Child);
+        m_Scene->InvalidateHierarchyOrder();
+
+        // Append after the last child, LastChild makes this O(1) no matter how many children there are. The index follows the last child's
+        // or the child array's end rather than NumChildren, which removals may have left behind.
+        auto* pChildArray = m_Scene->TryGet<ChildArray>(*this);
+        childLink.PreviousSibling = parentLink.LastChild;
+        childLink.NextSibling = entt::null;
+        if (pChildArray)
+            childLink.ChildIndex = pChildArray->Children.size();
+        else if (parentLink.LastChild != entt::null)
+            childLink.ChildIndex = m_Scene->GetComponent<Link>(parentLink.LastChild).ChildIndex + 1;
+        else
             childLink.ChildIndex = 0;
+        if (parentLink.LastChild != entt::null)
+        {
+            m_Scene->GetComponent<Link>(parentLink.LastChild).NextSibling = Child;
         }
         else
         {
-        	entt::entity PreviousSibling{ parentLink.FirstChild};
-            do
-            {
-                RSIM_ASSERTM(PreviousSibling != Child, "The entity you are trying to link is already a child.");
-                PreviousSibling = m_Scene->GetComponent<Link>(PreviousSibling).NextSibling;
-            }
-            while (PreviousSibling != entt::null);
-            Link& PrevSiblingLink = m_Scene->GetComponent<Link>(PreviousSibling);
-            // Update the last child's next sibling to point to the added child
-        	PrevSiblingLink.NextSibling = Child;
-            // Set the added child's previous sibling as the last child
-            childLink.PreviousSibling = PreviousSibling;
-            // Since we are inserting at the end, next sibling is null
-        	childLink.NextSibling = entt::null;
-            // Increase the # of children
-        	parentLink.NumChildren++;
-            // Since we are inserting at the end, index is # children minus one
-            childLink.ChildIndex = parentLink.NumChildren - 1;
-            // Parent ---------------------------------------------------
-            //   |                      |                               |
-            //   |--> Child 0           |--> Child 1                    |--> Child to be added
-            //      Prev = null           Prev = Child 0                   Prev = Child 1
-            //      Next = Child 1        Next = Child to be added         Next = null
+            parentLink.FirstChild = Child;
+        }
+        parentLink.LastChild = Child;
+        ++parentLink.NumChildren;
+        // Parent ---------------------------------------------------
+        //   |                      |                               |
+        //   |--> Child 0           |--> Child 1                    |--> Child to be added
+        //      Prev = null           Prev = Child 0                   Prev = Child 1
+        //      Next = Child 1        Next = Child to be added         Next = null
+
+        if (pChildArray)
+        {
+            pChildArray->Children.push_back(Child);
         }
         return *this;
     }
@@ -116,73 +140,107 @@ namespace RSim::ECS
         RSIM_ASSERTM(*this != Child, "The child you are trying to remove is the entity itself.");
     	RSIM_ASSERTM(parentLink.NumChildren > 0, "The parent entity has no children.");
         RSIM_ASSERTM(childLink.Parent == *this,"The child you are trying to remove does not have the parent of *this.");
+        m_Scene->UnindexName(Child);
+        WillModifyLinks(*m_Scene, { *this, Child, childLink.PreviousSibling, childLink.NextSibling });
 
-        entt::entity prevSibling = childLink.PreviousSibling;
-        entt::entity nextSibling = childLink.NextSibling;
+        if (childLink.PreviousSibling != entt::null)
+            m_Scene->GetComponent<Link>(childLink.PreviousSibling).NextSibling = childLink.NextSibling;
+        else
+            parentLink.FirstChild = childLink.NextSibling;
 
-        // The child being removed is in the middle
-    	if(prevSibling != entt::null && nextSibling != entt::null)
-		{
-            Link& prevLink = m_Scene->GetComponent<Link>(prevSibling);
-            Link& nextLink = m_Scene->GetComponent<Link>(nextSibling);
-            prevLink.NextSibling = nextSibling;
-            nextLink.PreviousSibling = prevSibling;
-        }
-        // The child being removed is the last child
-        else if (prevSibling != entt::null && nextSibling == entt::null)
+        if (childLink.NextSibling != entt::null)
+            m_Scene->GetComponent<Link>(childLink.NextSibling).PreviousSibling = childLink.PreviousSibling;
+        else
+            parentLink.LastChild = childLink.PreviousSibling;
+
+        // Removing the last child leaves the indices dense. Otherwise the siblings after it keep their indices, and their places in the child
+        // array, until RenumberChildren() walks them all at once, instead of every removal walking them.
+        auto* pChildArray = m_Scene->TryGet<ChildArray>(*this);
+        if (childLink.NextSibling == entt::null && !parentLink.ChildIndicesStale)
         {
-            Link& prevLink = m_Scene->GetComponent<Link>(prevSibling);
-            prevLink.NextSibling = nextSibling;
-            parentLink.LastChild = entt::null;
+            if (pChildArray)
+                pChildArray->Children.pop_back();
         }
-        // The child being removed is the first and only child
-        else if (prevSibling == entt::null && nextSibling == entt::null)
+        else
         {
-            parentLink.FirstChild = entt::null;
+            if (pChildArray)
+                pChildArray->Children[childLink.ChildIndex] = entt::null;
+            parentLink.ChildIndicesStale = true;
         }
 
+        childLink.PreviousSibling = entt::null;
         childLink.NextSibling = entt::null;
-        childLink.FirstChild = entt::null;
         childLink.Parent = entt::null;
         childLink.ChildIndex = Link::InvalidChildIndex();
         --parentLink.NumChildren;
+        // The child is a root entity now
+        m_Scene->IndexName(Child);
+        m_Scene->MarkTransformDirty(Child);
+        m_Scene->InvalidateHierarchyOrder();
 
     	return *this;
     }
 
-    Entity Entity::GetChildAt(std::size_t Index)
+    void Entity::RenumberChildren()
     {
-        Link const& parentLink = GetLink();
-        RSIM_ASSERT(Index < parentLink.NumChildren);
-    	entt::entity PreviousSibling{ parentLink.FirstChild };
-        while (PreviousSibling != entt::null)
+        if (!GetLink().ChildIndicesStale)
+            return;
+
+        WillModifyLinks(*m_Scene, { *this });
+        Link& parentLink = GetComponent<Link>();
+        auto* pChildArray = m_Scene->TryGet<ChildArray>(*this);
+        // Children only move towards the front, so the array is compacted in place while walking. Only the links whose index changes are
+        // announced to change tracking.
+        std::size_t index = 0;
+        for (entt::entity child = parentLink.FirstChild; child != entt::null; child = m_Scene->GetComponent<Link>(child).NextSibling, ++index)
         {
-            Link& childLink = m_Scene->GetComponent<Link>(PreviousSibling);
-            if (childLink.ChildIndex == Index)
+            if (m_Scene->GetComponent<Link>(child).ChildIndex != index)
             {
-                return { m_Scene, PreviousSibling };
+                m_Scene->WillModify<Link>(child);
+                m_Scene->GetComponent<Link>(child).ChildIndex = index;
             }
-            PreviousSibling = childLink.NextSibling;
+            if (pChildArray)
+                pChildArray->Children[index] = child;
         }
-
-        return Entity::Null;
+        if (pChildArray)
+            pChildArray->Children.resize(index);
+        parentLink.ChildIndicesStale = false;
     }
 
-    Entity Entity::GetChildByName(std::string_view Name)
+    Entity Entity::GetChildAt(std::size_t Index)
     {
+        RenumberChildren();
         Link const& parentLink = GetLink();
-        entt::entity PreviousSibling{ parentLink.FirstChild };
-        while (PreviousSibling != entt::null)
+        RSIM_ASSERT(Index < parentLink.NumChildren);
+
+        if (auto const* pChildArray = m_Scene->TryGet<ChildArray>(*this))
         {
-            Link& childLink = m_Scene->GetComponent<Link>(PreviousSibling);
-            auto& childName = m_Scene->GetComponent<NameComponent>(PreviousSibling);
-            if (childName.Name == Name)
-            {
-                return { m_Scene, PreviousSibling };
-            }
-            PreviousSibling = childLink.NextSibling;
+            return FromEnTT(pChildArray->Children[Index]);
+        }
+
+        // The indices are dense, so walk from whichever end is closer
+        if (Index < parentLink.NumChildren / 2)
+        {
+            entt::entity child{ parentLink.FirstChild };
+            for (std::size_t i = 0; i < Index; ++i)
+                child = m_Scene->GetComponent<Link>(child).NextSibling;
+            return FromEnTT(child);
         }
-        return Entity::Null;
+
+        entt::entity child{ parentLink.LastChild };
+        for (std::size_t i = parentLink.NumChildren - 1; i > Index; --i)
+            child = m_Scene->GetComponent<Link>(child).PreviousSibling;
+        return FromEnTT(child);
+    }
+
+    Entity Entity::GetChildByName(std::string_view Name)
+    {
+        return m_Scene->FindChild(*this, Name);
+    }
+
+    Entity Entity::FindByPath(std::string_view Path)
+    {
+        return m_Scene->FindByPath(Path, *this);
     }
 
     void Entity::RemoveChildAt(std::size_t Index)
@@ -193,15 +251,45 @@ namespace RSim::ECS
 
     void Entity::TryRemoveChildAt(std::size_t Index)
     {
-        Entity const entity = GetChildAt(Index);
-        if(entity != Entity::Null)
+        if (Index < GetLink().NumChildren)
+        {
+            RemoveChild(GetChildAt(Index));
+        }
+    }
+
+    void Entity::EnableChildArray()
+    {
+        if (HasChildArray())
+            return;
+
+        // The children are stored at their indices, which have to be dense for that
+        RenumberChildren();
+        Link const& parentLink = GetLink();
+        ChildArray childArray{};
+        childArray.Children.reserve(parentLink.NumChildren);
+        for (entt::entity child = parentLink.FirstChild; child != entt::null; child = m_Scene->GetComponent<Link>(child).NextSibling)
         {
-            RemoveChild(entity);
+            childArray.Children.push_back(child);
         }
+        m_Scene->AddComponent<ChildArray>(*this, std::move(childArray));
+    }
+
+    void Entity::DisableChildArray()
+    {
+        if (HasChildArray())
+            m_Scene->RemoveComponent<ChildArray>(*this);
+    }
+
+    bool Entity::HasChildArray() const
+    {
+        return m_Scene->TryGet<ChildArray>(*this) != nullptr;
     }
 
     TransformComponent& Entity::GetLocalTransform()
     {
+        // The caller may modify the transform through the returned reference, so the world transform has to be recomputed.
+        m_Scene->WillModify<TransformComponent>(*this);
+        m_Scene->MarkTransformDirty(*this);
         return m_Scene->GetComponent<TransformComponent>(*this);
     }
 
@@ -221,8 +309,8 @@ namespace RSim::ECS
         return m_Scene->GetComponent<Link>(*this);
     }
 
-    void Entity::SetName(std::string Name) const
+    void Entity::SetName(std::string_view Name) const
     {
-        m_Scene->GetComponent<NameComponent>(*this).Name = Name;
+        m_Scene->SetName(*this, Name);
     }
 }
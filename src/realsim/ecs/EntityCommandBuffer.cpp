@@ -0,0 +1,106 @@
+#include "realsim/ecs/EntityCommandBuffer.h"
+#include "realsim/ecs/Scene.h"
+#include "realsim/ecs/Entity.h"
+
+namespace RSim::ECS
+{
+    EntityCommandBuffer::~EntityCommandBuffer()
+    {
+        Clear();
+    }
+
+    DeferredEntity EntityCommandBuffer::Create()
+    {
+        DeferredEntity const entity{ m_NumCreated++ };
+        m_Commands.push_back(Command{ CommandType::Create, MakeTarget(entity), nullptr, nullptr, nullptr });
+        return entity;
+    }
+
+    void EntityCommandBuffer::Destroy(entt::entity Entity)
+    {
+        m_Commands.push_back(Command{ CommandType::Destroy, MakeTarget(Entity), nullptr, nullptr, nullptr });
+    }
+
+    void EntityCommandBuffer::Destroy(DeferredEntity Entity)
+    {
+        m_Commands.push_back(Command{ CommandType::Destroy, MakeTarget(Entity), nullptr, nullptr, nullptr });
+    }
+
+    void EntityCommandBuffer::ReserveTasks(std::size_t NumTasks)
+    {
+        while (m_TaskBuffers.size() < NumTasks)
+        {
+            m_TaskBuffers.push_back(std::make_unique<EntityCommandBuffer>());
+        }
+    }
+
+    entt::entity EntityCommandBuffer::Resolve(CommandTarget const& Target) const
+    {
+        return Target.Deferred != InvalidDeferred ? m_Created[Target.Deferred] : Target.Entity;
+    }
+
+    void EntityCommandBuffer::Playback(Scene& Scene)
+    {
+        entt::registry& registry = Scene.GetEnTTRegistry();
+        m_Created.assign(m_NumCreated, entt::null);
+
+        for (Command& command : m_Commands)
+        {
+            if (command.Type == CommandType::Create)
+            {
+                m_Created[command.Target.Deferred] = Scene.CreateEntity();
+                continue;
+            }
+
+            // An earlier command, or another buffer played back before this one, may have destroyed the entity already
+            entt::entity const entity = Resolve(command.Target);
+            if (entity != entt::null && registry.valid(entity))
+            {
+                if (command.Type == CommandType::Destroy)
+                    Scene.Destroy(Scene.FromEnTT(entity));
+                else
+                    command.Apply(registry, entity, command.pPayload);
+            }
+
+            if (command.DestroyPayload)
+                command.DestroyPayload(command.pPayload);
+            command.DestroyPayload = nullptr;
+        }
+
+        m_Commands.clear();
+        m_Arena.Reset();
+        m_NumCreated = 0;
+
+        for (auto const& taskBuffer : m_TaskBuffers)
+        {
+            taskBuffer->Playback(Scene);
+        }
+    }
+
+    void EntityCommandBuffer::Clear()
+    {
+        for (Command const& command : m_Commands)
+        {
+            if (command.DestroyPayload)
+                command.DestroyPayload(command.pPayload);
+        }
+        m_Commands.clear();
+        m_Arena.Reset();
+        m_NumCreated = 0;
+
+        for (auto const& taskBuffer : m_TaskBuffers)
+        {
+            taskBuffer->Clear();
+        }
+    }
+
+    bool EntityCommandBuffer::IsEmpty() const
+    {
+        for (auto const& taskBuffer : m_TaskBuffers)
+        {
+            if (!taskBuffer->IsEmpty())
+                return false;
+        }
+        return m_Commands.empty();
+    }
+}
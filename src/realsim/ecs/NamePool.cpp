@@ -0,0 +1,35 @@
+#include "realsim/ecs/NamePool.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace RSim::ECS
+{
+    NameID NamePool::Intern(std::string_view Name)
+    {
+        if (auto const it = m_Lookup.find(Name); it != m_Lookup.end())
+            return it->second;
+
+        if (m_Blocks.empty() || Name.size() > BlockSize - m_BlockOffset)
+        {
+            m_Blocks.push_back(std::make_unique<char[]>(std::max(BlockSize, Name.size())));
+            m_BlockOffset = 0;
+        }
+        char* pCharacters = m_Blocks.back().get() + m_BlockOffset;
+        std::memcpy(pCharacters, Name.data(), Name.size());
+        // An oversized name fills its block completely, the next name starts a new one
+        m_BlockOffset = std::min(BlockSize, m_BlockOffset + Name.size());
+
+        auto const id = (NameID)m_Entries.size();
+        std::string_view const pooled{ pCharacters, Name.size() };
+        m_Entries.push_back(Entry{ pooled, Hash(Name) });
+        m_Lookup.emplace(pooled, id);
+        return id;
+    }
+
+    NameID NamePool::Find(std::string_view Name) const
+    {
+        auto const it = m_Lookup.find(Name);
+        return it != m_Lookup.end() ? it->second : InvalidNameID;
+    }
+}
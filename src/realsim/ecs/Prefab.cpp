@@ -0,0 +1,192 @@
+#include "realsim/ecs/Prefab.h"
+#include "realsim/ecs/Scene.h"
+#include "realsim/ecs/Entity.h"
+#include "realsim/ecs/Link.h"
+#include "realsim/ecs/PerspectiveCameraComponent.h"
+
+#include <unordered_map>
+
+namespace RSim::ECS
+{
+    Prefab::Prefab(Prefab const& Other) : m_Nodes(Other.m_Nodes)
+    {
+        m_Pools.reserve(Other.m_Pools.size());
+        for (auto const& pool : Other.m_Pools)
+        {
+            m_Pools.push_back(pool->Clone());
+        }
+    }
+
+    Prefab& Prefab::operator=(Prefab const& Other)
+    {
+        if (this != &Other)
+        {
+            Prefab copy{ Other };
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    Prefab Prefab::FromSubtree(Scene& Scene, entt::entity Root)
+    {
+        entt::registry& registry = Scene.GetEnTTRegistry();
+        Prefab prefab;
+
+        // Breadth-first, every parent becomes a node before its children, which are added in sibling order
+        std::vector<std::pair<entt::entity, uint32_t>> queue{ { Root, InvalidNode } };
+        for (std::size_t head = 0; head < queue.size(); ++head)
+        {
+            auto const [entity, parentNode] = queue[head];
+            auto const [pTransform, pName] = registry.try_get<TransformComponent, NameComponent>(entity);
+            uint32_t const node = prefab.AddEntity(pName ? pName->Name : NameComponent::DefaultName,
+                pTransform ? *pTransform : TransformComponent{}, parentNode);
+
+            if (registry.all_of<ChildArray>(entity))
+                prefab.EnableChildArray(node);
+            if (auto const* pBox = registry.try_get<BoxComponent>(entity))
+                prefab.AddComponent(node, *pBox);
+            if (auto const* pCamera = registry.try_get<PerspectiveCameraComponent>(entity))
+                prefab.AddComponent(node, *pCamera);
+
+            for (entt::entity child = registry.get<Link>(entity).GetFirstChild(); child != entt::null;
+                child = registry.get<Link>(child).GetNextSibling())
+            {
+                queue.emplace_back(child, node);
+            }
+        }
+        return prefab;
+    }
+
+    uint32_t Prefab::AddEntity(std::string_view Name, TransformComponent const& Transform, uint32_t Parent)
+    {
+        RSIM_ASSERTM(m_Nodes.empty() == (Parent == InvalidNode), "Only the first node of a prefab is its root.");
+        RSIM_ASSERTM(Parent == InvalidNode || Parent < m_Nodes.size(), "The parent node does not exist.");
+
+        uint32_t const index = (uint32_t)m_Nodes.size();
+        TemplateNode& node = m_Nodes.emplace_back();
+        node.Name = Name;
+        node.Transform = Transform;
+        node.Parent = Parent;
+        if (Parent != InvalidNode)
+        {
+            TemplateNode& parent = m_Nodes[Parent];
+            node.PreviousSibling = parent.LastChild;
+            node.ChildIndex = parent.NumChildren;
+            if (parent.LastChild != InvalidNode)
+                m_Nodes[parent.LastChild].NextSibling = index;
+            else
+                parent.FirstChild = index;
+            parent.LastChild = index;
+            ++parent.NumChildren;
+        }
+        return index;
+    }
+
+    void Prefab::EnableChildArray(uint32_t Node)
+    {
+        RSIM_ASSERTM(Node < m_Nodes.size(), "The prefab has no such node.");
+        m_Nodes[Node].HasChildArray = true;
+    }
+
+    void Prefab::Instantiate(Scene& Scene, std::size_t Count, std::vector<entt::entity>& OutEntities, entt::entity Parent) const
+    {
+        OutEntities.clear();
+        if (m_Nodes.empty() || Count == 0)
+            return;
+
+        entt::registry& registry = Scene.GetEnTTRegistry();
+        std::size_t const numNodes = m_Nodes.size();
+        OutEntities.resize(numNodes * Count);
+        registry.create(OutEntities.begin(), OutEntities.end());
+        entt::entity const* pRoots = OutEntities.data();
+
+        auto const toEntity = [&](uint32_t Node, std::size_t Copy)
+        {
+            return Node == InvalidNode ? entt::null : OutEntities[Node * Count + Copy];
+        };
+
+        // The roots are appended after the parent's current last child, at indices that follow NumChildren once removals are renumbered
+        if (Parent != entt::null)
+            Entity{ &Scene, Parent }.RenumberChildren();
+        entt::entity const previousLastChild = Parent != entt::null ? registry.get<Link>(Parent).GetLastChild() : entt::null;
+        std::size_t const firstChildIndex = Parent != entt::null ? registry.get<Link>(Parent).GetNumChildren() : 0;
+
+        std::vector<Link> links;
+        links.reserve(OutEntities.size());
+        for (std::size_t copy = 0; copy < Count; ++copy)
+        {
+            // Only children of the same parent are siblings, roots without a parent are not linked to each other
+            TemplateNode const& root = m_Nodes[0];
+            bool const hasParent = Parent != entt::null;
+            entt::entity const previousSibling = !hasParent ? entt::null : copy > 0 ? pRoots[copy - 1] : previousLastChild;
+            entt::entity const nextSibling = hasParent && copy + 1 < Count ? pRoots[copy + 1] : entt::null;
+            links.emplace_back(toEntity(root.FirstChild, copy), toEntity(root.LastChild, copy), previousSibling, nextSibling, Parent,
+                root.NumChildren, hasParent ? firstChildIndex + copy : Link::InvalidChildIndex());
+        }
+        for (uint32_t n = 1; n < numNodes; ++n)
+        {
+            TemplateNode const& node = m_Nodes[n];
+            for (std::size_t copy = 0; copy < Count; ++copy)
+            {
+                links.emplace_back(toEntity(node.FirstChild, copy), toEntity(node.LastChild, copy), toEntity(node.PreviousSibling, copy),
+                    toEntity(node.NextSibling, copy), toEntity(node.Parent, copy), node.NumChildren, node.ChildIndex);
+            }
+        }
+        registry.insert<Link>(OutEntities.begin(), OutEntities.end(), links.begin());
+
+        for (uint32_t n = 0; n < numNodes; ++n)
+        {
+            auto const copiesBegin = OutEntities.begin() + n * Count;
+            registry.insert<TransformComponent>(copiesBegin, copiesBegin + Count, m_Nodes[n].Transform);
+            registry.insert<NameComponent>(copiesBegin, copiesBegin + Count, Scene.InternName(m_Nodes[n].Name));
+        }
+        registry.insert<WorldTransformComponent>(OutEntities.begin(), OutEntities.end());
+        // Marking the roots is enough, the TransformSystem walks their subtrees
+        registry.insert<DirtyTransformTag>(OutEntities.begin(), OutEntities.begin() + Count);
+
+        for (auto const& pool : m_Pools)
+        {
+            pool->Instantiate(registry, OutEntities.data(), Count);
+        }
+
+        if (Parent != entt::null)
+        {
+            Scene.WillModify<Link>(Parent);
+            Link const& parentLink = registry.get<Link>(Parent);
+            registry.replace<Link>(Parent, previousLastChild != entt::null ? parentLink.GetFirstChild() : pRoots[0], pRoots[Count - 1],
+                parentLink.GetPreviousSibling(), parentLink.GetNextSibling(), parentLink.GetParent(), parentLink.GetNumChildren() + Count,
+                parentLink.GetChildIndex());
+            if (previousLastChild != entt::null)
+            {
+                Scene.WillModify<Link>(previousLastChild);
+                Link const& lastLink = registry.get<Link>(previousLastChild);
+                registry.replace<Link>(previousLastChild, lastLink.GetFirstChild(), lastLink.GetLastChild(), lastLink.GetPreviousSibling(),
+                    pRoots[0], lastLink.GetParent(), lastLink.GetNumChildren(), lastLink.GetChildIndex());
+            }
+
+            Entity parent{ &Scene, Parent };
+            if (parent.HasChildArray())
+            {
+                parent.DisableChildArray();
+                parent.EnableChildArray();
+            }
+        }
+
+        for (uint32_t n = 0; n < numNodes; ++n)
+        {
+            if (!m_Nodes[n].HasChildArray)
+                continue;
+            for (std::size_t copy = 0; copy < Count; ++copy)
+            {
+                Entity{ &Scene, toEntity(n, copy) }.EnableChildArray();
+            }
+        }
+
+        if (Scene.IsNameIndexEnabled())
+        {
+            for (entt::entity const entity : OutEntities)
+                Scene.IndexName(entity);
+        }
+        Scene.InvalidateHierarchyOrder();
+    }
+}
@@ -4,9 +4,18 @@
 
 namespace RSim::ECS
 {
+    namespace
+    {
+        std::size_t EntityIndex(entt::entity entity)
+        {
+            return entt::to_integral(entity) & entt::entt_traits<entt::entity>::entity_mask;
+        }
+    }
+
 	Scene::Scene()
 	{
         m_Registry.on_destroy<Link>().connect<&Scene::OnDestroyLink>(this);
+        m_Registry.on_destroy<NameComponent>().connect<&Scene::OnDestroyName>(this);
 	}
 
 	entt::registry& Scene::GetEnTTRegistry()
@@ -23,8 +32,11 @@ namespace RSim::ECS
     {
         Entity e{ this, m_Registry.create() };
         e.AddComponent<TransformComponent>();
+        e.AddComponent<WorldTransformComponent>();
         e.AddComponent<Link>();
-        e.AddComponent<NameComponent>();
+        SetName(e, NameComponent::DefaultName);
+        MarkTransformDirty(e);
+        InvalidateHierarchyOrder();
 
         return e;
     }
@@ -34,18 +46,267 @@ namespace RSim::ECS
         Entity e{ this, entity };
         // Will the compiler optimize these out? TODO: Research more.
         volatile auto& tc  = m_Registry.get_or_emplace<TransformComponent>(entity);
+        volatile auto& wtc = m_Registry.get_or_emplace<WorldTransformComponent>(entity);
         volatile auto& link = m_Registry.get_or_emplace<Link>(entity);
-        volatile auto& nc = m_Registry.get_or_emplace<NameComponent>(entity);
+        if (m_Registry.try_get<NameComponent>(entity) == nullptr)
+            SetName(entity, NameComponent::DefaultName);
         return e;
 	}
 
 	void Scene::Destroy(Entity entity)
     {
-        m_Registry.destroy(entity);
+        DestroySubtree(entity);
+    }
+
+    std::size_t Scene::DestroySubtree(Entity root)
+    {
+        Link const& rootLink = m_Registry.get<Link>(root);
+        if (rootLink.GetParent() != entt::null)
+        {
+            FromEnTT(rootLink.GetParent()).RemoveChild(root);
+        }
+
+        m_DestroyList.clear();
+        m_DestroyList.push_back(root);
+        CollectDescendants(root);
+        if (m_NameIndexEnabled)
+        {
+            for (entt::entity const entity : m_DestroyList)
+                UnindexName(entity);
+        }
+
+        // Every entity of the subtree goes at once, so there are no links left to fix up
+        m_SuspendHierarchyHooks = true;
+        m_Registry.destroy(m_DestroyList.begin(), m_DestroyList.end());
+        m_SuspendHierarchyHooks = false;
+
+        InvalidateHierarchyOrder();
+        return m_DestroyList.size();
+    }
+
+    void Scene::CollectDescendants(entt::entity entity)
+    {
+        std::size_t head = m_DestroyList.size();
+        for (entt::entity child = m_Registry.get<Link>(entity).GetFirstChild(); child != entt::null;
+            child = m_Registry.get<Link>(child).GetNextSibling())
+        {
+            m_DestroyList.push_back(child);
+        }
+
+        // Each collected entity's children are appended behind it, so the list doubles as the breadth-first queue
+        for (; head < m_DestroyList.size(); ++head)
+        {
+            for (entt::entity child = m_Registry.get<Link>(m_DestroyList[head]).GetFirstChild(); child != entt::null;
+                child = m_Registry.get<Link>(child).GetNextSibling())
+            {
+                m_DestroyList.push_back(child);
+            }
+        }
     }
 
     void Scene::Update(float dt)
     {
+        // Structural changes since the last update, including the command buffers played back at the end of it, leave the hierarchy
+        // pools out of order. Sorting here, before any system runs, costs nothing on frames without such changes.
+        SortHierarchy();
+        m_Scheduler.Run(*this, dt);
+        // After every system and their played back commands, so the world transforms read after the update include this update's moves
+        m_TransformSystem.Update(*this);
+    }
+
+    void Scene::SetThreadPool(Core::ThreadPool* pPool)
+    {
+        m_Scheduler.SetThreadPool(pPool);
+        m_TransformSystem.SetThreadPool(pPool);
+    }
+
+    void Scene::MarkTransformDirty(entt::entity entity)
+    {
+        m_TransformSystem.MarkDirty(entity);
+    }
+
+    bool Scene::SortHierarchy()
+    {
+        if (m_HierarchySorted)
+            return false;
+
+        auto const links = m_Registry.view<Link>();
+
+        // Rank every entity by its position in an iterative depth-first walk that starts from each root in turn.
+        m_DepthFirstRanks.clear();
+        uint32_t rank = 0;
+        for (entt::entity const root : links)
+        {
+            if (links.get<Link>(root).GetParent() != entt::null)
+                continue;
+
+            m_DepthFirstStack.clear();
+            m_DepthFirstStack.push_back(root);
+            while (!m_DepthFirstStack.empty())
+            {
+                entt::entity const entity = m_DepthFirstStack.back();
+                m_DepthFirstStack.pop_back();
+
+                std::size_t const index = EntityIndex(entity);
+                if (index >= m_DepthFirstRanks.size())
+                    m_DepthFirstRanks.resize(index + 1);
+                m_DepthFirstRanks[index] = rank++;
+                if (links.get<Link>(entity).HasStaleChildIndices())
+                    Entity{ this, entity }.RenumberChildren();
+
+                // Pushed last to first so that the first child is popped, and ranked, first
+                for (entt::entity child = links.get<Link>(entity).GetLastChild(); child != entt::null;
+                    child = links.get<Link>(child).GetPreviousSibling())
+                {
+                    m_DepthFirstStack.push_back(child);
+                }
+            }
+        }
+
+        m_Registry.sort<Link>([this](entt::entity const lhs, entt::entity const rhs)
+        {
+            return m_DepthFirstRanks[EntityIndex(lhs)] < m_DepthFirstRanks[EntityIndex(rhs)];
+        });
+        m_Registry.sort<TransformComponent, Link>();
+        m_Registry.sort<WorldTransformComponent, Link>();
+
+        m_HierarchySorted = true;
+        return true;
+    }
+
+    void Scene::SetName(entt::entity entity, std::string_view name)
+    {
+        if (m_Registry.try_get<NameComponent>(entity))
+            WillModify<NameComponent>(entity);
+        UnindexName(entity);
+        m_Registry.emplace_or_replace<NameComponent>(entity, InternName(name));
+        IndexName(entity);
+    }
+
+    NameComponent Scene::InternName(std::string_view name)
+    {
+        NameID const id = m_NamePool.Intern(name);
+
+        NameComponent nameComponent{};
+        nameComponent.Name = m_NamePool.GetString(id);
+        nameComponent.ID = id;
+        nameComponent.Hash = m_NamePool.GetHash(id);
+        return nameComponent;
+    }
+
+    void Scene::EnableNameIndex()
+    {
+        if (m_NameIndexEnabled)
+            return;
+
+        m_NameIndexEnabled = true;
+        auto const named = m_Registry.view<Link, NameComponent>();
+        m_NameIndex.clear();
+        m_NameIndex.reserve(named.size_hint());
+        for (entt::entity const entity : named)
+        {
+            IndexName(entity);
+        }
+    }
+
+    void Scene::DisableNameIndex()
+    {
+        m_NameIndexEnabled = false;
+        m_NameIndex = {};
+    }
+
+    void Scene::IndexName(entt::entity entity)
+    {
+        if (!m_NameIndexEnabled)
+            return;
+
+        auto const [link, name] = m_Registry.try_get<Link, NameComponent>(entity);
+        if (link && name && name->ID != InvalidNameID)
+            m_NameIndex.emplace(NameIndexKey(link->GetParent(), name->ID), entity);
+    }
+
+    void Scene::UnindexName(entt::entity entity)
+    {
+        if (!m_NameIndexEnabled)
+            return;
+
+        auto const [link, name] = m_Registry.try_get<Link, NameComponent>(entity);
+        if (!link || !name || name->ID == InvalidNameID)
+            return;
+
+        auto [it, end] = m_NameIndex.equal_range(NameIndexKey(link->GetParent(), name->ID));
+        for (; it != end; ++it)
+        {
+            if (it->second == entity)
+            {
+                m_NameIndex.erase(it);
+                return;
+            }
+        }
+    }
+
+    void Scene::OnDestroyName(entt::registry& registry, entt::entity entity)
+    {
+        if (!m_SuspendHierarchyHooks)
+            UnindexName(entity);
+    }
+
+    entt::entity Scene::FindChildID(entt::entity parent, NameID name)
+    {
+        if (name == InvalidNameID)
+            return entt::null;
+
+        if (m_NameIndexEnabled)
+        {
+            auto const it = m_NameIndex.find(NameIndexKey(parent, name));
+            return it != m_NameIndex.end() ? it->second : entt::null;
+        }
+
+        if (parent != entt::null)
+        {
+            for (entt::entity child = m_Registry.get<Link>(parent).GetFirstChild(); child != entt::null;
+                child = m_Registry.get<Link>(child).GetNextSibling())
+            {
+                if (m_Registry.get<NameComponent>(child).ID == name)
+                    return child;
+            }
+            return entt::null;
+        }
+
+        // Root entities are not linked to each other, without the index every entity has to be checked
+        auto const named = m_Registry.view<Link, NameComponent>();
+        for (entt::entity const entity : named)
+        {
+            if (named.get<Link>(entity).GetParent() == entt::null && named.get<NameComponent>(entity).ID == name)
+                return entity;
+        }
+        return entt::null;
+    }
+
+    Entity Scene::FindChild(entt::entity parent, std::string_view name)
+    {
+        entt::entity const child = FindChildID(parent, m_NamePool.Find(name));
+        return child != entt::null ? Entity{ this, child } : Entity::Null;
+    }
+
+    Entity Scene::FindByPath(std::string_view path, entt::entity parent)
+    {
+        entt::entity current = parent;
+        for (std::size_t begin = 0; begin <= path.size();)
+        {
+            std::size_t end = path.find('/', begin);
+            if (end == std::string_view::npos)
+                end = path.size();
+
+            if (std::string_view const segment = path.substr(begin, end - begin); !segment.empty())
+            {
+                current = FindChildID(current, m_NamePool.Find(segment));
+                if (current == entt::null)
+                    return Entity::Null;
+            }
+            begin = end + 1;
+        }
+        return current != entt::null ? Entity{ this, current } : Entity::Null;
     }
 
     void Scene::Shutdown()
@@ -54,17 +315,30 @@ namespace RSim::ECS
 
     void Scene::OnDestroyLink(entt::registry& registry, entt::entity entity)
     {
-        Entity entity_{ this , entity };
-        Entity parent = entity_.GetParent();
-        if (parent != Entity::Null) parent.RemoveChild(entity_);
+        if (m_SuspendHierarchyHooks)
+            return;
+
+        Link const& link = registry.get<Link>(entity);
+        if (link.GetParent() != entt::null)
+        {
+            FromEnTT(link.GetParent()).RemoveChild({ this, entity });
+        }
+        // Whichever of the Link and NameComponent is removed first still sees the other one
+        UnindexName(entity);
 
-        Link const& parentLink = entity_.GetLink();
-        entt::entity PreviousSibling{ parentLink.GetFirstChild() };
-        while (PreviousSibling != entt::null)
+        // The descendants are collected before any of them is destroyed, no link is read after its entity is gone
+        m_DestroyList.clear();
+        CollectDescendants(entity);
+        if (m_NameIndexEnabled)
         {
-            Link& childLink = GetComponent<Link>(PreviousSibling);
-            Destroy({ this,PreviousSibling });
-            PreviousSibling = childLink.GetNextSibling();
+            for (entt::entity const descendant : m_DestroyList)
+                UnindexName(descendant);
         }
+
+        m_SuspendHierarchyHooks = true;
+        registry.destroy(m_DestroyList.begin(), m_DestroyList.end());
+        m_SuspendHierarchyHooks = false;
+
+        InvalidateHierarchyOrder();
     }
 }
@@ -0,0 +1,152 @@
+#include "realsim/ecs/SceneHistory.h"
+#include "realsim/ecs/Scene.h"
+#include "realsim/ecs/Entity.h"
+#include "realsim/ecs/Link.h"
+#include "realsim/ecs/CommonComponents.h"
+#include "realsim/ecs/PerspectiveCameraComponent.h"
+
+namespace RSim::ECS
+{
+    SceneHistory::SceneHistory(Scene& Scene, std::size_t Capacity) : m_Scene(Scene), m_Deltas(Capacity + 1)
+    {
+        Track<TransformComponent>();
+        Track<Link>();
+        Track<NameComponent>();
+        Track<BoxComponent>();
+        Track<PerspectiveCameraComponent>();
+        Track<ChildArray>();
+        // Every entity the scene creates gets a Link, its construction marks the entity as created in this tick
+        GetRegistry().on_construct<Link>().connect<&SceneHistory::OnConstructLink>(*this);
+    }
+
+    SceneHistory::~SceneHistory()
+    {
+        for (TrackedType const& type : m_Types)
+        {
+            type.Disconnect(GetRegistry(), *this);
+        }
+        for (TickDelta& delta : m_Deltas)
+        {
+            Clear(delta);
+        }
+    }
+
+    entt::registry& SceneHistory::GetRegistry()
+    {
+        return m_Scene.GetEnTTRegistry();
+    }
+
+    bool SceneHistory::IsFirstChange(entt::entity Entity, uint32_t Type)
+    {
+        return m_ChangedThisTick.insert((uint64_t)entt::to_integral(Entity) << 32 | Type).second;
+    }
+
+    void SceneHistory::OnConstructLink(entt::registry&, entt::entity Entity)
+    {
+        std::lock_guard lock(m_RecordMutex);
+        if (!m_Restoring)
+            CurrentDelta().Records.push_back(Record{ Entity, CreatedRecord, nullptr });
+    }
+
+    void SceneHistory::CommitTick()
+    {
+        m_ChangedThisTick.clear();
+        ++m_CurrentTick;
+        if (m_NumCommitted < m_Deltas.size() - 1)
+            ++m_NumCommitted;
+
+        // The slot of the new tick held the oldest one
+        Clear(CurrentDelta());
+    }
+
+    void SceneHistory::Undo(TickDelta& Delta)
+    {
+        entt::registry& registry = GetRegistry();
+        for (auto it = Delta.Records.rbegin(); it != Delta.Records.rend(); ++it)
+        {
+            if (it->Type == CreatedRecord)
+            {
+                // Frees the handle before an older record of this tick recreates the entity that had it
+                if (registry.valid(it->Entity))
+                    registry.destroy(it->Entity);
+                continue;
+            }
+
+            if (it->pBefore && !registry.valid(it->Entity))
+            {
+                [[maybe_unused]] entt::entity const recreated = registry.create(it->Entity);
+                RSIM_ASSERTM(recreated == it->Entity, "The handle of a destroyed entity is in use by an entity the history did not record.");
+            }
+            m_Types[it->Type].Restore(registry, it->Entity, it->pBefore);
+        }
+    }
+
+    void SceneHistory::Clear(TickDelta& Delta)
+    {
+        for (Record const& record : Delta.Records)
+        {
+            if (record.pBefore)
+                m_Types[record.Type].DestroyValue(record.pBefore);
+        }
+        Delta.Records.clear();
+        Delta.Arena.Reset();
+    }
+
+    bool SceneHistory::Restore(uint64_t Tick)
+    {
+        if (Tick > m_CurrentTick || Tick < GetOldestRestorableTick())
+            return false;
+
+        entt::registry& registry = GetRegistry();
+        m_Restoring = true;
+        // Links are put back as they were recorded, the scene must not fix them up while they are
+        m_Scene.m_SuspendHierarchyHooks = true;
+
+        std::vector<entt::entity> restored;
+        for (uint64_t tick = m_CurrentTick + 1; tick-- > Tick;)
+        {
+            TickDelta& delta = m_Deltas[tick % m_Deltas.size()];
+            Undo(delta);
+            for (Record const& record : delta.Records)
+            {
+                if (record.Type != CreatedRecord)
+                    restored.push_back(record.Entity);
+            }
+            Clear(delta);
+        }
+
+        m_Scene.m_SuspendHierarchyHooks = false;
+        m_NumCommitted -= (std::size_t)(m_CurrentTick - Tick);
+        m_CurrentTick = Tick;
+        m_ChangedThisTick.clear();
+
+        // A recreated entity lost its world transform, which is not recorded, give it one back for the transform system to recompute
+        for (entt::entity const entity : restored)
+        {
+            if (registry.valid(entity) && registry.try_get<TransformComponent>(entity))
+            {
+                registry.get_or_emplace<WorldTransformComponent>(entity);
+                m_Scene.MarkTransformDirty(entity);
+            }
+        }
+
+        // Child arrays and the name index mirror the links and names, rebuild them from the restored ones
+        auto const childArrays = registry.view<ChildArray>();
+        std::vector<entt::entity> parents(childArrays.begin(), childArrays.end());
+        for (entt::entity const parent : parents)
+        {
+            Entity entity{ &m_Scene, parent };
+            entity.DisableChildArray();
+            entity.EnableChildArray();
+        }
+        // Rebuilding the child arrays is not a change of the restored tick
+        m_Restoring = false;
+        if (m_Scene.IsNameIndexEnabled())
+        {
+            m_Scene.DisableNameIndex();
+            m_Scene.EnableNameIndex();
+        }
+        m_Scene.InvalidateHierarchyOrder();
+        return true;
+    }
+}
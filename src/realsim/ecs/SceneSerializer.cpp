@@ -0,0 +1,597 @@
+#include "realsim/ecs/SceneSerializer.h"
+#include "realsim/ecs/Scene.h"
+#include "realsim/ecs/Entity.h"
+#include "realsim/ecs/Link.h"
+#include "realsim/ecs/CommonComponents.h"
+#include "realsim/ecs/PerspectiveCameraComponent.h"
+#include "realsim/core/Logger.h"
+#include "realsim/core/MappedFile.h"
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <type_traits>
+
+namespace RSim::ECS
+{
+    namespace
+    {
+        /**
+         * \brief Identifies a pool in the file, never renumber these.
+         */
+        enum class ComponentID : uint32_t
+        {
+            Transform = 1,
+            WorldTransform = 2,
+            Link = 3,
+            Name = 4,
+            Box = 5,
+            PerspectiveCamera = 6,
+            ChildArray = 7
+        };
+
+        struct FileHeader
+        {
+            char Type[4];
+            uint32_t Version;
+            uint32_t NumEntities;
+            uint32_t NumPools;
+            uint32_t NumStrings;
+            uint32_t Reserved;
+            /**
+             * \brief NumStrings + 1 uint32_t offsets into the characters that follow them, string i is [Offsets[i], Offsets[i + 1]).
+             */
+            uint64_t StringTableOffset;
+        };
+        static_assert(sizeof(FileHeader) == 32);
+
+        struct PoolHeader
+        {
+            ComponentID Component;
+            uint32_t Count;
+            /**
+             * \brief Size of one stored component, zero for pools that only record which entities have the component.
+             */
+            uint32_t ElementSize;
+            uint32_t Reserved;
+            /**
+             * \brief Count uint32_t file indices of the entities, then Count components at DataOffset.
+             */
+            uint64_t IndicesOffset;
+            uint64_t DataOffset;
+        };
+        static_assert(sizeof(PoolHeader) == 32);
+
+        constexpr uint32_t InvalidFileIndex = UINT32_MAX;
+
+        /**
+         * \brief Link with entity handles replaced by file indices.
+         */
+        struct StoredLink
+        {
+            uint32_t FirstChild;
+            uint32_t LastChild;
+            uint32_t PreviousSibling;
+            uint32_t NextSibling;
+            uint32_t Parent;
+            uint32_t NumChildren;
+            uint32_t ChildIndex;
+            uint32_t Reserved;
+        };
+
+        /**
+         * \brief Stored for pools that only record which entities have the component.
+         */
+        struct Membership {};
+
+        /**
+         * \brief Components are stored 16-byte aligned so that types holding SIMD vectors can be inserted straight from the file.
+         */
+        constexpr std::size_t DataAlignment = 16;
+
+        std::size_t EntityIndex(entt::entity entity)
+        {
+            return entt::to_integral(entity) & entt::entt_traits<entt::entity>::entity_mask;
+        }
+
+        class SnapshotWriter
+        {
+        public:
+            explicit SnapshotWriter(std::vector<std::byte>& Bytes) : m_Bytes(Bytes) {}
+
+            std::size_t Align()
+            {
+                m_Bytes.resize((m_Bytes.size() + DataAlignment - 1) & ~(DataAlignment - 1));
+                return m_Bytes.size();
+            }
+
+            std::size_t Write(void const* pData, std::size_t Size)
+            {
+                std::size_t const offset = m_Bytes.size();
+                m_Bytes.resize(offset + Size);
+                if (Size != 0)
+                    std::memcpy(m_Bytes.data() + offset, pData, Size);
+                return offset;
+            }
+
+            template<typename T>
+            T& At(std::size_t Offset) { return *reinterpret_cast<T*>(m_Bytes.data() + Offset); }
+        private:
+            std::vector<std::byte>& m_Bytes;
+        };
+
+        /**
+         * \brief Writes the pool of component T, storing Encode(entity, component) for every saved entity that has one.
+         */
+        template<typename T, typename Stored, typename EncodeFunction>
+        void WritePool(SnapshotWriter& Writer, std::size_t HeaderOffset, ComponentID Component, entt::registry& Registry,
+            std::vector<uint32_t> const& FileIndices, EncodeFunction&& Encode)
+        {
+            std::vector<uint32_t> indices;
+            std::vector<Stored> data;
+            auto const view = Registry.view<T>();
+            indices.reserve(view.size());
+            data.reserve(view.size());
+            for (entt::entity const entity : view)
+            {
+                std::size_t const index = EntityIndex(entity);
+                if (index >= FileIndices.size() || FileIndices[index] == InvalidFileIndex)
+                    continue;
+
+                indices.push_back(FileIndices[index]);
+                if constexpr (!std::is_empty_v<Stored>)
+                    data.push_back(Encode(entity, view.template get<T>(entity)));
+            }
+
+            PoolHeader header{ Component, (uint32_t)indices.size(), std::is_empty_v<Stored> ? 0u : (uint32_t)sizeof(Stored), 0, 0, 0 };
+            Writer.Align();
+            header.IndicesOffset = Writer.Write(indices.data(), indices.size() * sizeof(uint32_t));
+            Writer.Align();
+            header.DataOffset = Writer.Write(data.data(), std::is_empty_v<Stored> ? 0 : data.size() * sizeof(Stored));
+            Writer.At<PoolHeader>(HeaderOffset) = header;
+        }
+
+        template<typename T>
+        void WritePlainPool(SnapshotWriter& Writer, std::size_t HeaderOffset, ComponentID Component, entt::registry& Registry,
+            std::vector<uint32_t> const& FileIndices)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable components can be stored as raw bytes.");
+            WritePool<T, T>(Writer, HeaderOffset, Component, Registry, FileIndices, [](entt::entity, T const& component) { return component; });
+        }
+
+        /**
+         * \brief Checks that [Offset, Offset + Size) lies within the snapshot.
+         */
+        bool InBounds(uint64_t Offset, uint64_t Size, std::size_t SnapshotSize)
+        {
+            return Offset <= SnapshotSize && Size <= SnapshotSize - Offset;
+        }
+
+        /**
+         * \brief Checks that the links, indexed by file index and referring only to existing entities, form a forest: every parent's sibling
+         * list holds exactly the entities that name it as their parent, linked both ways and numbered in order, and every entity is
+         * reachable from a root.
+         */
+        bool IsConsistentHierarchy(std::vector<StoredLink> const& Links)
+        {
+            uint32_t const numEntities = (uint32_t)Links.size();
+            std::vector<uint32_t> numWithParent(numEntities, 0);
+            for (uint32_t entity = 0; entity < numEntities; ++entity)
+            {
+                StoredLink const& link = Links[entity];
+                if (link.Parent != InvalidFileIndex)
+                {
+                    ++numWithParent[link.Parent];
+                }
+                else if (link.PreviousSibling != InvalidFileIndex || link.NextSibling != InvalidFileIndex || link.ChildIndex != InvalidFileIndex)
+                {
+                    rsim_error("Root entity {0} of the scene snapshot has siblings or a child index.", entity);
+                    return false;
+                }
+            }
+
+            for (uint32_t parent = 0; parent < numEntities; ++parent)
+            {
+                StoredLink const& parentLink = Links[parent];
+                if (parentLink.NumChildren != numWithParent[parent])
+                {
+                    rsim_error("Entity {0} of the scene snapshot has {1} children, but {2} entities name it as their parent.", parent,
+                        parentLink.NumChildren, numWithParent[parent]);
+                    return false;
+                }
+
+                // Every child visited names this parent and sits at its own index, so none is visited twice and the walk ends
+                uint32_t previous = InvalidFileIndex;
+                uint32_t position = 0;
+                for (uint32_t child = parentLink.FirstChild; child != InvalidFileIndex; child = Links[child].NextSibling, ++position)
+                {
+                    StoredLink const& childLink = Links[child];
+                    if (childLink.Parent != parent || childLink.PreviousSibling != previous || childLink.ChildIndex != position)
+                    {
+                        rsim_error("The sibling list of entity {0} of the scene snapshot is broken at child {1}.", parent, position);
+                        return false;
+                    }
+                    previous = child;
+                }
+                if (position != parentLink.NumChildren || parentLink.LastChild != previous)
+                {
+                    rsim_error("The sibling list of entity {0} of the scene snapshot does not end at its last child.", parent);
+                    return false;
+                }
+            }
+
+            // The sibling lists are consistent, so walking down from the roots visits every entity once unless some form a parent cycle
+            std::vector<uint32_t> reached;
+            reached.reserve(numEntities);
+            for (uint32_t entity = 0; entity < numEntities; ++entity)
+            {
+                if (Links[entity].Parent == InvalidFileIndex)
+                    reached.push_back(entity);
+            }
+            for (std::size_t head = 0; head < reached.size(); ++head)
+            {
+                for (uint32_t child = Links[reached[head]].FirstChild; child != InvalidFileIndex; child = Links[child].NextSibling)
+                    reached.push_back(child);
+            }
+            if (reached.size() != numEntities)
+            {
+                rsim_error("{0} entities of the scene snapshot are their own ancestors.", numEntities - reached.size());
+                return false;
+            }
+            return true;
+        }
+
+        constexpr uint32_t NumComponentIDs = (uint32_t)ComponentID::ChildArray + 1;
+
+        /**
+         * \brief Size of one stored component of the given pool, or nullopt for a component this version does not know.
+         */
+        std::optional<uint32_t> StoredElementSize(ComponentID Component)
+        {
+            switch (Component)
+            {
+            case ComponentID::Transform: return (uint32_t)sizeof(TransformComponent);
+            case ComponentID::WorldTransform: return (uint32_t)sizeof(WorldTransformComponent);
+            case ComponentID::Link: return (uint32_t)sizeof(StoredLink);
+            case ComponentID::Name: return (uint32_t)sizeof(uint32_t);
+            case ComponentID::Box: return (uint32_t)sizeof(BoxComponent);
+            case ComponentID::PerspectiveCamera: return (uint32_t)sizeof(PerspectiveCameraComponent);
+            case ComponentID::ChildArray: return 0u;
+            }
+            return std::nullopt;
+        }
+
+        /**
+         * \brief Every entity of the scene has these, so their pools have to cover every entity of the snapshot.
+         */
+        constexpr ComponentID RequiredComponents[] = { ComponentID::Transform, ComponentID::WorldTransform, ComponentID::Link, ComponentID::Name };
+    }
+
+    std::vector<std::byte> SceneSerializer::SaveToMemory(Scene& Scene)
+    {
+        entt::registry& registry = Scene.GetEnTTRegistry();
+
+        // File indices follow the Link pool's order, which after sorting is depth-first, and the stored child indices are dense
+        Scene.SortHierarchy();
+        auto const links = registry.view<Link>();
+        std::vector<entt::entity> entities(links.begin(), links.end());
+        std::vector<uint32_t> fileIndices;
+        for (uint32_t i = 0; i < (uint32_t)entities.size(); ++i)
+        {
+            std::size_t const index = EntityIndex(entities[i]);
+            if (index >= fileIndices.size())
+                fileIndices.resize(index + 1, InvalidFileIndex);
+            fileIndices[index] = i;
+        }
+        auto const toFileIndex = [&](entt::entity entity)
+        {
+            return entity == entt::null ? InvalidFileIndex : fileIndices[EntityIndex(entity)];
+        };
+
+        constexpr uint32_t NumPools = 7;
+        NamePool const& names = Scene.GetNamePool();
+
+        std::vector<std::byte> bytes;
+        SnapshotWriter writer{ bytes };
+        FileHeader header{};
+        std::memcpy(header.Type, FileType, sizeof(header.Type));
+        header.Version = Version;
+        header.NumEntities = (uint32_t)entities.size();
+        header.NumPools = NumPools;
+        header.NumStrings = (uint32_t)names.Size();
+        writer.Write(&header, sizeof(header));
+
+        std::size_t const poolHeaders = writer.Write(nullptr, 0);
+        bytes.resize(poolHeaders + NumPools * sizeof(PoolHeader));
+        auto const poolHeader = [&](uint32_t Pool) { return poolHeaders + Pool * sizeof(PoolHeader); };
+
+        WritePlainPool<TransformComponent>(writer, poolHeader(0), ComponentID::Transform, registry, fileIndices);
+        WritePlainPool<WorldTransformComponent>(writer, poolHeader(1), ComponentID::WorldTransform, registry, fileIndices);
+        WritePool<Link, StoredLink>(writer, poolHeader(2), ComponentID::Link, registry, fileIndices, [&](entt::entity, Link const& link)
+        {
+            return StoredLink{ toFileIndex(link.GetFirstChild()), toFileIndex(link.GetLastChild()), toFileIndex(link.GetPreviousSibling()),
+                toFileIndex(link.GetNextSibling()), toFileIndex(link.GetParent()), (uint32_t)link.GetNumChildren(),
+                (uint32_t)link.GetChildIndex(), 0 };
+        });
+        // The string table is the scene's whole name pool, so a stored name is its NameID
+        WritePool<NameComponent, uint32_t>(writer, poolHeader(3), ComponentID::Name, registry, fileIndices, [](entt::entity, NameComponent const& name)
+        {
+            return name.ID != InvalidNameID ? name.ID : InvalidFileIndex;
+        });
+        WritePlainPool<BoxComponent>(writer, poolHeader(4), ComponentID::Box, registry, fileIndices);
+        WritePlainPool<PerspectiveCameraComponent>(writer, poolHeader(5), ComponentID::PerspectiveCamera, registry, fileIndices);
+        WritePool<ChildArray, Membership>(writer, poolHeader(6), ComponentID::ChildArray, registry, fileIndices, nullptr);
+
+        writer.Align();
+        writer.At<FileHeader>(0).StringTableOffset = bytes.size();
+        uint32_t offset = 0;
+        for (NameID id = 0; id < (NameID)names.Size(); ++id)
+        {
+            writer.Write(&offset, sizeof(offset));
+            offset += (uint32_t)names.GetString(id).size();
+        }
+        writer.Write(&offset, sizeof(offset));
+        for (NameID id = 0; id < (NameID)names.Size(); ++id)
+        {
+            writer.Write(names.GetString(id).data(), names.GetString(id).size());
+        }
+        return bytes;
+    }
+
+    bool SceneSerializer::Save(Scene& Scene, std::filesystem::path const& Path)
+    {
+        std::vector<std::byte> const bytes = SaveToMemory(Scene);
+
+        std::ofstream file(Path, std::ios::binary | std::ios::out | std::ios::trunc);
+        if (!file.is_open())
+        {
+            rsim_error("Error when trying to write the scene file: {0}", Path.string());
+            return false;
+        }
+        file.write(reinterpret_cast<char const*>(bytes.data()), (std::streamsize)bytes.size());
+        return file.good();
+    }
+
+    bool SceneSerializer::LoadFromMemory(Scene& Scene, std::byte const* pData, std::size_t Size)
+    {
+        // Everything is validated before the scene is touched, a bad file adds nothing
+        FileHeader header{};
+        if (Size < sizeof(FileHeader) || reinterpret_cast<uintptr_t>(pData) % DataAlignment != 0)
+        {
+            rsim_error("The scene snapshot is too small or misaligned.");
+            return false;
+        }
+        std::memcpy(&header, pData, sizeof(header));
+        if (std::memcmp(header.Type, FileType, sizeof(header.Type)) != 0 || header.Version != Version)
+        {
+            rsim_error("The scene snapshot has the wrong type or version {0}, expected version {1}.", header.Version, Version);
+            return false;
+        }
+        if (!InBounds(sizeof(FileHeader), (uint64_t)header.NumPools * sizeof(PoolHeader), Size) ||
+            !InBounds(header.StringTableOffset, ((uint64_t)header.NumStrings + 1) * sizeof(uint32_t), Size) ||
+            header.StringTableOffset % alignof(uint32_t) != 0)
+        {
+            rsim_error("The scene snapshot is truncated.");
+            return false;
+        }
+
+        auto const* pPools = reinterpret_cast<PoolHeader const*>(pData + sizeof(FileHeader));
+        auto const* pStringOffsets = reinterpret_cast<uint32_t const*>(pData + header.StringTableOffset);
+        uint64_t const charactersOffset = header.StringTableOffset + ((uint64_t)header.NumStrings + 1) * sizeof(uint32_t);
+        for (uint32_t i = 0; i < header.NumStrings; ++i)
+        {
+            if (pStringOffsets[i] > pStringOffsets[i + 1])
+            {
+                rsim_error("The scene snapshot's string table is corrupt.");
+                return false;
+            }
+        }
+        if (!InBounds(charactersOffset, pStringOffsets[header.NumStrings], Size))
+        {
+            rsim_error("The scene snapshot's string table is truncated.");
+            return false;
+        }
+
+        // Every pool is checked before anything is created: its size, its entity indices and the references stored in its components
+        std::array<PoolHeader const*, NumComponentIDs> pools{};
+        std::vector<uint32_t> entityPool(header.NumEntities, InvalidFileIndex);
+        for (uint32_t pool = 0; pool < header.NumPools; ++pool)
+        {
+            PoolHeader const& poolHeader = pPools[pool];
+            std::optional<uint32_t> const elementSize = StoredElementSize(poolHeader.Component);
+            if (!elementSize)
+            {
+                rsim_warn("Skipping pool {0} of the scene snapshot, component {1} is unknown.", pool, (uint32_t)poolHeader.Component);
+                continue;
+            }
+            if (poolHeader.ElementSize != *elementSize)
+            {
+                rsim_error("Pool {0} of the scene snapshot has {1}-byte components instead of {2}.", pool, poolHeader.ElementSize, *elementSize);
+                return false;
+            }
+            if (pools[(uint32_t)poolHeader.Component])
+            {
+                rsim_error("The scene snapshot has more than one pool of component {0}.", (uint32_t)poolHeader.Component);
+                return false;
+            }
+            pools[(uint32_t)poolHeader.Component] = &poolHeader;
+
+            if (!InBounds(poolHeader.IndicesOffset, (uint64_t)poolHeader.Count * sizeof(uint32_t), Size) ||
+                !InBounds(poolHeader.DataOffset, (uint64_t)poolHeader.Count * poolHeader.ElementSize, Size) ||
+                poolHeader.IndicesOffset % DataAlignment != 0 || poolHeader.DataOffset % DataAlignment != 0)
+            {
+                rsim_error("Pool {0} of the scene snapshot is truncated.", pool);
+                return false;
+            }
+
+            uint32_t const* pIndices = reinterpret_cast<uint32_t const*>(pData + poolHeader.IndicesOffset);
+            for (uint32_t i = 0; i < poolHeader.Count; ++i)
+            {
+                if (pIndices[i] >= header.NumEntities)
+                {
+                    rsim_error("Pool {0} of the scene snapshot refers to an entity that does not exist.", pool);
+                    return false;
+                }
+                if (entityPool[pIndices[i]] == pool)
+                {
+                    rsim_error("Pool {0} of the scene snapshot lists entity {1} more than once.", pool, pIndices[i]);
+                    return false;
+                }
+                entityPool[pIndices[i]] = pool;
+            }
+        }
+
+        for (ComponentID const component : RequiredComponents)
+        {
+            // The indices are unique and in range, so a pool with one per entity covers every entity
+            if (!pools[(uint32_t)component] || pools[(uint32_t)component]->Count != header.NumEntities)
+            {
+                rsim_error("The scene snapshot's pool of component {0} is missing or does not cover every entity.", (uint32_t)component);
+                return false;
+            }
+        }
+
+        auto const isEntityReference = [&](uint32_t FileIndex) { return FileIndex == InvalidFileIndex || FileIndex < header.NumEntities; };
+        PoolHeader const& linkPool = *pools[(uint32_t)ComponentID::Link];
+        {
+            // Indexed by file index, the Link pool covers every entity once
+            std::vector<StoredLink> links(header.NumEntities);
+            uint32_t const* pIndices = reinterpret_cast<uint32_t const*>(pData + linkPool.IndicesOffset);
+            for (uint32_t i = 0; i < linkPool.Count; ++i)
+            {
+                StoredLink& stored = links[pIndices[i]];
+                std::memcpy(&stored, pData + linkPool.DataOffset + i * sizeof(StoredLink), sizeof(StoredLink));
+                if (!isEntityReference(stored.FirstChild) || !isEntityReference(stored.LastChild) ||
+                    !isEntityReference(stored.PreviousSibling) || !isEntityReference(stored.NextSibling) || !isEntityReference(stored.Parent))
+                {
+                    rsim_error("A link in the scene snapshot refers to an entity that does not exist.");
+                    return false;
+                }
+            }
+            if (!IsConsistentHierarchy(links))
+                return false;
+        }
+        PoolHeader const& storedNames = *pools[(uint32_t)ComponentID::Name];
+        for (uint32_t i = 0; i < storedNames.Count; ++i)
+        {
+            uint32_t stored;
+            std::memcpy(&stored, pData + storedNames.DataOffset + i * sizeof(uint32_t), sizeof(uint32_t));
+            if (stored != InvalidFileIndex && stored >= header.NumStrings)
+            {
+                rsim_error("A name in the scene snapshot refers to a string that does not exist.");
+                return false;
+            }
+        }
+
+        // The snapshot is valid, nothing below fails
+        entt::registry& registry = Scene.GetEnTTRegistry();
+        std::vector<entt::entity> entities(header.NumEntities);
+        registry.create(entities.begin(), entities.end());
+
+        auto const toEntity = [&](uint32_t FileIndex)
+        {
+            return FileIndex == InvalidFileIndex ? entt::null : entities[FileIndex];
+        };
+
+        std::vector<NameID> names(header.NumStrings);
+        auto const* pCharacters = reinterpret_cast<char const*>(pData + charactersOffset);
+        for (uint32_t i = 0; i < header.NumStrings; ++i)
+        {
+            names[i] = Scene.InternName(std::string_view{ pCharacters + pStringOffsets[i], pStringOffsets[i + 1] - pStringOffsets[i] }).ID;
+        }
+
+        std::vector<entt::entity> handles;
+        auto const poolHandles = [&](PoolHeader const& Pool)
+        {
+            uint32_t const* pIndices = reinterpret_cast<uint32_t const*>(pData + Pool.IndicesOffset);
+            handles.resize(Pool.Count);
+            for (uint32_t i = 0; i < Pool.Count; ++i)
+            {
+                handles[i] = entities[pIndices[i]];
+            }
+        };
+        auto const insertPlain = [&](ComponentID Component, auto const* pTyped)
+        {
+            using T = std::remove_const_t<std::remove_pointer_t<decltype(pTyped)>>;
+            if (PoolHeader const* pPool = pools[(uint32_t)Component])
+            {
+                poolHandles(*pPool);
+                registry.insert<T>(handles.begin(), handles.end(), reinterpret_cast<T const*>(pData + pPool->DataOffset));
+            }
+        };
+
+        insertPlain(ComponentID::Transform, (TransformComponent const*)nullptr);
+        insertPlain(ComponentID::WorldTransform, (WorldTransformComponent const*)nullptr);
+        insertPlain(ComponentID::Box, (BoxComponent const*)nullptr);
+        insertPlain(ComponentID::PerspectiveCamera, (PerspectiveCameraComponent const*)nullptr);
+
+        {
+            std::vector<Link> decoded;
+            decoded.reserve(linkPool.Count);
+            for (uint32_t i = 0; i < linkPool.Count; ++i)
+            {
+                StoredLink stored{};
+                std::memcpy(&stored, pData + linkPool.DataOffset + i * sizeof(StoredLink), sizeof(StoredLink));
+                decoded.emplace_back(toEntity(stored.FirstChild), toEntity(stored.LastChild), toEntity(stored.PreviousSibling),
+                    toEntity(stored.NextSibling), toEntity(stored.Parent), stored.NumChildren,
+                    stored.ChildIndex == InvalidFileIndex ? Link::InvalidChildIndex() : stored.ChildIndex);
+            }
+            poolHandles(linkPool);
+            registry.insert<Link>(handles.begin(), handles.end(), decoded.begin());
+        }
+
+        {
+            NameComponent const defaultName = Scene.InternName(NameComponent::DefaultName);
+            NamePool const& namePool = Scene.GetNamePool();
+            std::vector<NameComponent> decoded;
+            decoded.reserve(storedNames.Count);
+            for (uint32_t i = 0; i < storedNames.Count; ++i)
+            {
+                uint32_t stored;
+                std::memcpy(&stored, pData + storedNames.DataOffset + i * sizeof(uint32_t), sizeof(uint32_t));
+                if (stored == InvalidFileIndex)
+                {
+                    decoded.push_back(defaultName);
+                    continue;
+                }
+                NameComponent name{};
+                name.ID = names[stored];
+                name.Name = namePool.GetString(name.ID);
+                name.Hash = namePool.GetHash(name.ID);
+                decoded.push_back(name);
+            }
+            poolHandles(storedNames);
+            registry.insert<NameComponent>(handles.begin(), handles.end(), decoded.begin());
+        }
+
+        // Built from the links, which are all in place now
+        if (PoolHeader const* pChildArrays = pools[(uint32_t)ComponentID::ChildArray])
+        {
+            uint32_t const* pIndices = reinterpret_cast<uint32_t const*>(pData + pChildArrays->IndicesOffset);
+            for (uint32_t i = 0; i < pChildArrays->Count; ++i)
+            {
+                Entity{ &Scene, entities[pIndices[i]] }.EnableChildArray();
+            }
+        }
+
+        if (Scene.IsNameIndexEnabled())
+        {
+            Scene.DisableNameIndex();
+            Scene.EnableNameIndex();
+        }
+        Scene.InvalidateHierarchyOrder();
+        return true;
+    }
+
+    bool SceneSerializer::Load(Scene& Scene, std::filesystem::path const& Path)
+    {
+        Core::MappedFile file;
+        if (!file.Open(Path))
+        {
+            rsim_error("Error when trying to open the scene file: {0}", Path.string());
+            return false;
+        }
+        return LoadFromMemory(Scene, file.GetData(), file.GetSize());
+    }
+}
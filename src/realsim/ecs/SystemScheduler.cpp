@@ -0,0 +1,207 @@
+#include "realsim/ecs/SystemScheduler.h"
+#include "realsim/ecs/Scene.h"
+#include "realsim/ecs/Link.h"
+#include "realsim/core/ThreadPool.h"
+
+#include <chrono>
+#include <thread>
+#include <utility>
+
+namespace RSim::ECS
+{
+    namespace
+    {
+        /**
+         * \brief Stands for the scene's name index and hierarchy order in the declared access, no component of this type exists.
+         */
+        struct SceneHierarchyState {};
+    }
+
+    void SystemAccess::AddImpliedAccess(std::vector<entt::id_type>& Types, entt::id_type Type)
+    {
+        if (Type == entt::type_hash<Link>::value() || Type == entt::type_hash<NameComponent>::value())
+            Types.push_back(entt::type_hash<SceneHierarchyState>::value());
+    }
+
+    bool SystemAccess::Intersects(std::vector<entt::id_type> const& Lhs, std::vector<entt::id_type> const& Rhs)
+    {
+        // Systems declare a handful of types, a linear search beats sorting or hashing them
+        for (entt::id_type const type : Lhs)
+        {
+            for (entt::id_type const other : Rhs)
+            {
+                if (type == other)
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    bool SystemAccess::ConflictsWith(SystemAccess const& Other) const
+    {
+        return m_Exclusive || Other.m_Exclusive ||
+            Intersects(m_Writes, Other.m_Writes) ||
+            Intersects(m_Writes, Other.m_Reads) ||
+            Intersects(m_Reads, Other.m_Writes);
+    }
+
+    void SystemAccess::CreateStorage(entt::registry& Registry) const
+    {
+        for (auto const createStorage : m_CreateStorage)
+        {
+            createStorage(Registry);
+        }
+    }
+
+    auto SystemScheduler::AddSystem(std::string Name, SystemAccess Access, SystemFunction Function) -> SystemID
+    {
+        m_Systems.push_back(System{ std::move(Name), std::move(Access), std::move(Function), SystemTiming{}, EntityCommandBuffer{} });
+        return (SystemID)(m_Systems.size() - 1);
+    }
+
+    void SystemScheduler::BuildGraph()
+    {
+        m_Nodes.clear();
+        m_Dependents.clear();
+        for (SystemID id = 0; id < (SystemID)m_Systems.size(); ++id)
+        {
+            if (m_Systems[id].Enabled)
+                m_Nodes.push_back(Node{ id, 0, 0, 0 });
+        }
+
+        // A system depends on every earlier conflicting system, which keeps the result equal to running them in order
+        for (uint32_t i = 0; i < (uint32_t)m_Nodes.size(); ++i)
+        {
+            m_Nodes[i].FirstDependent = (uint32_t)m_Dependents.size();
+            SystemAccess const& access = m_Systems[m_Nodes[i].SystemIndex].Access;
+            for (uint32_t j = i + 1; j < (uint32_t)m_Nodes.size(); ++j)
+            {
+                if (access.ConflictsWith(m_Systems[m_Nodes[j].SystemIndex].Access))
+                {
+                    m_Dependents.push_back(j);
+                    ++m_Nodes[j].NumDependencies;
+                }
+            }
+            m_Nodes[i].NumDependents = (uint32_t)m_Dependents.size() - m_Nodes[i].FirstDependent;
+        }
+    }
+
+    void SystemScheduler::RunSystem(Scene& Scene, float dt, System& System)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        System.Function(Scene, dt, System.Commands);
+        auto const elapsedMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        System.Timing.LastMs = elapsedMs;
+        System.Timing.AverageMs += TimingSmoothing * (elapsedMs - System.Timing.AverageMs);
+    }
+
+    void SystemScheduler::TryRunSystem(Scene& Scene, float dt, System& System)
+    {
+        // Once a system has thrown, the systems that have not started yet are skipped
+        if (m_Failed.load(std::memory_order_acquire))
+            return;
+
+        try
+        {
+            RunSystem(Scene, dt, System);
+        }
+        catch (...)
+        {
+            std::lock_guard lock(m_ExceptionMutex);
+            if (!m_FirstException)
+                m_FirstException = std::current_exception();
+            m_Failed.store(true, std::memory_order_release);
+        }
+    }
+
+    void SystemScheduler::RunNode(Scene& Scene, float dt, uint32_t NodeIndex)
+    {
+        Node const& node = m_Nodes[NodeIndex];
+        // Never throws, the dependents are released and the node counted down even if the system fails
+        TryRunSystem(Scene, dt, m_Systems[node.SystemIndex]);
+
+        for (uint32_t i = node.FirstDependent; i < node.FirstDependent + node.NumDependents; ++i)
+        {
+            uint32_t const dependent = m_Dependents[i];
+            if (m_RemainingDependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                m_ThreadPool->Submit([this, &Scene, dt, dependent] { RunNode(Scene, dt, dependent); });
+            }
+        }
+        // Counted down after the dependents are submitted, Run() cannot return while one of them is still to be queued
+        m_NumRemainingNodes.fetch_sub(1, std::memory_order_release);
+    }
+
+    void SystemScheduler::Run(Scene& Scene, float dt)
+    {
+        entt::registry& registry = Scene.GetEnTTRegistry();
+        for (System const& system : m_Systems)
+        {
+            if (system.Enabled)
+                system.Access.CreateStorage(registry);
+        }
+
+        BuildGraph();
+        if (!m_ThreadPool || m_ThreadPool->GetNumThreads() == 0 || m_Nodes.size() < 2)
+        {
+            for (Node const& node : m_Nodes)
+            {
+                TryRunSystem(Scene, dt, m_Systems[node.SystemIndex]);
+            }
+            FinishRun(Scene);
+            return;
+        }
+
+        if (m_RemainingCapacity < m_Nodes.size())
+        {
+            m_RemainingDependencies = std::make_unique<std::atomic<uint32_t>[]>(m_Nodes.size());
+            m_RemainingCapacity = m_Nodes.size();
+        }
+        for (std::size_t i = 0; i < m_Nodes.size(); ++i)
+        {
+            m_RemainingDependencies[i].store(m_Nodes[i].NumDependencies, std::memory_order_relaxed);
+        }
+        m_NumRemainingNodes.store((uint32_t)m_Nodes.size(), std::memory_order_relaxed);
+
+        for (uint32_t i = 0; i < (uint32_t)m_Nodes.size(); ++i)
+        {
+            if (m_Nodes[i].NumDependencies == 0)
+                m_ThreadPool->Submit([this, &Scene, dt, i] { RunNode(Scene, dt, i); });
+        }
+
+        while (m_NumRemainingNodes.load(std::memory_order_acquire) != 0)
+        {
+            if (!m_ThreadPool->RunPendingJob())
+                std::this_thread::yield();
+        }
+        FinishRun(Scene);
+    }
+
+    void SystemScheduler::FinishRun(Scene& Scene)
+    {
+        if (!m_Failed.load(std::memory_order_acquire))
+        {
+            PlaybackCommands(Scene);
+            return;
+        }
+
+        // A frame whose systems did not all run leaves the scene's structure as it was, none of the recorded commands are applied
+        for (Node const& node : m_Nodes)
+        {
+            m_Systems[node.SystemIndex].Commands.Clear();
+        }
+        std::exception_ptr const exception = std::exchange(m_FirstException, nullptr);
+        m_Failed.store(false, std::memory_order_relaxed);
+        std::rethrow_exception(exception);
+    }
+
+    void SystemScheduler::PlaybackCommands(Scene& Scene)
+    {
+        // In the order the systems were added rather than the order they finished in, the result is the same on every run
+        for (Node const& node : m_Nodes)
+        {
+            m_Systems[node.SystemIndex].Commands.Playback(Scene);
+        }
+    }
+}
@@ -0,0 +1,177 @@
+#include "realsim/ecs/TransformBatch.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define RSIM_TRANSFORM_BATCH_AVX2 1
+#endif
+
+namespace RSim::ECS
+{
+    namespace
+    {
+#if RSIM_TRANSFORM_BATCH_AVX2
+        /**
+         * \brief Transposes eight rows of eight floats in place, afterwards row k holds lane k of every input row.
+         */
+        void Transpose8x8(__m256 (&Rows)[8])
+        {
+            __m256 const t0 = _mm256_unpacklo_ps(Rows[0], Rows[1]);
+            __m256 const t1 = _mm256_unpackhi_ps(Rows[0], Rows[1]);
+            __m256 const t2 = _mm256_unpacklo_ps(Rows[2], Rows[3]);
+            __m256 const t3 = _mm256_unpackhi_ps(Rows[2], Rows[3]);
+            __m256 const t4 = _mm256_unpacklo_ps(Rows[4], Rows[5]);
+            __m256 const t5 = _mm256_unpackhi_ps(Rows[4], Rows[5]);
+            __m256 const t6 = _mm256_unpacklo_ps(Rows[6], Rows[7]);
+            __m256 const t7 = _mm256_unpackhi_ps(Rows[6], Rows[7]);
+
+            __m256 const s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 const s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+            __m256 const s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 const s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+            __m256 const s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 const s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+            __m256 const s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 const s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+            Rows[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+            Rows[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+            Rows[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+            Rows[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+            Rows[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+            Rows[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+            Rows[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+            Rows[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+        }
+#endif
+    }
+
+    void TransformBatch::Clear()
+    {
+        // The arrays keep their size, the next Resize() reuses them without filling them again
+        m_Size = 0;
+    }
+
+    void TransformBatch::Resize(std::size_t Count)
+    {
+        if (Count > m_Components[0].size())
+        {
+            for (std::vector<float>& component : m_Components)
+                component.resize(Count);
+        }
+        m_Size = Count;
+    }
+
+    void TransformBatch::Set(std::size_t Index, TransformComponent const& Transform)
+    {
+        m_Components[TX][Index] = Transform.Translation.x;
+        m_Components[TY][Index] = Transform.Translation.y;
+        m_Components[TZ][Index] = Transform.Translation.z;
+        m_Components[QX][Index] = Transform.Rotation.x;
+        m_Components[QY][Index] = Transform.Rotation.y;
+        m_Components[QZ][Index] = Transform.Rotation.z;
+        m_Components[QW][Index] = Transform.Rotation.w;
+        m_Components[SX][Index] = Transform.Scale.x;
+        m_Components[SY][Index] = Transform.Scale.y;
+        m_Components[SZ][Index] = Transform.Scale.z;
+    }
+
+    void TransformBatch::Add(TransformComponent const& Transform)
+    {
+        std::size_t const index = m_Size;
+        Resize(index + 1);
+        Set(index, Transform);
+    }
+
+    bool TransformBatch::IsAVX2Enabled()
+    {
+#if RSIM_TRANSFORM_BATCH_AVX2
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void TransformBatch::BuildMatrices(DirectX::XMFLOAT4X4* pOut) const
+    {
+#if RSIM_TRANSFORM_BATCH_AVX2
+        std::size_t const vectorEnd = m_Size - m_Size % LaneCount;
+        BuildMatricesAVX2(vectorEnd, pOut);
+        BuildMatricesScalar(vectorEnd, m_Size, pOut);
+#else
+        BuildMatricesScalar(0, m_Size, pOut);
+#endif
+    }
+
+    void TransformBatch::BuildMatricesScalar(DirectX::XMFLOAT4X4* pOut) const
+    {
+        BuildMatricesScalar(0, m_Size, pOut);
+    }
+
+    void TransformBatch::BuildMatricesScalar(std::size_t Begin, std::size_t End, DirectX::XMFLOAT4X4* pOut) const
+    {
+        // Scaling * RotationQuaternion * Translation in the row-vector convention: the rows of the rotation matrix scaled by the scale,
+        // with the translation as the last row.
+        for (std::size_t i = Begin; i < End; ++i)
+        {
+            float const x = m_Components[QX][i], y = m_Components[QY][i], z = m_Components[QZ][i], w = m_Components[QW][i];
+            float const sx = m_Components[SX][i], sy = m_Components[SY][i], sz = m_Components[SZ][i];
+
+            float const xx = x * x, yy = y * y, zz = z * z;
+            float const xy = x * y, xz = x * z, yz = y * z;
+            float const xw = x * w, yw = y * w, zw = z * w;
+
+            DirectX::XMFLOAT4X4& m = pOut[i];
+            m._11 = sx * (1.0f - 2.0f * (yy + zz)); m._12 = sx * (2.0f * (xy + zw)); m._13 = sx * (2.0f * (xz - yw)); m._14 = 0.0f;
+            m._21 = sy * (2.0f * (xy - zw)); m._22 = sy * (1.0f - 2.0f * (xx + zz)); m._23 = sy * (2.0f * (yz + xw)); m._24 = 0.0f;
+            m._31 = sz * (2.0f * (xz + yw)); m._32 = sz * (2.0f * (yz - xw)); m._33 = sz * (1.0f - 2.0f * (xx + yy)); m._34 = 0.0f;
+            m._41 = m_Components[TX][i]; m._42 = m_Components[TY][i]; m._43 = m_Components[TZ][i]; m._44 = 1.0f;
+        }
+    }
+
+    void TransformBatch::BuildMatricesAVX2(std::size_t End, DirectX::XMFLOAT4X4* pOut) const
+    {
+#if RSIM_TRANSFORM_BATCH_AVX2
+        __m256 const zero = _mm256_setzero_ps();
+        __m256 const one = _mm256_set1_ps(1.0f);
+        __m256 const two = _mm256_set1_ps(2.0f);
+
+        for (std::size_t i = 0; i < End; i += LaneCount)
+        {
+            __m256 const x = _mm256_loadu_ps(m_Components[QX].data() + i);
+            __m256 const y = _mm256_loadu_ps(m_Components[QY].data() + i);
+            __m256 const z = _mm256_loadu_ps(m_Components[QZ].data() + i);
+            __m256 const w = _mm256_loadu_ps(m_Components[QW].data() + i);
+            __m256 const sx = _mm256_loadu_ps(m_Components[SX].data() + i);
+            __m256 const sy = _mm256_loadu_ps(m_Components[SY].data() + i);
+            __m256 const sz = _mm256_loadu_ps(m_Components[SZ].data() + i);
+
+            __m256 const xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+            __m256 const xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+            __m256 const xw = _mm256_mul_ps(x, w), yw = _mm256_mul_ps(y, w), zw = _mm256_mul_ps(z, w);
+
+            auto const diagonal = [&](__m256 A, __m256 B) { return _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(A, B))); };
+            auto const sum = [&](__m256 A, __m256 B) { return _mm256_mul_ps(two, _mm256_add_ps(A, B)); };
+            auto const difference = [&](__m256 A, __m256 B) { return _mm256_mul_ps(two, _mm256_sub_ps(A, B)); };
+
+            // Columns of the first two rows, then of the last two, for eight matrices. Transposed, each row is half a matrix.
+            __m256 upper[8] = {
+                _mm256_mul_ps(sx, diagonal(yy, zz)), _mm256_mul_ps(sx, sum(xy, zw)), _mm256_mul_ps(sx, difference(xz, yw)), zero,
+                _mm256_mul_ps(sy, difference(xy, zw)), _mm256_mul_ps(sy, diagonal(xx, zz)), _mm256_mul_ps(sy, sum(yz, xw)), zero };
+            __m256 lower[8] = {
+                _mm256_mul_ps(sz, sum(xz, yw)), _mm256_mul_ps(sz, difference(yz, xw)), _mm256_mul_ps(sz, diagonal(xx, yy)), zero,
+                _mm256_loadu_ps(m_Components[TX].data() + i), _mm256_loadu_ps(m_Components[TY].data() + i),
+                _mm256_loadu_ps(m_Components[TZ].data() + i), one };
+            Transpose8x8(upper);
+            Transpose8x8(lower);
+
+            for (std::size_t lane = 0; lane < LaneCount; ++lane)
+            {
+                _mm256_storeu_ps(&pOut[i + lane]._11, upper[lane]);
+                _mm256_storeu_ps(&pOut[i + lane]._31, lower[lane]);
+            }
+        }
+#else
+        BuildMatricesScalar(0, End, pOut);
+#endif
+    }
+}
@@ -0,0 +1,173 @@
+#include "realsim/ecs/TransformSystem.h"
+#include "realsim/ecs/Scene.h"
+#include "realsim/ecs/Link.h"
+#include "realsim/core/ThreadPool.h"
+
+#include <atomic>
+
+namespace RSim::ECS
+{
+    namespace
+    {
+        // Views are created on the calling thread; the worker threads only read and write components through them, which does not
+        // touch the registry itself.
+        using HierarchyView = decltype(std::declval<entt::registry&>().view<TransformComponent, WorldTransformComponent, Link>());
+
+        /**
+         * \brief Recomputes the world transforms of [pBegin, pEnd), whose parents are up to date. The local matrices are built as one batch.
+         */
+        void UpdateWorldTransforms(HierarchyView const& Hierarchy, entt::entity const* pBegin, entt::entity const* pEnd,
+            TransformSystem::Scratch& Scratch)
+        {
+            std::size_t const count = (std::size_t)(pEnd - pBegin);
+            Scratch.Batch.Resize(count);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                Scratch.Batch.Set(i, Hierarchy.get<TransformComponent>(pBegin[i]));
+            }
+            Scratch.LocalMatrices.resize(Scratch.Batch.Size());
+            Scratch.Batch.BuildMatrices(Scratch.LocalMatrices.data());
+
+            for (std::size_t i = 0; i < Scratch.LocalMatrices.size(); ++i)
+            {
+                auto const& [world, link] = Hierarchy.get<WorldTransformComponent, Link>(pBegin[i]);
+                if (link.GetParent() == entt::null)
+                {
+                    world.World = Scratch.LocalMatrices[i];
+                    continue;
+                }
+
+                // Row vectors: the local transform is applied first, then the parent's world transform.
+                DirectX::XMMATRIX const worldMatrix = DirectX::XMMatrixMultiply(DirectX::XMLoadFloat4x4(&Scratch.LocalMatrices[i]),
+                    Hierarchy.get<WorldTransformComponent>(link.GetParent()).GetTransform());
+                DirectX::XMStoreFloat4x4(&world.World, worldMatrix);
+            }
+        }
+
+        /**
+         * \brief Recomputes the world transforms of the subtrees rooted at [pBegin, pEnd) breadth-first, a level at a time.
+         * \return The number of entities updated.
+         */
+        std::size_t UpdateSubtrees(HierarchyView const& Hierarchy, entt::entity const* pBegin, entt::entity const* pEnd,
+            TransformSystem::Scratch& Scratch)
+        {
+            std::vector<entt::entity>& queue = Scratch.Queue;
+            queue.assign(pBegin, pEnd);
+            for (std::size_t head = 0; head < queue.size();)
+            {
+                std::size_t const levelEnd = queue.size();
+                UpdateWorldTransforms(Hierarchy, queue.data() + head, queue.data() + levelEnd, Scratch);
+                for (; head < levelEnd; ++head)
+                {
+                    for (entt::entity child = Hierarchy.get<Link>(queue[head]).GetFirstChild(); child != entt::null;
+                        child = Hierarchy.get<Link>(child).GetNextSibling())
+                    {
+                        queue.push_back(child);
+                    }
+                }
+            }
+            return queue.size();
+        }
+    }
+
+    TransformSystem::TransformSystem()
+    {
+        static std::atomic<uint64_t> s_NextID{ 1 };
+        m_ID = s_NextID++;
+    }
+
+    void TransformSystem::MarkDirty(entt::entity Entity)
+    {
+        // Each thread remembers the list it last appended to, so marking only locks the first time a thread marks for this system
+        thread_local struct { uint64_t SystemID; DirtyList* pList; } cached{ 0, nullptr };
+        if (cached.SystemID != m_ID)
+            cached = { m_ID, &FindDirtyList() };
+        cached.pList->Entities.push_back(Entity);
+    }
+
+    auto TransformSystem::FindDirtyList() -> DirtyList&
+    {
+        std::lock_guard lock(m_DirtyListsMutex);
+        std::thread::id const thread = std::this_thread::get_id();
+        for (auto const& list : m_DirtyLists)
+        {
+            if (list->Thread == thread)
+                return *list;
+        }
+        DirtyList& list = *m_DirtyLists.emplace_back(std::make_unique<DirtyList>());
+        list.Thread = thread;
+        return list;
+    }
+
+    void TransformSystem::Update(Scene& Scene)
+    {
+        entt::registry& registry = Scene.GetEnTTRegistry();
+        m_NumUpdated = 0;
+
+        // Nothing marks entities while the update runs, the lists are merged into the tag pool here on the updating thread
+        {
+            std::lock_guard lock(m_DirtyListsMutex);
+            for (auto const& list : m_DirtyLists)
+            {
+                for (entt::entity const entity : list->Entities)
+                {
+                    if (registry.valid(entity))
+                        registry.emplace_or_replace<DirtyTransformTag>(entity);
+                }
+                list->Entities.clear();
+            }
+        }
+
+        HierarchyView const hierarchy = registry.view<TransformComponent, WorldTransformComponent, Link>();
+
+        auto const dirtyView = registry.view<DirtyTransformTag>();
+        if (dirtyView.empty())
+            return;
+
+        // Only the top-most dirty entities are walked from, a dirty entity under a dirty ancestor is covered by the ancestor's walk.
+        m_Frontier.clear();
+        for (entt::entity const entity : dirtyView)
+        {
+            bool hasDirtyAncestor = false;
+            for (entt::entity parent = hierarchy.get<Link>(entity).GetParent(); parent != entt::null && !hasDirtyAncestor;
+                parent = hierarchy.get<Link>(parent).GetParent())
+            {
+                hasDirtyAncestor = dirtyView.contains(parent);
+            }
+
+            if (!hasDirtyAncestor)
+                m_Frontier.push_back(entity);
+        }
+
+        // Walk level by level on this thread until there are enough independent subtrees to split across the pool.
+        while (!m_Frontier.empty())
+        {
+            if (m_ThreadPool && m_Frontier.size() >= 2 * MinSubtreesPerTask)
+            {
+                m_TaskScratch.resize(m_ThreadPool->GetMaxParallelism());
+                std::atomic<std::size_t> numUpdated{ 0 };
+                m_ThreadPool->ParallelFor(m_Frontier.size(), MinSubtreesPerTask, [&](std::size_t Begin, std::size_t End, std::size_t TaskIndex)
+                {
+                    numUpdated += UpdateSubtrees(hierarchy, m_Frontier.data() + Begin, m_Frontier.data() + End, m_TaskScratch[TaskIndex]);
+                });
+                m_NumUpdated += numUpdated;
+                break;
+            }
+
+            UpdateWorldTransforms(hierarchy, m_Frontier.data(), m_Frontier.data() + m_Frontier.size(), m_Scratch);
+            m_NextFrontier.clear();
+            for (entt::entity const entity : m_Frontier)
+            {
+                for (entt::entity child = hierarchy.get<Link>(entity).GetFirstChild(); child != entt::null;
+                    child = hierarchy.get<Link>(child).GetNextSibling())
+                {
+                    m_NextFrontier.push_back(child);
+                }
+            }
+            m_NumUpdated += m_Frontier.size();
+            std::swap(m_Frontier, m_NextFrontier);
+        }
+
+        registry.clear<DirtyTransformTag>();
+    }
+}
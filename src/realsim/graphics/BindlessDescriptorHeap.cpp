@@ -0,0 +1,177 @@
+#include "realsim/graphics/BindlessDescriptorHeap.h"
+#include "realsim/graphics/Exception.h"
+
+#include <vector>
+
+namespace RSim::Graphics
+{
+	static_assert(sizeof(D3D12_CPU_DESCRIPTOR_HANDLE) == sizeof(std::size_t),
+		"DescriptorCopyBatch stores the range starts as arrays of CPU descriptor handles.");
+
+	BindlessDescriptorHeap::BindlessDescriptorHeap(ID3D12Device2* pDevice, D3D12_DESCRIPTOR_HEAP_TYPE Type, uint32_t NumDescriptors,
+		LPCWSTR Name, uint32_t NumDynamicDescriptors)
+		:
+		m_pDevice(pDevice), m_Type(Type), m_NumDescriptors(NumDescriptors), m_NumDynamicDescriptors(NumDynamicDescriptors),
+		m_DescriptorSize(pDevice->GetDescriptorHandleIncrementSize(Type)),
+		m_Allocator(NumDescriptors - NumDynamicDescriptors),
+		m_DynamicAllocator(NumDescriptors - NumDynamicDescriptors, NumDynamicDescriptors, DynamicChunkSize),
+		m_DynamicCopies(m_DescriptorSize)
+	{
+		RSIM_ASSERTM(Type == D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV || Type == D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER,
+			"Only CBV/SRV/UAV and sampler heaps can be shader-visible.");
+		RSIM_ASSERTM(NumDynamicDescriptors < NumDescriptors, "The dynamic region has to leave room for persistent descriptors.");
+
+		D3D12_DESCRIPTOR_HEAP_DESC heapDesc{};
+		heapDesc.Type = Type;
+		heapDesc.NumDescriptors = NumDescriptors;
+		heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+		heapDesc.NodeMask = 0;
+		ThrowIfFailed(pDevice->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&m_Heap)));
+		m_Heap->SetName(Name);
+
+		m_CPUStart = m_Heap->GetCPUDescriptorHandleForHeapStart();
+		m_GPUStart = m_Heap->GetGPUDescriptorHandleForHeapStart();
+	}
+
+	BindlessDescriptorHeap::~BindlessDescriptorHeap()
+	{
+		// The owner waits for the GPU before destroying the heap, whatever is still stale can be released.
+		m_Allocator.ReleaseStaleAllocations(UINT64_MAX);
+		m_DynamicAllocator.EndFrame(0);
+		m_DynamicAllocator.ReleaseCompletedFrames(UINT64_MAX);
+	}
+
+	uint32_t BindlessDescriptorHeap::Allocate(uint32_t NumDescriptors)
+	{
+		std::lock_guard lock(m_Mutex);
+		auto const allocation = m_Allocator.Allocate(NumDescriptors);
+		return allocation.IsValid() ? (uint32_t)allocation.Offset : InvalidIndex;
+	}
+
+	void BindlessDescriptorHeap::Free(uint32_t Index, uint32_t NumDescriptors, uint64_t FenceValue)
+	{
+		RSIM_ASSERTM(Index != InvalidIndex && Index + NumDescriptors <= m_NumDescriptors, "The descriptors are not in this heap.");
+		std::lock_guard lock(m_Mutex);
+		m_Allocator.Free(Index, NumDescriptors, FenceValue);
+	}
+
+	void BindlessDescriptorHeap::ReleaseStaleDescriptors(uint64_t CompletedFenceValue)
+	{
+		std::lock_guard lock(m_Mutex);
+		m_Allocator.ReleaseStaleAllocations(CompletedFenceValue);
+		m_DynamicAllocator.ReleaseCompletedFrames(CompletedFenceValue);
+	}
+
+	uint32_t BindlessDescriptorHeap::StageDynamicDescriptors(DescriptorAllocation const* pSources, uint32_t NumSources)
+	{
+		uint32_t numDescriptors = 0;
+		for (uint32_t i = 0; i < NumSources; ++i)
+		{
+			numDescriptors += pSources[i].NumDescriptors;
+		}
+
+		std::lock_guard lock(m_Mutex);
+		uint32_t const index = m_DynamicAllocator.Allocate(numDescriptors);
+		if (index == InvalidIndex)
+		{
+			rsim_error("The dynamic region of the descriptor heap is full, {0} descriptors were requested.", numDescriptors);
+			return InvalidIndex;
+		}
+
+		// The destinations are all in this heap, the sources are told apart by the page they were allocated from
+		std::size_t const destHeap = GetCPUHandle(0).ptr;
+		uint32_t dest = index;
+		for (uint32_t i = 0; i < NumSources; ++i)
+		{
+			m_DynamicCopies.Add(pSources[i].Handle.ptr, pSources[i].GetPageStart().ptr, GetCPUHandle(dest).ptr, destHeap,
+				pSources[i].NumDescriptors);
+			dest += pSources[i].NumDescriptors;
+		}
+		return index;
+	}
+
+	void BindlessDescriptorHeap::FlushDynamicCopies()
+	{
+		std::lock_guard lock(m_Mutex);
+		if (m_DynamicCopies.IsEmpty())
+			return;
+
+		// Sources that are adjacent in the same CPU heap page are merged into ranges, so most frames copy only a few ranges.
+		auto const& destStarts = m_DynamicCopies.GetDestStarts();
+		auto const& sourceStarts = m_DynamicCopies.GetSourceStarts();
+		m_pDevice->CopyDescriptors(
+			(UINT)destStarts.size(), reinterpret_cast<D3D12_CPU_DESCRIPTOR_HANDLE const*>(destStarts.data()),
+			m_DynamicCopies.GetDestSizes().data(),
+			(UINT)sourceStarts.size(), reinterpret_cast<D3D12_CPU_DESCRIPTOR_HANDLE const*>(sourceStarts.data()),
+			m_DynamicCopies.GetSourceSizes().data(),
+			m_Type);
+		m_DynamicCopies.Clear();
+	}
+
+	void BindlessDescriptorHeap::EndFrame(uint64_t FenceValue)
+	{
+		std::lock_guard lock(m_Mutex);
+		RSIM_ASSERTM(m_DynamicCopies.IsEmpty(), "The dynamic descriptors of the frame have to be flushed before it ends.");
+		m_DynamicAllocator.EndFrame(FenceValue);
+	}
+
+	uint32_t BindlessDescriptorHeap::CheckedAllocate()
+	{
+		uint32_t const index = Allocate();
+		if (index == InvalidIndex)
+			rsim_error("The bindless descriptor heap is full, {0} descriptors are in use.", m_NumDescriptors - GetNumFreeDescriptors());
+		return index;
+	}
+
+	uint32_t BindlessDescriptorHeap::CreateShaderResourceView(ID3D12Resource* pResource, D3D12_SHADER_RESOURCE_VIEW_DESC const* pDesc)
+	{
+		RSIM_ASSERT(m_Type == D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+		uint32_t const index = CheckedAllocate();
+		if (index != InvalidIndex)
+			m_pDevice->CreateShaderResourceView(pResource, pDesc, GetCPUHandle(index));
+		return index;
+	}
+
+	uint32_t BindlessDescriptorHeap::CreateUnorderedAccessView(ID3D12Resource* pResource, D3D12_UNORDERED_ACCESS_VIEW_DESC const* pDesc)
+	{
+		RSIM_ASSERT(m_Type == D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+		uint32_t const index = CheckedAllocate();
+		if (index != InvalidIndex)
+			m_pDevice->CreateUnorderedAccessView(pResource, nullptr, pDesc, GetCPUHandle(index));
+		return index;
+	}
+
+	uint32_t BindlessDescriptorHeap::CreateConstantBufferView(D3D12_CONSTANT_BUFFER_VIEW_DESC const& Desc)
+	{
+		RSIM_ASSERT(m_Type == D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+		uint32_t const index = CheckedAllocate();
+		if (index != InvalidIndex)
+			m_pDevice->CreateConstantBufferView(&Desc, GetCPUHandle(index));
+		return index;
+	}
+
+	uint32_t BindlessDescriptorHeap::CreateSampler(D3D12_SAMPLER_DESC const& Desc)
+	{
+		RSIM_ASSERT(m_Type == D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER);
+		uint32_t const index = CheckedAllocate();
+		if (index != InvalidIndex)
+			m_pDevice->CreateSampler(&Desc, GetCPUHandle(index));
+		return index;
+	}
+
+	D3D12_CPU_DESCRIPTOR_HANDLE BindlessDescriptorHeap::GetCPUHandle(uint32_t Index) const
+	{
+		return D3D12_CPU_DESCRIPTOR_HANDLE{ m_CPUStart.ptr + (SIZE_T)Index * m_DescriptorSize };
+	}
+
+	D3D12_GPU_DESCRIPTOR_HANDLE BindlessDescriptorHeap::GetGPUHandle(uint32_t Index) const
+	{
+		return D3D12_GPU_DESCRIPTOR_HANDLE{ m_GPUStart.ptr + (UINT64)Index * m_DescriptorSize };
+	}
+
+	uint32_t BindlessDescriptorHeap::GetNumFreeDescriptors() const
+	{
+		std::lock_guard lock(m_Mutex);
+		return (uint32_t)m_Allocator.GetFreeSize();
+	}
+}
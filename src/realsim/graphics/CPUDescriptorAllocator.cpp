@@ -0,0 +1,72 @@
+#include "realsim/graphics/CPUDescriptorAllocator.h"
+#include "realsim/graphics/Exception.h"
+
+#include <algorithm>
+
+namespace RSim::Graphics
+{
+	CPUDescriptorAllocator::CPUDescriptorAllocator(ID3D12Device2* pDevice, D3D12_DESCRIPTOR_HEAP_TYPE Type, uint32_t DescriptorsPerPage)
+		: m_pDevice(pDevice), m_Type(Type), m_DescriptorsPerPage(DescriptorsPerPage),
+		m_DescriptorSize(pDevice->GetDescriptorHandleIncrementSize(Type))
+	{
+		RSIM_ASSERT(DescriptorsPerPage > 0);
+	}
+
+	DescriptorAllocation CPUDescriptorAllocator::Allocate(uint32_t NumDescriptors)
+	{
+		RSIM_ASSERT(NumDescriptors > 0);
+		std::lock_guard lock(m_Mutex);
+
+		for (std::size_t i = 0; i < m_Pages.size(); ++i)
+		{
+			Page& page = *m_Pages[i];
+			if (page.Allocator.GetFreeSize() < NumDescriptors)
+				continue;
+
+			auto const allocation = page.Allocator.Allocate(NumDescriptors);
+			if (allocation.IsValid())
+			{
+				return DescriptorAllocation{ D3D12_CPU_DESCRIPTOR_HANDLE{ page.Start.ptr + allocation.Offset * m_DescriptorSize },
+					NumDescriptors, (uint32_t)i, (uint32_t)allocation.Offset, m_DescriptorSize };
+			}
+		}
+
+		Page& page = CreatePage(std::max(NumDescriptors, m_DescriptorsPerPage));
+		auto const allocation = page.Allocator.Allocate(NumDescriptors);
+		return DescriptorAllocation{ D3D12_CPU_DESCRIPTOR_HANDLE{ page.Start.ptr + allocation.Offset * m_DescriptorSize },
+			NumDescriptors, (uint32_t)(m_Pages.size() - 1), (uint32_t)allocation.Offset, m_DescriptorSize };
+	}
+
+	void CPUDescriptorAllocator::Free(DescriptorAllocation& Allocation)
+	{
+		if (!Allocation.IsValid())
+			return;
+
+		std::lock_guard lock(m_Mutex);
+		RSIM_ASSERTM(Allocation.PageIndex < m_Pages.size(), "The descriptors were not allocated by this allocator.");
+		m_Pages[Allocation.PageIndex]->Allocator.Free(Allocation.Offset, Allocation.NumDescriptors);
+		Allocation = DescriptorAllocation{};
+	}
+
+	std::size_t CPUDescriptorAllocator::GetNumPages() const
+	{
+		std::lock_guard lock(m_Mutex);
+		return m_Pages.size();
+	}
+
+	CPUDescriptorAllocator::Page& CPUDescriptorAllocator::CreatePage(uint32_t NumDescriptors)
+	{
+		auto page = std::make_unique<Page>(NumDescriptors);
+
+		D3D12_DESCRIPTOR_HEAP_DESC heapDesc{};
+		heapDesc.Type = m_Type;
+		heapDesc.NumDescriptors = NumDescriptors;
+		heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+		heapDesc.NodeMask = 0;
+		ThrowIfFailed(m_pDevice->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&page->Heap)));
+		page->Start = page->Heap->GetCPUDescriptorHandleForHeapStart();
+
+		m_Pages.push_back(std::move(page));
+		return *m_Pages.back();
+	}
+}
@@ -0,0 +1,69 @@
+#include "realsim/graphics/CommandContext.h"
+
+#include <algorithm>
+#include <fmt/xchar.h>
+
+namespace RSim::Graphics
+{
+	CommandContextManager::CommandContextManager(ID3D12Device2* pDevice, D3D12_COMMAND_LIST_TYPE CommandType)
+		: m_Device(pDevice), m_CommandType(CommandType), m_AllocatorPool(pDevice, CommandType)
+	{
+	}
+
+	CommandContext CommandContextManager::RequestContext(uint64_t CompletedFenceValue, ID3D12PipelineState* pInitialState)
+	{
+		CommandContext context{};
+		context.CmdAllocator = m_AllocatorPool.RequestCommandAllocator(CompletedFenceValue);
+
+		{
+			std::lock_guard lock(m_Mutex);
+			if (!m_FreeCmdLists.empty())
+			{
+				context.CmdList = std::move(m_FreeCmdLists.back());
+				m_FreeCmdLists.pop_back();
+			}
+			m_PeakActiveContexts = std::max(m_PeakActiveContexts, ++m_NumActiveContexts);
+		}
+
+		if (context.CmdList)
+		{
+			ThrowIfFailed(context.CmdList->Reset(context.CmdAllocator.Get(), pInitialState));
+		}
+		else
+		{
+			// A newly created command list is already open, recording into the allocator it was created with.
+			ThrowIfFailed(m_Device->CreateCommandList(0, m_CommandType, context.CmdAllocator.Get(), pInitialState, IID_PPV_ARGS(&context.CmdList)));
+
+			std::lock_guard lock(m_Mutex);
+			context.CmdList->SetName(fmt::format(L"Command List {0}", m_NumCmdLists++).c_str());
+		}
+		return context;
+	}
+
+	void CommandContextManager::DiscardContext(uint64_t FenceValue, CommandContext& Context)
+	{
+		m_AllocatorPool.DiscardAllocator(FenceValue, Context.CmdAllocator);
+
+		std::lock_guard lock(m_Mutex);
+		m_FreeCmdLists.push_back(std::move(Context.CmdList));
+		--m_NumActiveContexts;
+		Context = CommandContext{};
+	}
+
+	void CommandContextManager::ReleaseIdleAllocators(uint64_t CompletedFenceValue)
+	{
+		size_t NumToKeep;
+		{
+			std::lock_guard lock(m_Mutex);
+			NumToKeep = m_PeakActiveContexts;
+			m_PeakActiveContexts = m_NumActiveContexts;
+		}
+		m_AllocatorPool.ReleaseIdleAllocators(CompletedFenceValue, NumToKeep);
+	}
+
+	size_t CommandContextManager::GetNumActiveContexts() const
+	{
+		std::lock_guard lock(m_Mutex);
+		return m_NumActiveContexts;
+	}
+}
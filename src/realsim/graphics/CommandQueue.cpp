@@ -24,7 +24,7 @@ namespace RSim::Graphics
 		m_hFenceEvent = CreateEventEx(NULL, false, false, EVENT_ALL_ACCESS);
 		assert(m_hFenceEvent != INVALID_HANDLE_VALUE);
 
-		m_AllocatorPool = std::make_unique<CommandAllocatorPool>(pDevice, CommandType);
+		m_ContextManager = std::make_unique<CommandContextManager>(pDevice, CommandType);
 		assert(m_CmdQueue);
 	}
 
@@ -87,17 +87,42 @@ namespace RSim::Graphics
 
 	uint64_t CommandQueue::ExecuteCommandList(ID3D12CommandList* pCommandList)
 	{
-		std::lock_guard lock(m_FenceMutex);
+		return ExecuteCommandLists(&pCommandList, 1);
+	}
+
+	uint64_t CommandQueue::ExecuteCommandLists(ID3D12CommandList* const* ppCommandLists, uint32_t NumCommandLists)
+	{
+		// Closing only touches the lists themselves, so it is kept out of the fence lock.
+		for (uint32_t i = 0; i < NumCommandLists; ++i)
+		{
+			ThrowIfFailed(static_cast<ID3D12GraphicsCommandList1*>(ppCommandLists[i])->Close());
+		}
 
-		ThrowIfFailed(static_cast<ID3D12GraphicsCommandList1*>(pCommandList)->Close());
+		std::lock_guard lock(m_FenceMutex);
 
-		m_CmdQueue->ExecuteCommandLists(1, &pCommandList);
+		m_CmdQueue->ExecuteCommandLists(NumCommandLists, ppCommandLists);
 
 		m_CmdQueue->Signal(m_Fence.Get(), m_NextFenceValue);
 
 		return m_NextFenceValue++;
 	}
 
+	CommandContext CommandQueue::RequestContext(ID3D12PipelineState* pInitialState)
+	{
+		// Read the fence directly instead of going through PollCurrentFenceValue, this may be called from several threads at once.
+		return m_ContextManager->RequestContext(m_Fence->GetCompletedValue(), pInitialState);
+	}
+
+	void CommandQueue::DiscardContext(uint64_t FenceValue, CommandContext& Context)
+	{
+		m_ContextManager->DiscardContext(FenceValue, Context);
+	}
+
+	void CommandQueue::ReleaseIdleContexts()
+	{
+		m_ContextManager->ReleaseIdleAllocators(m_Fence->GetCompletedValue());
+	}
+
 	uint64_t CommandQueue::IncrementFence()
 	{
 		std::lock_guard lock(m_FenceMutex);
@@ -0,0 +1,106 @@
+#include "realsim/graphics/DynamicDescriptorAllocator.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace RSim::Graphics
+{
+	DynamicDescriptorAllocator::DynamicDescriptorAllocator(uint32_t FirstDescriptor, uint32_t NumDescriptors, uint32_t ChunkSize)
+		: m_Chunks(NumDescriptors), m_FirstDescriptor(FirstDescriptor), m_ChunkSize(ChunkSize)
+	{
+		RSIM_ASSERT(ChunkSize > 0);
+	}
+
+	uint32_t DynamicDescriptorAllocator::Allocate(uint32_t NumDescriptors)
+	{
+		RSIM_ASSERT(NumDescriptors > 0);
+		if (!m_FrameChunks.empty() && m_CurrentChunkUsed + NumDescriptors <= m_FrameChunks.back().Size)
+		{
+			uint32_t const index = m_FirstDescriptor + (uint32_t)m_FrameChunks.back().Offset + m_CurrentChunkUsed;
+			m_CurrentChunkUsed += NumDescriptors;
+			return index;
+		}
+
+		auto const chunk = m_Chunks.Allocate(std::max(NumDescriptors, m_ChunkSize));
+		if (!chunk.IsValid())
+			return InvalidIndex;
+
+		m_FrameChunks.push_back(chunk);
+		m_CurrentChunkUsed = NumDescriptors;
+		return m_FirstDescriptor + (uint32_t)chunk.Offset;
+	}
+
+	void DynamicDescriptorAllocator::EndFrame(uint64_t FenceValue)
+	{
+		for (auto& chunk : m_FrameChunks)
+		{
+			m_Chunks.Free(chunk, FenceValue);
+		}
+		m_FrameChunks.clear();
+		m_CurrentChunkUsed = 0;
+	}
+
+	void DynamicDescriptorAllocator::ReleaseCompletedFrames(uint64_t CompletedFenceValue)
+	{
+		m_Chunks.ReleaseStaleAllocations(CompletedFenceValue);
+	}
+
+	void DescriptorCopyBatch::Add(std::size_t SourceStart, std::size_t SourceHeap, std::size_t DestStart, std::size_t DestHeap,
+		uint32_t NumDescriptors)
+	{
+		if (NumDescriptors == 0)
+			return;
+		AddRange(m_SourceStarts, m_SourceSizes, m_LastSourceHeap, SourceStart, SourceHeap, NumDescriptors, m_DescriptorSize);
+		AddRange(m_DestStarts, m_DestSizes, m_LastDestHeap, DestStart, DestHeap, NumDescriptors, m_DescriptorSize);
+		m_NumDescriptors += NumDescriptors;
+	}
+
+	void DescriptorCopyBatch::Clear()
+	{
+		m_SourceStarts.clear();
+		m_SourceSizes.clear();
+		m_DestStarts.clear();
+		m_DestSizes.clear();
+		m_NumDescriptors = 0;
+	}
+
+	void DescriptorCopyBatch::AddRange(std::vector<std::size_t>& Starts, std::vector<uint32_t>& Sizes, std::size_t& LastHeap,
+		std::size_t Start, std::size_t Heap, uint32_t NumDescriptors, uint32_t DescriptorSize)
+	{
+		if (!Starts.empty() && LastHeap == Heap && Starts.back() + (std::size_t)Sizes.back() * DescriptorSize == Start)
+		{
+			Sizes.back() += NumDescriptors;
+			return;
+		}
+		Starts.push_back(Start);
+		Sizes.push_back(NumDescriptors);
+		LastHeap = Heap;
+	}
+
+	void DescriptorCopyBatch::EmulateCopy() const
+	{
+		// Both sides cover the same descriptors, walk them together and copy the overlap of the current source and destination range.
+		std::size_t sourceRange = 0, destRange = 0;
+		uint32_t sourceOffset = 0, destOffset = 0;
+		while (sourceRange < m_SourceStarts.size() && destRange < m_DestStarts.size())
+		{
+			uint32_t const count = std::min(m_SourceSizes[sourceRange] - sourceOffset, m_DestSizes[destRange] - destOffset);
+			std::memcpy(reinterpret_cast<void*>(m_DestStarts[destRange] + (std::size_t)destOffset * m_DescriptorSize),
+				reinterpret_cast<void const*>(m_SourceStarts[sourceRange] + (std::size_t)sourceOffset * m_DescriptorSize),
+				(std::size_t)count * m_DescriptorSize);
+
+			sourceOffset += count;
+			destOffset += count;
+			if (sourceOffset == m_SourceSizes[sourceRange])
+			{
+				++sourceRange;
+				sourceOffset = 0;
+			}
+			if (destOffset == m_DestSizes[destRange])
+			{
+				++destRange;
+				destOffset = 0;
+			}
+		}
+	}
+}
@@ -0,0 +1,55 @@
+#include "realsim/graphics/FrameLatencyTracker.h"
+
+#include <algorithm>
+
+namespace RSim::Graphics
+{
+	namespace
+	{
+		/**
+		 * \brief Weight of the newest sample in the smoothed statistics.
+		 */
+		constexpr float StatisticsSmoothing = 0.1f;
+
+		void Smooth(float& average, float sample, uint64_t frameCount)
+		{
+			average = frameCount == 0 ? sample : average + (sample - average) * StatisticsSmoothing;
+		}
+	}
+
+	FrameLatencyTracker::FrameLatencyTracker(uint32_t MaxFrameLatency)
+	{
+		SetMaxFrameLatency(MaxFrameLatency);
+	}
+
+	void FrameLatencyTracker::SetMaxFrameLatency(uint32_t MaxFrameLatency)
+	{
+		m_MaxFrameLatency = std::clamp<uint32_t>(MaxFrameLatency, 1U, (uint32_t)NumFramesInFlight);
+	}
+
+	std::optional<uint64_t> FrameLatencyTracker::GetFenceValueToWaitFor() const
+	{
+		if (m_FrameNumber < m_MaxFrameLatency)
+			return std::nullopt;
+		return m_FrameFenceValues[(m_FrameNumber - m_MaxFrameLatency) % NumFramesInFlight];
+	}
+
+	void FrameLatencyTracker::EndFrame(uint64_t FrameFenceValue, uint64_t CompletedFenceValue, float FrameTimeMs, float WaitTimeMs)
+	{
+		m_FrameFenceValues[m_FrameNumber % NumFramesInFlight] = FrameFenceValue;
+		++m_FrameNumber;
+
+		uint64_t framesInFlight = 0;
+		for (uint64_t const fenceValue : m_FrameFenceValues)
+		{
+			framesInFlight += fenceValue > CompletedFenceValue ? 1 : 0;
+		}
+
+		Smooth(m_Statistics.CPUFrameTimeMs, FrameTimeMs, m_Statistics.FrameCount);
+		Smooth(m_Statistics.CPUWaitTimeMs, WaitTimeMs, m_Statistics.FrameCount);
+		Smooth(m_Statistics.FramesInFlight, (float)framesInFlight, m_Statistics.FrameCount);
+		m_Statistics.CPUBusyRatio = m_Statistics.CPUFrameTimeMs > 0.0f ?
+			1.0f - m_Statistics.CPUWaitTimeMs / m_Statistics.CPUFrameTimeMs : 0.0f;
+		++m_Statistics.FrameCount;
+	}
+}
@@ -0,0 +1,84 @@
+#include "realsim/graphics/FramePacer.h"
+#include "realsim/core/Logger.h"
+
+namespace RSim::Graphics
+{
+	FramePacer::FramePacer(SwapChain const& swapChain, CommandQueue& queue, FramePacingDesc const& desc, bool tearingSupported)
+		: m_SwapChain(swapChain), m_Queue(queue), m_TearingSupported(tearingSupported), m_Tracker(desc.MaxFrameLatency)
+	{
+		m_FrameLatencyWaitableObject = m_SwapChain.GetFrameLatencyWaitableObject();
+		SetDesc(desc);
+		m_FrameStart = Clock::now();
+	}
+
+	FramePacer::~FramePacer()
+	{
+		if (m_FrameLatencyWaitableObject)
+			CloseHandle(m_FrameLatencyWaitableObject);
+	}
+
+	void FramePacer::BeginFrame()
+	{
+		auto const waitStart = Clock::now();
+
+		// Returns as soon as the swap chain has fewer than MaxFrameLatency presents queued.
+		if (m_FrameLatencyWaitableObject)
+		{
+			DWORD const waitResult = ::WaitForSingleObjectEx(m_FrameLatencyWaitableObject, FrameLatencyWaitTimeoutMs, TRUE);
+			if (waitResult == WAIT_TIMEOUT)
+			{
+				rsim_warn("The swap chain did not release a frame within {0}ms, starting the frame anyway.", FrameLatencyWaitTimeoutMs);
+			}
+			else if (waitResult == WAIT_FAILED)
+			{
+				rsim_error("Waiting on the swap chain's frame latency waitable object failed, error code {0}.", ::GetLastError());
+			}
+		}
+
+		// The swap chain only limits queued presents; the fence makes sure the GPU itself is no more than MaxFrameLatency frames behind.
+		if (auto const fenceValue = m_Tracker.GetFenceValueToWaitFor())
+		{
+			m_Queue.WaitForFence(*fenceValue);
+		}
+
+		m_FrameWaitTime = Clock::now() - waitStart;
+	}
+
+	void FramePacer::EndFrame(uint64_t frameFenceValue)
+	{
+		auto const now = Clock::now();
+		float const frameTime = ToMilliseconds(now - m_FrameStart);
+		float const waitTime = ToMilliseconds(m_FrameWaitTime);
+		m_FrameStart = now;
+
+		m_Tracker.EndFrame(frameFenceValue, m_Queue.PollCurrentFenceValue(), frameTime, waitTime);
+	}
+
+	void FramePacer::SetDesc(FramePacingDesc const& desc)
+	{
+		m_Desc = desc;
+		m_Tracker.SetMaxFrameLatency(desc.MaxFrameLatency);
+		m_Desc.MaxFrameLatency = m_Tracker.GetMaxFrameLatency();
+		if (m_Desc.Mode == PresentMode::Tearing && !m_TearingSupported)
+		{
+			rsim_warn("Tearing is not supported on this display, falling back to PresentMode::Uncapped.");
+			m_Desc.Mode = PresentMode::Uncapped;
+		}
+		m_SwapChain.SetMaximumFrameLatency(m_Desc.MaxFrameLatency);
+	}
+
+	UINT FramePacer::GetSyncInterval() const
+	{
+		return m_Desc.Mode == PresentMode::VSync ? 1 : 0;
+	}
+
+	UINT FramePacer::GetPresentFlags() const
+	{
+		return m_Desc.Mode == PresentMode::Tearing ? DXGI_PRESENT_ALLOW_TEARING : 0;
+	}
+
+	float FramePacer::ToMilliseconds(Clock::duration duration)
+	{
+		return std::chrono::duration<float, std::milli>(duration).count();
+	}
+}
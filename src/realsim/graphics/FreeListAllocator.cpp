@@ -3,7 +3,7 @@
 namespace RSim::Graphics
 {
 	FreeListAllocator::FreeListAllocator(OffsetType MaxSize)
-		: m_FreeSize(MaxSize)
+		: m_MaxSize(MaxSize), m_FreeSize(MaxSize)
 	{
 		AddNewBlock(0ULL, MaxSize);
 	}
@@ -52,6 +52,7 @@ namespace RSim::Graphics
 			AddNewBlock(NewOffset, NewSize);
 		}
 
+		m_FreeSize -= Size;
 		return { Offset, Size };
 	}
 
@@ -82,7 +83,7 @@ namespace RSim::Graphics
 				// |                          |                    |
 				// |<-----PrevBlock.Size----->|<------Size-------->|<-----NextBlock.Size----->|
 				//
-				NewSize += NextBlockIt->first;
+				NewSize += NextBlockIt->second.Size;
 				m_FreeBlocksBySize.erase(PrevBlockIt->second.OrderBySizeIt);
 				m_FreeBlocksBySize.erase(NextBlockIt->second.OrderBySizeIt);
 				++NextBlockIt;
@@ -98,7 +99,7 @@ namespace RSim::Graphics
 				m_FreeBlocksByOffset.erase(PrevBlockIt);
 			}
 		}
-		else if (PrevBlockIt != m_FreeBlocksByOffset.end() && Offset + Size == NextBlockIt->first)
+		else if (NextBlockIt != m_FreeBlocksByOffset.end() && Offset + Size == NextBlockIt->first)
 		{
 			//   PrevBlock.Offset                      Offset              NextBlock.Offset
 			//     |                                  |                    |
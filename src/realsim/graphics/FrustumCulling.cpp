@@ -0,0 +1,230 @@
+#include "realsim/graphics/FrustumCulling.h"
+#include "realsim/core/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define RSIM_FRUSTUM_CULLING_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RSIM_FRUSTUM_CULLING_SSE 1
+#endif
+
+namespace RSim::Graphics
+{
+	namespace
+	{
+		FrustumPlane MakePlane(float const (&M)[4][4], int Column, float Sign, int WColumn)
+		{
+			// Row-vector convention: clip.c = dot(v, column c). The plane is w +- c >= 0, or c >= 0 for the near plane.
+			FrustumPlane plane{
+				Sign * M[0][Column] + (WColumn >= 0 ? M[0][WColumn] : 0.0f),
+				Sign * M[1][Column] + (WColumn >= 0 ? M[1][WColumn] : 0.0f),
+				Sign * M[2][Column] + (WColumn >= 0 ? M[2][WColumn] : 0.0f),
+				Sign * M[3][Column] + (WColumn >= 0 ? M[3][WColumn] : 0.0f) };
+
+			float const length = std::sqrt(plane.NormalX * plane.NormalX + plane.NormalY * plane.NormalY + plane.NormalZ * plane.NormalZ);
+			if (length > 0.0f)
+			{
+				plane.NormalX /= length; plane.NormalY /= length; plane.NormalZ /= length; plane.Distance /= length;
+			}
+			return plane;
+		}
+
+		/**
+		 * \brief Appends Base + lane for every lane set in VisibleMask that is a real box and not padding.
+		 */
+		void AppendVisible(int VisibleMask, std::size_t Base, std::size_t NumLanes, std::size_t Count, std::vector<uint32_t>& VisibleIndices)
+		{
+			for (std::size_t lane = 0; lane < NumLanes; ++lane)
+			{
+				if ((VisibleMask >> lane & 1) && Base + lane < Count)
+					VisibleIndices.push_back((uint32_t)(Base + lane));
+			}
+		}
+	}
+
+	Frustum Frustum::FromViewProjection(float const (&ViewProjection)[4][4])
+	{
+		Frustum frustum{};
+		frustum.Planes[0] = MakePlane(ViewProjection, 0, 1.0f, 3);  // Left:   w + x >= 0
+		frustum.Planes[1] = MakePlane(ViewProjection, 0, -1.0f, 3); // Right:  w - x >= 0
+		frustum.Planes[2] = MakePlane(ViewProjection, 1, 1.0f, 3);  // Bottom: w + y >= 0
+		frustum.Planes[3] = MakePlane(ViewProjection, 1, -1.0f, 3); // Top:    w - y >= 0
+		frustum.Planes[4] = MakePlane(ViewProjection, 2, 1.0f, -1); // Near:   z >= 0
+		frustum.Planes[5] = MakePlane(ViewProjection, 2, -1.0f, 3); // Far:    w - z >= 0
+		return frustum;
+	}
+
+	void BoundingBoxes::Resize(std::size_t Count)
+	{
+		m_Count = Count;
+		std::size_t const paddedCount = (Count + Padding - 1) / Padding * Padding;
+		for (auto* pArray : { &m_CenterX, &m_CenterY, &m_CenterZ, &m_ExtentX, &m_ExtentY, &m_ExtentZ })
+		{
+			pArray->resize(paddedCount, 0.0f);
+		}
+	}
+
+	void BoundingBoxes::SetTransformed(std::size_t Index, float const (&World)[4][4], float const (&LocalCenter)[3], float const (&LocalExtent)[3])
+	{
+		// The center transforms as a point; the extent along each world axis is the sum of the absolute projections of the local axes.
+		float center[3];
+		float extent[3];
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			center[axis] = World[3][axis];
+			extent[axis] = 0.0f;
+			for (int i = 0; i < 3; ++i)
+			{
+				center[axis] += LocalCenter[i] * World[i][axis];
+				extent[axis] += LocalExtent[i] * std::abs(World[i][axis]);
+			}
+		}
+		Set(Index, center[0], center[1], center[2], extent[0], extent[1], extent[2]);
+	}
+
+	std::size_t FrustumCuller::Cull(Frustum const& Frustum, BoundingBoxes const& Boxes, Core::ThreadPool* pPool)
+	{
+		m_VisibleIndices.clear();
+
+		// Tasks work on whole blocks of Padding boxes so that every SIMD load stays inside the padded arrays.
+		std::size_t const numBlocks = (Boxes.Size() + BoundingBoxes::Padding - 1) / BoundingBoxes::Padding;
+		std::size_t const minBlocksPerTask = MinBoxesPerTask / BoundingBoxes::Padding;
+		auto const cullBlocks = [&](std::size_t Begin, std::size_t End, std::size_t TaskIndex)
+		{
+			auto& visibleIndices = m_TaskVisibleIndices[TaskIndex];
+			visibleIndices.clear();
+			CullRange(Frustum, Boxes, Begin * BoundingBoxes::Padding, End * BoundingBoxes::Padding, visibleIndices);
+		};
+
+		std::size_t numTasks;
+		if (pPool)
+		{
+			m_TaskVisibleIndices.resize(std::max(m_TaskVisibleIndices.size(), pPool->GetMaxParallelism()));
+			numTasks = pPool->ParallelFor(numBlocks, minBlocksPerTask, cullBlocks);
+		}
+		else
+		{
+			m_TaskVisibleIndices.resize(std::max<std::size_t>(m_TaskVisibleIndices.size(), 1));
+			numTasks = numBlocks > 0 ? 1 : 0;
+			if (numTasks > 0)
+				cullBlocks(0, numBlocks, 0);
+		}
+
+		// The ranges are contiguous and in task order, so concatenating the lists keeps the indices sorted.
+		for (std::size_t i = 0; i < numTasks; ++i)
+		{
+			m_VisibleIndices.insert(m_VisibleIndices.end(), m_TaskVisibleIndices[i].begin(), m_TaskVisibleIndices[i].end());
+		}
+		return m_VisibleIndices.size();
+	}
+
+	bool FrustumCuller::IsVisible(Frustum const& Frustum, BoundingBoxes const& Boxes, std::size_t Index)
+	{
+		for (FrustumPlane const& plane : Frustum.Planes)
+		{
+			// Same operations in the same order as the SIMD paths, so that boxes right on a plane get the same answer on every path.
+			float distance = plane.NormalX * Boxes.CenterX()[Index] + plane.Distance;
+			distance += plane.NormalY * Boxes.CenterY()[Index];
+			distance += plane.NormalZ * Boxes.CenterZ()[Index];
+			float radius = std::abs(plane.NormalX) * Boxes.ExtentX()[Index];
+			radius += std::abs(plane.NormalY) * Boxes.ExtentY()[Index];
+			radius += std::abs(plane.NormalZ) * Boxes.ExtentZ()[Index];
+			if (distance + radius < 0.0f)
+				return false;
+		}
+		return true;
+	}
+
+	void FrustumCuller::CullRange(Frustum const& Frustum, BoundingBoxes const& Boxes, std::size_t Begin, std::size_t End,
+		std::vector<uint32_t>& VisibleIndices)
+	{
+		std::size_t const count = Boxes.Size();
+		float const* const pCenterX = Boxes.CenterX();
+		float const* const pCenterY = Boxes.CenterY();
+		float const* const pCenterZ = Boxes.CenterZ();
+		float const* const pExtentX = Boxes.ExtentX();
+		float const* const pExtentY = Boxes.ExtentY();
+		float const* const pExtentZ = Boxes.ExtentZ();
+
+#if defined(RSIM_FRUSTUM_CULLING_AVX)
+		struct WidePlane { __m256 NormalX, NormalY, NormalZ, Distance, AbsNormalX, AbsNormalY, AbsNormalZ; };
+		std::array<WidePlane, 6> planes;
+		for (std::size_t p = 0; p < planes.size(); ++p)
+		{
+			FrustumPlane const& plane = Frustum.Planes[p];
+			planes[p] = WidePlane{ _mm256_set1_ps(plane.NormalX), _mm256_set1_ps(plane.NormalY), _mm256_set1_ps(plane.NormalZ),
+				_mm256_set1_ps(plane.Distance), _mm256_set1_ps(std::abs(plane.NormalX)), _mm256_set1_ps(std::abs(plane.NormalY)),
+				_mm256_set1_ps(std::abs(plane.NormalZ)) };
+		}
+		__m256 const zero = _mm256_setzero_ps();
+
+		for (std::size_t i = Begin; i < End; i += 8)
+		{
+			__m256 const centerX = _mm256_loadu_ps(pCenterX + i);
+			__m256 const centerY = _mm256_loadu_ps(pCenterY + i);
+			__m256 const centerZ = _mm256_loadu_ps(pCenterZ + i);
+			__m256 const extentX = _mm256_loadu_ps(pExtentX + i);
+			__m256 const extentY = _mm256_loadu_ps(pExtentY + i);
+			__m256 const extentZ = _mm256_loadu_ps(pExtentZ + i);
+
+			__m256 outside = zero;
+			for (WidePlane const& plane : planes)
+			{
+				__m256 distance = _mm256_add_ps(_mm256_mul_ps(plane.NormalX, centerX), plane.Distance);
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(plane.NormalY, centerY));
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(plane.NormalZ, centerZ));
+				__m256 radius = _mm256_mul_ps(plane.AbsNormalX, extentX);
+				radius = _mm256_add_ps(radius, _mm256_mul_ps(plane.AbsNormalY, extentY));
+				radius = _mm256_add_ps(radius, _mm256_mul_ps(plane.AbsNormalZ, extentZ));
+				outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_LT_OQ));
+			}
+			AppendVisible(~_mm256_movemask_ps(outside) & 0xFF, i, 8, count, VisibleIndices);
+		}
+#elif defined(RSIM_FRUSTUM_CULLING_SSE)
+		struct WidePlane { __m128 NormalX, NormalY, NormalZ, Distance, AbsNormalX, AbsNormalY, AbsNormalZ; };
+		std::array<WidePlane, 6> planes;
+		for (std::size_t p = 0; p < planes.size(); ++p)
+		{
+			FrustumPlane const& plane = Frustum.Planes[p];
+			planes[p] = WidePlane{ _mm_set1_ps(plane.NormalX), _mm_set1_ps(plane.NormalY), _mm_set1_ps(plane.NormalZ),
+				_mm_set1_ps(plane.Distance), _mm_set1_ps(std::abs(plane.NormalX)), _mm_set1_ps(std::abs(plane.NormalY)),
+				_mm_set1_ps(std::abs(plane.NormalZ)) };
+		}
+		__m128 const zero = _mm_setzero_ps();
+
+		for (std::size_t i = Begin; i < End; i += 4)
+		{
+			__m128 const centerX = _mm_loadu_ps(pCenterX + i);
+			__m128 const centerY = _mm_loadu_ps(pCenterY + i);
+			__m128 const centerZ = _mm_loadu_ps(pCenterZ + i);
+			__m128 const extentX = _mm_loadu_ps(pExtentX + i);
+			__m128 const extentY = _mm_loadu_ps(pExtentY + i);
+			__m128 const extentZ = _mm_loadu_ps(pExtentZ + i);
+
+			__m128 outside = zero;
+			for (WidePlane const& plane : planes)
+			{
+				__m128 distance = _mm_add_ps(_mm_mul_ps(plane.NormalX, centerX), plane.Distance);
+				distance = _mm_add_ps(distance, _mm_mul_ps(plane.NormalY, centerY));
+				distance = _mm_add_ps(distance, _mm_mul_ps(plane.NormalZ, centerZ));
+				__m128 radius = _mm_mul_ps(plane.AbsNormalX, extentX);
+				radius = _mm_add_ps(radius, _mm_mul_ps(plane.AbsNormalY, extentY));
+				radius = _mm_add_ps(radius, _mm_mul_ps(plane.AbsNormalZ, extentZ));
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+			}
+			AppendVisible(~_mm_movemask_ps(outside) & 0xF, i, 4, count, VisibleIndices);
+		}
+#else
+		for (std::size_t i = Begin; i < std::min(End, count); ++i)
+		{
+			if (IsVisible(Frustum, Boxes, i))
+				VisibleIndices.push_back((uint32_t)i);
+		}
+		(void)pCenterX; (void)pCenterY; (void)pCenterZ; (void)pExtentX; (void)pExtentY; (void)pExtentZ;
+#endif
+	}
+}
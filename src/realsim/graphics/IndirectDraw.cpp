@@ -0,0 +1,120 @@
+#include "realsim/graphics/IndirectDraw.h"
+#include "realsim/math/Alignment.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace RSim::Graphics
+{
+	void IndirectDrawBuilder::Build(InstanceGroupKey const* pKeys, std::size_t NumInstances, IndirectMesh const* pMeshes,
+		std::size_t NumMeshes, std::size_t NumViews)
+	{
+		m_Batcher.Build(pKeys, NumInstances);
+		m_Meshes.assign(pMeshes, pMeshes + NumMeshes);
+		m_NumViews = NumViews;
+
+		m_SlotGroups.resize(NumInstances);
+		std::vector<InstanceGroup> const& groups = m_Batcher.GetGroups();
+		for (uint32_t g = 0; g < (uint32_t)groups.size(); ++g)
+		{
+			std::fill_n(m_SlotGroups.begin() + groups[g].FirstInstance, groups[g].NumInstances, g);
+		}
+
+		m_MeshesOffset = Math::AlignUp(NumInstances * sizeof(GPUInstance), SectionAlignment);
+		m_CommandTemplateOffset = m_MeshesOffset + Math::AlignUp(NumMeshes * sizeof(IndirectMesh), SectionAlignment);
+		m_ZeroCountsOffset = m_CommandTemplateOffset + Math::AlignUp(GetCommandTemplateSize(), SectionAlignment);
+		m_UploadSize = m_ZeroCountsOffset + GetCountBufferSize();
+	}
+
+	void IndirectDrawBuilder::WriteInstance(void* pUpload, std::size_t DrawIndex, DirectX::XMFLOAT4X4 const& World,
+		DirectX::XMFLOAT4 const& Color) const
+	{
+		uint32_t const slot = m_Batcher.GetInstanceIndex(DrawIndex);
+		uint32_t const group = m_SlotGroups[slot];
+
+		GPUInstance& instance = static_cast<GPUInstance*>(pUpload)[slot];
+		instance.World = World;
+		instance.Color = Color;
+		instance.GroupIndex = group;
+		instance.MeshIndex = m_Batcher.GetGroups()[group].Key.MeshID;
+		instance.Padding[0] = instance.Padding[1] = 0;
+	}
+
+	void IndirectDrawBuilder::WriteTables(void* pUpload) const
+	{
+		auto* const pBytes = static_cast<std::byte*>(pUpload);
+		std::memcpy(pBytes + m_MeshesOffset, m_Meshes.data(), m_Meshes.size() * sizeof(IndirectMesh));
+
+		auto* const pTemplate = reinterpret_cast<IndirectCommand*>(pBytes + m_CommandTemplateOffset);
+		std::vector<InstanceGroup> const& groups = m_Batcher.GetGroups();
+		for (std::size_t g = 0; g < groups.size(); ++g)
+		{
+			IndirectMesh const& mesh = m_Meshes[groups[g].Key.MeshID];
+
+			IndirectCommand& command = pTemplate[g];
+			// The slots of a view's visible instances start at the group's range of the instance buffer, offset by the view.
+			command.FirstInstance = groups[g].FirstInstance;
+			command.Draw.IndexCountPerInstance = mesh.NumIndices;
+			command.Draw.InstanceCount = 0;
+			command.Draw.StartIndexLocation = mesh.FirstIndex;
+			command.Draw.BaseVertexLocation = mesh.BaseVertex;
+			// SV_InstanceID does not include it, the shaders add FirstInstance themselves.
+			command.Draw.StartInstanceLocation = 0;
+		}
+
+		std::memset(pBytes + m_ZeroCountsOffset, 0, GetCountBufferSize());
+	}
+
+	CullConstants IndirectDrawBuilder::GetCullConstants(std::size_t ViewIndex, Frustum const& ViewFrustum) const
+	{
+		CullConstants constants{};
+		for (std::size_t p = 0; p < ViewFrustum.Planes.size(); ++p)
+		{
+			constants.Planes[p] = ViewFrustum.Planes[p];
+		}
+		constants.NumInstances = (uint32_t)GetNumInstances();
+		constants.NumGroups = (uint32_t)GetNumGroups();
+		constants.ViewIndex = (uint32_t)ViewIndex;
+		return constants;
+	}
+
+	void IndirectDrawBuilder::EmulateCulling(CullConstants const& Constants, GPUInstance const* pInstances, IndirectMesh const* pMeshes,
+		IndirectCommand* pGroupCommands, uint32_t* pVisibleInstances, IndirectCommand* pCommands, uint32_t* pCounts)
+	{
+		Frustum frustum{};
+		for (std::size_t p = 0; p < frustum.Planes.size(); ++p)
+		{
+			frustum.Planes[p] = Constants.Planes[p];
+		}
+
+		std::size_t const firstCommand = (std::size_t)Constants.ViewIndex * Constants.NumGroups;
+		std::size_t const firstVisibleInstance = (std::size_t)Constants.ViewIndex * Constants.NumInstances;
+
+		// Culling pass, one thread per instance.
+		BoundingBoxes bounds;
+		bounds.Resize(1);
+		for (uint32_t i = 0; i < Constants.NumInstances; ++i)
+		{
+			GPUInstance const& instance = pInstances[i];
+			IndirectMesh const& mesh = pMeshes[instance.MeshIndex];
+			bounds.SetTransformed(0, instance.World.m, mesh.LocalCenter, mesh.LocalExtent);
+			if (!FrustumCuller::IsVisible(frustum, bounds, 0))
+				continue;
+
+			IndirectCommand& group = pGroupCommands[firstCommand + instance.GroupIndex];
+			uint32_t const slot = group.Draw.InstanceCount++;
+			pVisibleInstances[firstVisibleInstance + group.FirstInstance + slot] = i;
+		}
+
+		// Compaction pass, one thread per group.
+		for (uint32_t g = 0; g < Constants.NumGroups; ++g)
+		{
+			IndirectCommand command = pGroupCommands[firstCommand + g];
+			if (command.Draw.InstanceCount == 0)
+				continue;
+
+			command.FirstInstance += (uint32_t)firstVisibleInstance;
+			pCommands[firstCommand + pCounts[Constants.ViewIndex]++] = command;
+		}
+	}
+}
@@ -0,0 +1,38 @@
+#include "realsim/graphics/InstanceBatcher.h"
+
+namespace RSim::Graphics
+{
+	void InstanceBatcher::Build(InstanceGroupKey const* pKeys, std::size_t NumDraws)
+	{
+		m_Groups.clear();
+		m_GroupLookup.clear();
+		m_DrawGroups.resize(NumDraws);
+		m_InstanceIndices.resize(NumDraws);
+
+		// Count the instances of every group first, the first instance of each group is then the running sum of the counts before it.
+		for (std::size_t i = 0; i < NumDraws; ++i)
+		{
+			auto const [it, inserted] = m_GroupLookup.try_emplace(pKeys[i].Hash(), (uint32_t)m_Groups.size());
+			if (inserted)
+			{
+				m_Groups.push_back(InstanceGroup{ pKeys[i], 0, 0 });
+			}
+			m_DrawGroups[i] = it->second;
+			++m_Groups[it->second].NumInstances;
+		}
+
+		uint32_t firstInstance = 0;
+		for (auto& group : m_Groups)
+		{
+			group.FirstInstance = firstInstance;
+			firstInstance += group.NumInstances;
+			group.NumInstances = 0;
+		}
+
+		for (std::size_t i = 0; i < NumDraws; ++i)
+		{
+			InstanceGroup& group = m_Groups[m_DrawGroups[i]];
+			m_InstanceIndices[i] = group.FirstInstance + group.NumInstances++;
+		}
+	}
+}
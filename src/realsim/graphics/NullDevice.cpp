@@ -0,0 +1,249 @@
+#include "realsim/graphics/NullDevice.h"
+#include "realsim/math/Alignment.h"
+
+#include <algorithm>
+
+namespace RSim::Graphics
+{
+	NullFence::NullFence(uint64_t InitialValue) : m_CompletedValue(InitialValue)
+	{
+	}
+
+	uint64_t NullFence::GetCompletedValue() const
+	{
+		std::lock_guard lock(m_Mutex);
+		RetirePendingSignals(Clock::now());
+		return m_CompletedValue;
+	}
+
+	void NullFence::Signal(uint64_t Value)
+	{
+		{
+			std::lock_guard lock(m_Mutex);
+			m_CompletedValue = std::max(m_CompletedValue, Value);
+		}
+		m_ValueChanged.notify_all();
+	}
+
+	void NullFence::WaitForValue(uint64_t Value) const
+	{
+		std::unique_lock lock(m_Mutex);
+		while (true)
+		{
+			RetirePendingSignals(Clock::now());
+			if (m_CompletedValue >= Value)
+				return;
+
+			// Sleep until the next scheduled signal lands or until the timeline schedules a new one.
+			if (m_PendingSignals.empty())
+				m_ValueChanged.wait(lock);
+			else
+				m_ValueChanged.wait_until(lock, m_PendingSignals.front().CompletionTime);
+		}
+	}
+
+	void NullFence::ScheduleSignal(uint64_t Value, Clock::time_point CompletionTime)
+	{
+		{
+			std::lock_guard lock(m_Mutex);
+			m_PendingSignals.push_back({ Value, CompletionTime });
+		}
+		m_ValueChanged.notify_all();
+	}
+
+	void NullFence::RetirePendingSignals(Clock::time_point Now) const
+	{
+		// The timeline schedules signals in order with a constant latency, so completion times are monotonic.
+		while (!m_PendingSignals.empty() && m_PendingSignals.front().CompletionTime <= Now)
+		{
+			m_CompletedValue = std::max(m_CompletedValue, m_PendingSignals.front().Value);
+			m_PendingSignals.pop_front();
+		}
+	}
+
+	void NullCommandAllocator::Reset()
+	{
+		m_NumRecordedCommands = 0;
+		++m_NumResets;
+	}
+
+	NullCommandList::NullCommandList(NullCommandListType Type, NullCommandAllocator* pAllocator)
+		: m_Type(Type), m_pAllocator(pAllocator)
+	{
+		RSIM_ASSERT(pAllocator && pAllocator->GetType() == Type);
+	}
+
+	void NullCommandList::Reset(NullCommandAllocator* pAllocator)
+	{
+		RSIM_ASSERTM(m_IsClosed, "A command list has to be closed before it can be reset.");
+		RSIM_ASSERT(pAllocator && pAllocator->GetType() == m_Type);
+		m_pAllocator = pAllocator;
+		m_NumCommands = 0;
+		m_IsClosed = false;
+	}
+
+	void NullCommandList::Close()
+	{
+		RSIM_ASSERTM(!m_IsClosed, "The command list is already closed.");
+		m_IsClosed = true;
+	}
+
+	void NullCommandList::RecordCommands(std::size_t NumCommands)
+	{
+		RSIM_ASSERTM(!m_IsClosed, "Recording into a closed command list.");
+		m_NumCommands += NumCommands;
+		m_pAllocator->m_NumRecordedCommands += NumCommands;
+	}
+
+	NullCommandQueue::NullCommandQueue(NullDeviceDesc const& Desc, NullCommandListType Type)
+		: m_Desc(Desc), m_Type(Type)
+	{
+		m_Timeline = std::thread(&NullCommandQueue::RunTimeline, this);
+	}
+
+	NullCommandQueue::~NullCommandQueue()
+	{
+		{
+			std::lock_guard lock(m_Mutex);
+			m_Exit = true;
+		}
+		m_HasOperations.notify_one();
+		m_Timeline.join();
+	}
+
+	void NullCommandQueue::ExecuteCommandLists(uint32_t NumCommandLists, NullCommandList* const* ppCommandLists)
+	{
+		std::size_t NumCommands = 0;
+		for (uint32_t i = 0; i < NumCommandLists; ++i)
+		{
+			RSIM_ASSERTM(ppCommandLists[i]->IsClosed(), "Command lists have to be closed before they are executed.");
+			RSIM_ASSERT(ppCommandLists[i]->GetType() == m_Type);
+			NumCommands += ppCommandLists[i]->GetNumCommands();
+		}
+
+		++m_NumExecuteCalls;
+		m_NumExecutedCommandLists += NumCommandLists;
+		Push({ Operation::Type::Execute, nullptr, 0, NumCommands });
+	}
+
+	void NullCommandQueue::Signal(NullFence* pFence, uint64_t Value)
+	{
+		++m_NumSignals;
+		Push({ Operation::Type::Signal, pFence, Value, 0 });
+	}
+
+	void NullCommandQueue::Wait(NullFence* pFence, uint64_t Value)
+	{
+		Push({ Operation::Type::Wait, pFence, Value, 0 });
+	}
+
+	void NullCommandQueue::Push(Operation const& Op)
+	{
+		{
+			std::lock_guard lock(m_Mutex);
+			m_Operations.push_back(Op);
+		}
+		m_HasOperations.notify_one();
+	}
+
+	void NullCommandQueue::RunTimeline()
+	{
+		while (true)
+		{
+			Operation Op{};
+			{
+				std::unique_lock lock(m_Mutex);
+				m_HasOperations.wait(lock, [this] { return m_Exit || !m_Operations.empty(); });
+				// Drain the queue before exiting so no fence is left waiting on a signal that was already submitted.
+				if (m_Operations.empty())
+					return;
+				Op = m_Operations.front();
+				m_Operations.pop_front();
+			}
+
+			switch (Op.OpType)
+			{
+			case Operation::Type::Execute:
+				{
+					auto const ExecutionTime = m_Desc.CommandExecutionTime * Op.NumCommands;
+					if (ExecutionTime.count() > 0)
+						std::this_thread::sleep_for(ExecutionTime);
+					m_BusyTimeNs += static_cast<uint64_t>(ExecutionTime.count());
+					break;
+				}
+			case Operation::Type::Signal:
+				Op.pFence->ScheduleSignal(Op.Value, NullFence::Clock::now() + m_Desc.FenceCompletionLatency);
+				break;
+			case Operation::Type::Wait:
+				Op.pFence->WaitForValue(Op.Value);
+				break;
+			}
+		}
+	}
+
+	NullDescriptorHeap::NullDescriptorHeap(NullDescriptorHeapType Type, uint32_t NumDescriptors, uint32_t DescriptorSize,
+		bool ShaderVisible, uint64_t GPUBaseAddress)
+		:
+		m_Type(Type),
+		m_NumDescriptors(NumDescriptors),
+		m_ShaderVisible(ShaderVisible),
+		m_GPUBaseAddress(GPUBaseAddress),
+		m_Memory(static_cast<std::size_t>(NumDescriptors) * DescriptorSize)
+	{
+	}
+
+	uint64_t NullDescriptorHeap::GetGPUDescriptorHandleForHeapStart() const
+	{
+		RSIM_ASSERTM(m_ShaderVisible, "Only shader visible heaps have a GPU descriptor handle.");
+		return m_GPUBaseAddress;
+	}
+
+	NullResource::NullResource(std::size_t SizeInBytes, uint64_t GPUVirtualAddress)
+		: m_Memory(SizeInBytes), m_GPUVirtualAddress(GPUVirtualAddress)
+	{
+	}
+
+	NullDevice::NullDevice(NullDeviceDesc const& Desc) : m_Desc(Desc)
+	{
+	}
+
+	std::unique_ptr<NullCommandQueue> NullDevice::CreateCommandQueue(NullCommandListType Type) const
+	{
+		return std::make_unique<NullCommandQueue>(m_Desc, Type);
+	}
+
+	std::unique_ptr<NullFence> NullDevice::CreateFence(uint64_t InitialValue) const
+	{
+		return std::make_unique<NullFence>(InitialValue);
+	}
+
+	std::shared_ptr<NullCommandAllocator> NullDevice::CreateCommandAllocator(NullCommandListType Type) const
+	{
+		return std::make_shared<NullCommandAllocator>(Type);
+	}
+
+	std::unique_ptr<NullCommandList> NullDevice::CreateCommandList(NullCommandListType Type, NullCommandAllocator* pAllocator) const
+	{
+		return std::make_unique<NullCommandList>(Type, pAllocator);
+	}
+
+	std::unique_ptr<NullDescriptorHeap> NullDevice::CreateDescriptorHeap(NullDescriptorHeapType Type, uint32_t NumDescriptors, bool ShaderVisible)
+	{
+		uint64_t const GPUBaseAddress = ShaderVisible ? ReserveGPUAddressRange(static_cast<std::size_t>(NumDescriptors) * m_Desc.DescriptorSize) : 0ULL;
+		return std::make_unique<NullDescriptorHeap>(Type, NumDescriptors, m_Desc.DescriptorSize, ShaderVisible, GPUBaseAddress);
+	}
+
+	std::unique_ptr<NullResource> NullDevice::CreateCommittedResource(std::size_t SizeInBytes)
+	{
+		return std::make_unique<NullResource>(SizeInBytes, ReserveGPUAddressRange(SizeInBytes));
+	}
+
+	uint64_t NullDevice::ReserveGPUAddressRange(std::size_t SizeInBytes)
+	{
+		// Keep every range 64KB aligned like placed resources on real hardware.
+		constexpr uint64_t Alignment = 0x10000ULL;
+		uint64_t const Address = m_NextGPUVirtualAddress;
+		m_NextGPUVirtualAddress += Math::AlignUp(static_cast<uint64_t>(SizeInBytes), Alignment);
+		return Address;
+	}
+}
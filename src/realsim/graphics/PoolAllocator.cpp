@@ -0,0 +1,176 @@
+#include "realsim/graphics/PoolAllocator.h"
+
+#include <algorithm>
+
+#include "realsim/math/Alignment.h"
+
+namespace RSim::Graphics
+{
+	PoolAllocator::PoolAllocator(OffsetType BlockSize, OffsetType BlocksPerSlab, std::size_t MaxSlabs)
+		: m_BlockSize(BlockSize), m_BlocksPerSlab(BlocksPerSlab), m_MaxSlabs(MaxSlabs)
+	{
+		RSIM_ASSERT(BlockSize > 0);
+		RSIM_ASSERT(BlocksPerSlab > 0);
+		RSIM_ASSERT(MaxSlabs > 0);
+	}
+
+	PoolAllocator::PoolAllocator(PoolAllocator&& rhs) noexcept
+		:
+		m_Slabs(std::move(rhs.m_Slabs)),
+		m_SlabsWithFreeBlocks(std::move(rhs.m_SlabsWithFreeBlocks)),
+		m_BlockSize(rhs.m_BlockSize),
+		m_BlocksPerSlab(rhs.m_BlocksPerSlab),
+		m_MaxSlabs(rhs.m_MaxSlabs),
+		m_NumAllocatedBlocks(rhs.m_NumAllocatedBlocks)
+	{
+		rhs.m_NumAllocatedBlocks = 0;
+	}
+
+	PoolAllocator& PoolAllocator::operator=(PoolAllocator&& rhs) noexcept
+	{
+		m_Slabs = std::move(rhs.m_Slabs);
+		m_SlabsWithFreeBlocks = std::move(rhs.m_SlabsWithFreeBlocks);
+		m_BlockSize = rhs.m_BlockSize;
+		m_BlocksPerSlab = rhs.m_BlocksPerSlab;
+		m_MaxSlabs = rhs.m_MaxSlabs;
+		m_NumAllocatedBlocks = rhs.m_NumAllocatedBlocks;
+		// The blocks belong to this pool now, the moved-from one must not report them as leaked.
+		rhs.m_NumAllocatedBlocks = 0;
+		return *this;
+	}
+
+	PoolAllocator::~PoolAllocator()
+	{
+		if (m_NumAllocatedBlocks != 0)
+			rsim_warn("PoolAllocator::~PoolAllocator: Some allocations may not have been freed.");
+	}
+
+	std::size_t PoolAllocator::AddSlab()
+	{
+		std::size_t const NumWords = Math::DivideByMultiple<std::size_t>(m_BlocksPerSlab, BitsPerWord);
+
+		Slab& NewSlab = m_Slabs.emplace_back();
+		NewSlab.FreeMask.assign(NumWords, ~0ULL);
+		// Clear the bits past the last block so they are never handed out.
+		if (std::size_t const TailBits = m_BlocksPerSlab % BitsPerWord; TailBits != 0)
+			NewSlab.FreeMask.back() = (1ULL << TailBits) - 1ULL;
+		NewSlab.NumFreeBlocks = m_BlocksPerSlab;
+		NewSlab.InFreeList = true;
+
+		std::size_t const SlabIndex = m_Slabs.size() - 1;
+		m_SlabsWithFreeBlocks.push_back(SlabIndex);
+		return SlabIndex;
+	}
+
+	PoolAllocator::Allocation PoolAllocator::Allocate()
+	{
+		if (m_SlabsWithFreeBlocks.empty())
+		{
+			if (m_Slabs.size() == m_MaxSlabs)
+				return Allocation::InvalidAllocation();
+			AddSlab();
+		}
+
+		std::size_t const SlabIndex = m_SlabsWithFreeBlocks.back();
+		Slab& slab = m_Slabs[SlabIndex];
+
+		// Every word below FirstFreeWord is known to be full, so the scan usually ends at the first word it looks at.
+		std::size_t Word = slab.FirstFreeWord;
+		while (slab.FreeMask[Word] == 0ULL)
+			++Word;
+
+		uint32_t const Bit = Math::CountTrailingZeros(slab.FreeMask[Word]);
+		slab.FreeMask[Word] &= slab.FreeMask[Word] - 1ULL;
+		slab.FirstFreeWord = Word;
+
+		if (--slab.NumFreeBlocks == 0)
+		{
+			slab.InFreeList = false;
+			m_SlabsWithFreeBlocks.pop_back();
+		}
+		++m_NumAllocatedBlocks;
+
+		OffsetType const BlockIndex = Word * BitsPerWord + Bit;
+		return { SlabIndex * GetSlabSize() + BlockIndex * m_BlockSize, m_BlockSize };
+	}
+
+	void PoolAllocator::Free(OffsetType Offset)
+	{
+		std::size_t const SlabIndex = GetSlabIndex(Offset);
+		RSIM_ASSERTM(SlabIndex < m_Slabs.size(), "The offset does not belong to this pool.");
+		RSIM_ASSERTM(GetOffsetInSlab(Offset) % m_BlockSize == 0, "The offset is not aligned to a block.");
+
+		Slab& slab = m_Slabs[SlabIndex];
+		OffsetType const BlockIndex = GetOffsetInSlab(Offset) / m_BlockSize;
+		std::size_t const Word = BlockIndex / BitsPerWord;
+		uint64_t const Mask = 1ULL << (BlockIndex % BitsPerWord);
+
+		RSIM_ASSERTM((slab.FreeMask[Word] & Mask) == 0ULL, "The block has already been freed.");
+		slab.FreeMask[Word] |= Mask;
+		slab.FirstFreeWord = std::min(slab.FirstFreeWord, Word);
+		++slab.NumFreeBlocks;
+		--m_NumAllocatedBlocks;
+
+		if (!slab.InFreeList)
+		{
+			slab.InFreeList = true;
+			m_SlabsWithFreeBlocks.push_back(SlabIndex);
+		}
+	}
+
+	void PoolAllocator::Free(Allocation& allocation)
+	{
+		Free(allocation.Offset);
+		allocation = Allocation::InvalidAllocation();
+	}
+
+
+	PoolGPUAllocator::PoolGPUAllocator(OffsetType BlockSize, OffsetType BlocksPerSlab, std::size_t MaxSlabs)
+		: PoolAllocator(BlockSize, BlocksPerSlab, MaxSlabs)
+	{
+	}
+
+	PoolGPUAllocator::PoolGPUAllocator(PoolGPUAllocator&& rhs) noexcept
+		:
+		PoolAllocator(std::move(rhs)),
+		m_StaleAllocations(std::move(rhs.m_StaleAllocations))
+	{
+		rhs.m_StaleAllocations.clear();
+	}
+
+	PoolGPUAllocator& PoolGPUAllocator::operator=(PoolGPUAllocator&& rhs) noexcept
+	{
+		PoolAllocator::operator=(std::move(rhs));
+		m_StaleAllocations = std::move(rhs.m_StaleAllocations);
+		rhs.m_StaleAllocations.clear();
+		return *this;
+	}
+
+	PoolGPUAllocator::~PoolGPUAllocator()
+	{
+		if (!m_StaleAllocations.empty())
+		{
+			rsim_warn("PoolGPUAllocator::~PoolGPUAllocator: Some stale allocations were not released.");
+		}
+	}
+
+	void PoolGPUAllocator::Free(OffsetType Offset, uint64_t FenceValue)
+	{
+		m_StaleAllocations.emplace_back(Offset, FenceValue);
+	}
+
+	void PoolGPUAllocator::Free(PoolAllocator::Allocation& allocation, uint64_t FenceValue)
+	{
+		Free(allocation.Offset, FenceValue);
+		allocation = Allocation::InvalidAllocation();
+	}
+
+	void PoolGPUAllocator::ReleaseStaleAllocations(uint64_t LastCompletedFenceValue)
+	{
+		while (!m_StaleAllocations.empty() && m_StaleAllocations.front().FenceValue <= LastCompletedFenceValue)
+		{
+			PoolAllocator::Free(m_StaleAllocations.front().Offset);
+			m_StaleAllocations.pop_front();
+		}
+	}
+}
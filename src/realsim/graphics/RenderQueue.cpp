@@ -0,0 +1,75 @@
+#include "realsim/graphics/RenderQueue.h"
+#include "realsim/core/Assert.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace RSim::Graphics
+{
+	namespace
+	{
+		constexpr uint64_t Mask(uint32_t Bits)
+		{
+			return (uint64_t{ 1 } << Bits) - 1;
+		}
+
+		/**
+		 * \brief Appends the low Bits bits of Value below the bits already in Key.
+		 */
+		constexpr uint64_t Append(uint64_t Key, uint64_t Value, uint32_t Bits)
+		{
+			return Key << Bits | (Value & Mask(Bits));
+		}
+	}
+
+	uint64_t RenderQueue::MakeSortKey(RenderPass Pass, DrawPacket const& Packet, float NormalizedDepth)
+	{
+		// An ID wider than its field would spill into the neighbouring one and sort the packet among unrelated state
+		RSIM_ASSERTM(Packet.PipelineID <= Mask(PipelineBits), "The pipeline ID does not fit into its sort key field.");
+		RSIM_ASSERTM(Packet.RootSignatureID <= Mask(RootSignatureBits), "The root signature ID does not fit into its sort key field.");
+		RSIM_ASSERTM(Packet.MaterialID <= Mask(MaterialBits), "The material ID does not fit into its sort key field.");
+		RSIM_ASSERTM(Packet.MeshID <= Mask(MeshBits), "The mesh ID does not fit into its sort key field.");
+		RSIM_ASSERTM(!std::isnan(NormalizedDepth), "The depth of a draw packet is NaN.");
+
+		// std::clamp passes NaN through and converting it to an integer is undefined, the comparison sends it to 0 instead
+		float const clamped = NormalizedDepth > 0.0f ? std::min(NormalizedDepth, 1.0f) : 0.0f;
+		auto const depth = (uint64_t)(clamped * (float)Mask(DepthBits));
+
+		uint64_t key = (uint64_t)Pass & Mask(PassBits);
+		if (Pass == RenderPass::Transparent)
+		{
+			key = Append(key, Mask(DepthBits) - depth, DepthBits);
+			key = Append(key, Packet.PipelineID, PipelineBits);
+			key = Append(key, Packet.RootSignatureID, RootSignatureBits);
+			key = Append(key, Packet.MaterialID, MaterialBits);
+			key = Append(key, Packet.MeshID, MeshBits);
+		}
+		else
+		{
+			key = Append(key, Packet.PipelineID, PipelineBits);
+			key = Append(key, Packet.RootSignatureID, RootSignatureBits);
+			key = Append(key, Packet.MaterialID, MaterialBits);
+			key = Append(key, Packet.MeshID, MeshBits);
+			key = Append(key, depth, DepthBits);
+		}
+		return key;
+	}
+
+	void RenderQueue::Clear()
+	{
+		m_Packets.clear();
+		m_SortEntries.clear();
+	}
+
+	void RenderQueue::Submit(RenderPass Pass, DrawPacket const& Packet, float NormalizedDepth)
+	{
+		m_SortEntries.push_back(Core::RadixSortEntry{ MakeSortKey(Pass, Packet, NormalizedDepth), (uint32_t)m_Packets.size() });
+		m_Packets.push_back(Packet);
+	}
+
+	void RenderQueue::Sort(Core::ThreadPool* pPool)
+	{
+		m_ScratchEntries.resize(m_SortEntries.size());
+		Core::RadixSort(pPool, m_SortEntries.data(), m_ScratchEntries.data(), m_SortEntries.size());
+	}
+}
@@ -2,11 +2,31 @@
 
 #include "realsim/graphics/RootSignatureFileDeserializer.h"
 
+#include <algorithm>
+#include <cstddef>
+
 namespace RSim::Graphics
 {
 	using Microsoft::WRL::ComPtr;
 
-	Renderer::Renderer(Core::Window const* outputWindow) : m_pOutputWindow(outputWindow)
+	static_assert(sizeof(IndirectDrawArguments) == sizeof(D3D12_DRAW_INDEXED_ARGUMENTS) &&
+		offsetof(IndirectDrawArguments, InstanceCount) == offsetof(D3D12_DRAW_INDEXED_ARGUMENTS, InstanceCount) &&
+		offsetof(IndirectDrawArguments, StartInstanceLocation) == offsetof(D3D12_DRAW_INDEXED_ARGUMENTS, StartInstanceLocation),
+		"IndirectDrawArguments must be laid out like D3D12_DRAW_INDEXED_ARGUMENTS.");
+
+	namespace
+	{
+		/**
+		 * \brief The quad faces away from the camera, it is turned around before applying the entity's transform.
+		 */
+		DirectX::XMMATRIX GetQuadMeshTransform()
+		{
+			return DirectX::XMMatrixRotationRollPitchYaw(0.0f, DirectX::XMConvertToRadians(180.0f), 0.0f);
+		}
+	}
+
+	Renderer::Renderer(Core::Window const* outputWindow, Core::ThreadPool& threadPool, FramePacingDesc const& framePacing)
+		: m_pOutputWindow(outputWindow), m_ThreadPool(&threadPool)
 	{
 		if(!outputWindow)
 		{
@@ -26,23 +46,37 @@ namespace RSim::Graphics
 
 		m_CmdListController = std::make_unique<CommandListController>(Device().GetDevice2Raw());
 
-		if (outputWindow)
-		{
-			m_SwapChain = std::make_unique<SwapChain>(Device().GetFactory3Raw(), m_CmdListController->GetGraphicsQueue().GetCommandQueue().Get() , outputWindow, Device());
-		}
+		// The window was checked above, so the swap chain and the frame pacer always exist and the frame functions use them unchecked.
+		m_SwapChain = std::make_unique<SwapChain>(Device().GetFactory3Raw(), m_CmdListController->GetGraphicsQueue().GetCommandQueue().Get() , outputWindow, Device());
+		m_FramePacer = std::make_unique<FramePacer>(SwpChain(), GfxQueue(), framePacing, Device().IsTearingSupported());
 		m_MemAllocator = CreateMemoryAllocator(Device());
 		InitVariables();
 		InitRenderingVar();
 	}
 
-	void Renderer::Clear(FLOAT const color[]) const
+	Renderer::~Renderer()
+	{
+		// Frames in flight may still use the descriptors and every resource the members own, wait for the GPU before releasing any of them.
+		if (m_CmdListController)
+			m_CmdListController->Flush();
+		// The descriptors go back to their allocators before the allocators are destroyed with the other members.
+		if (m_RTVAllocator)
+			m_RTVAllocator->Free(m_BackBufferRTVs);
+		if (m_DSVAllocator)
+			m_DSVAllocator->Free(m_DepthBufferDSV);
+	}
+
+	void Renderer::BeginFrame()
+	{
+		m_FramePacer->BeginFrame();
+	}
+
+	void Renderer::Clear(FLOAT const color[])
 	{
-		auto const& cmdAllocator = m_CmdAllocators[m_CurrentBackBufferIndex];
 		auto const& backBuffer = m_BackBuffers[m_CurrentBackBufferIndex];
-		auto const& cmdList = m_CmdList;
 
-		ThrowIfFailed(cmdAllocator->Reset());
-		ThrowIfFailed(cmdList->Reset(cmdAllocator.Get(), nullptr));
+		m_MainContext = GfxQueue().RequestContext();
+		auto const& cmdList = m_MainContext.CmdList;
 
 		CD3DX12_RESOURCE_BARRIER resBarrier = CD3DX12_RESOURCE_BARRIER::Transition(backBuffer, D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET);
 		cmdList->ResourceBarrier(1UL, &resBarrier);
@@ -51,132 +85,413 @@ namespace RSim::Graphics
 		ClearDepthStencilView(D3D12_CLEAR_FLAG_DEPTH, 1.0f);
 	}
 
-	void Renderer::Render(ECS::Scene& Scene) const
+	void Renderer::Render(ECS::Scene& Scene)
 	{
-		ID3D12GraphicsCommandList2* gfxCmdList = m_CmdList.Get();
-		CD3DX12_CPU_DESCRIPTOR_HANDLE const rtv(
-			m_RTVDescriptorHeap->GetCPUDescriptorHandleForHeapStart(), (INT)m_CurrentBackBufferIndex, m_DescriptorSizes.RTVIncrementSize);
-		D3D12_CPU_DESCRIPTOR_HANDLE const dsv{ m_DSVDescriptorHeap->GetCPUDescriptorHandleForHeapStart() };
-
-		gfxCmdList->OMSetRenderTargets(1, &rtv, FALSE, &dsv);
+		m_NumActiveRecordingContexts = 0;
 
 		auto& registry = Scene.GetEnTTRegistry();
 
+		std::size_t const numViews = m_ViewSetup.Build(registry, (float)m_pOutputWindow->GetWidth(), (float)m_pOutputWindow->GetHeight());
+		if (numViews == 0)
+		{
+			rsim_warn("There is no camera to render the scene with.");
+			return;
+		}
 
-		auto const cameraView = Scene.GetEnTTRegistry().view<ECS::PerspectiveCameraComponent>();
-		ECS::PerspectiveCameraComponent const* cameraComponent = nullptr;
+		auto const view = registry.view<ECS::BoxComponent, ECS::WorldTransformComponent>();
+		m_DrawEntities.assign(view.begin(), view.end());
+		if (m_DrawEntities.empty())
+			return;
 
-		if (cameraView.size() == 0)
+		if (m_GPUDrivenRendering)
 		{
-			rsim_warn("There is no camera to render the scene with.");
+			RenderGPUDriven(registry);
 			return;
 		}
 
-		for (auto const entity : cameraView)
+		DirectX::XMMATRIX const meshTransform = GetQuadMeshTransform();
+		static constexpr float QuadCenter[3] = { 0.0f, 0.0f, 0.0f };
+		static constexpr float QuadExtent[3] = { 0.5f, 0.5f, 0.0f };
+
+		// World matrices and bounds do not depend on the view, they are computed once for all views.
+		m_WorldMatrices.resize(m_DrawEntities.size());
+		m_DrawBounds.Resize(m_DrawEntities.size());
+		m_ThreadPool->ParallelFor(m_DrawEntities.size(), MinInstancesPerTask,
+			[&](std::size_t Begin, std::size_t End, std::size_t)
+			{
+				for (std::size_t i = Begin; i < End; ++i)
+				{
+					auto const& WTC = view.get<ECS::WorldTransformComponent>(m_DrawEntities[i]);
+					DirectX::XMStoreFloat4x4(&m_WorldMatrices[i], DirectX::XMMatrixMultiply(meshTransform, WTC.GetTransform()));
+					m_DrawBounds.SetTransformed(i, m_WorldMatrices[i].m, QuadCenter, QuadExtent);
+				}
+			});
+
+		std::vector<RenderView> const& views = m_ViewSetup.GetViews();
+		m_ViewCullers.resize(numViews);
+		std::size_t totalVisible = 0;
+		for (std::size_t v = 0; v < numViews; ++v)
+		{
+			totalVisible += m_ViewCullers[v].Cull(views[v].ViewFrustum, m_DrawBounds, m_ThreadPool);
+		}
+		if (totalVisible == 0)
+			return;
+
+		UploadBuffer& viewConstantBuffer = RequestFrameBuffer(m_ViewConstantBuffers, m_ViewSetup.GetConstantsSize(), L"View Constant Buffer");
+		m_ViewSetup.WriteConstants(viewConstantBuffer.Map());
+		viewConstantBuffer.Unmap(0, m_ViewSetup.GetConstantsSize());
+
+		// The visible instances of every view go into the same instance buffer, one range per view.
+		UploadBuffer& instanceBuffer = RequestFrameBuffer(m_InstanceBuffers, totalVisible * sizeof(InstanceData), L"Instance Buffer");
+		auto* const pInstances = static_cast<InstanceData*>(instanceBuffer.Map());
+
+		uint32_t firstViewInstance = 0;
+		for (std::size_t v = 0; v < numViews; ++v)
 		{
-			auto const& cc = cameraView.get<ECS::PerspectiveCameraComponent>(entity);
-			if (cc.IsPrimaryCamera)
+			std::vector<uint32_t> const& visibleIndices = m_ViewCullers[v].GetVisibleIndices();
+			std::size_t const numVisible = visibleIndices.size();
+			if (numVisible == 0)
+				continue;
+
+			m_DrawKeys.assign(numVisible, InstanceGroupKey{ BoxMeshID, DefaultMaterialID });
+			m_InstanceBatcher.Build(m_DrawKeys.data(), m_DrawKeys.size());
+
+			InstanceData* const pViewInstances = pInstances + firstViewInstance;
+			m_ThreadPool->ParallelFor(numVisible, MinInstancesPerTask,
+				[&](std::size_t Begin, std::size_t End, std::size_t)
+				{
+					for (std::size_t i = Begin; i < End; ++i)
+					{
+						uint32_t const drawIndex = visibleIndices[i];
+						InstanceData& instance = pViewInstances[m_InstanceBatcher.GetInstanceIndex(i)];
+						instance.World = m_WorldMatrices[drawIndex];
+						instance.Color = view.get<ECS::BoxComponent>(m_DrawEntities[drawIndex]).Color;
+					}
+				});
+
+			m_RenderQueue.Clear();
+			for (InstanceGroup const& group : m_InstanceBatcher.GetGroups())
 			{
-				cameraComponent = &cc;
-				break;
+				MaterialBinding const& material = m_Materials[group.Key.MaterialID];
+
+				DrawPacket packet{};
+				packet.PipelineID = material.PipelineID;
+				packet.RootSignatureID = material.RootSignatureID;
+				packet.MaterialID = group.Key.MaterialID;
+				packet.MeshID = group.Key.MeshID;
+				packet.FirstInstance = firstViewInstance + group.FirstInstance;
+				packet.NumInstances = group.NumInstances;
+				// The instances of a group are spread over the scene, so a group has no single depth to sort by.
+				m_RenderQueue.Submit(RenderPass::Opaque, packet);
 			}
+			m_RenderQueue.Sort(m_ThreadPool);
+
+			// The views are recorded one after another, each into its own contexts following the previous view's.
+			std::size_t const firstContext = m_NumActiveRecordingContexts;
+			m_RecordingContexts.resize(std::max(m_RecordingContexts.size(), firstContext + m_ThreadPool->GetMaxParallelism()));
+			D3D12_GPU_VIRTUAL_ADDRESS const viewConstantsAddress =
+				viewConstantBuffer.GetGPUVirtualAddress() + ViewSetup::GetConstantsOffset(v);
+			m_NumActiveRecordingContexts += m_ThreadPool->ParallelFor(m_RenderQueue.GetNumPackets(), MinDrawsPerRecordingTask,
+				[&](std::size_t Begin, std::size_t End, std::size_t TaskIndex)
+				{
+					ID3D12GraphicsCommandList2* gfxCmdList = BeginRecordingContext(firstContext + TaskIndex, views[v]);
+					RecordDrawPackets(gfxCmdList, Begin, End, viewConstantsAddress, instanceBuffer.GetGPUVirtualAddress());
+				});
+
+			firstViewInstance += (uint32_t)numVisible;
 		}
-		gfxCmdList->RSSetViewports(1, &m_Viewport);
-		gfxCmdList->RSSetScissorRects(1, &m_ScissorRect);
-		auto const view = registry.view<ECS::BoxComponent>();
+		instanceBuffer.Unmap(0, totalVisible * sizeof(InstanceData));
+	}
 
-		for(auto const entity : view)
+	void Renderer::RenderGPUDriven(entt::registry& Registry)
+	{
+		auto const view = Registry.view<ECS::BoxComponent, ECS::WorldTransformComponent>();
+		std::vector<RenderView> const& views = m_ViewSetup.GetViews();
+		std::size_t const numViews = views.size();
+
+		m_DrawKeys.assign(m_DrawEntities.size(), InstanceGroupKey{ BoxMeshID, DefaultMaterialID });
+		m_IndirectDrawBuilder.Build(m_DrawKeys.data(), m_DrawKeys.size(), m_IndirectMeshes.data(), m_IndirectMeshes.size(), numViews);
+		IndirectDrawBuilder const& builder = m_IndirectDrawBuilder;
+
+		UploadBuffer& viewConstantBuffer = RequestFrameBuffer(m_ViewConstantBuffers, m_ViewSetup.GetConstantsSize(), L"View Constant Buffer");
+		m_ViewSetup.WriteConstants(viewConstantBuffer.Map());
+		viewConstantBuffer.Unmap(0, m_ViewSetup.GetConstantsSize());
+
+		UploadBuffer& upload = RequestFrameBuffer(m_IndirectUploadBuffers, builder.GetUploadSize(), L"Indirect Upload Buffer");
+		void* const pUpload = upload.Map();
+		DirectX::XMMATRIX const meshTransform = GetQuadMeshTransform();
+		m_ThreadPool->ParallelFor(m_DrawEntities.size(), MinInstancesPerTask,
+			[&](std::size_t Begin, std::size_t End, std::size_t)
+			{
+				for (std::size_t i = Begin; i < End; ++i)
+				{
+					auto const& [box, WTC] = view.get<ECS::BoxComponent, ECS::WorldTransformComponent>(m_DrawEntities[i]);
+					DirectX::XMFLOAT4X4 world;
+					DirectX::XMStoreFloat4x4(&world, DirectX::XMMatrixMultiply(meshTransform, WTC.GetTransform()));
+					builder.WriteInstance(pUpload, i, world, box.Color);
+				}
+			});
+		builder.WriteTables(pUpload);
+		upload.Unmap(0, builder.GetUploadSize());
+
+		MemoryAllocation& groupCommands = RequestFrameGPUBuffer(m_GroupCommandBuffers, builder.GetCommandBufferSize(), L"Group Command Buffer");
+		MemoryAllocation& commands = RequestFrameGPUBuffer(m_IndirectCommandBuffers, builder.GetCommandBufferSize(), L"Indirect Command Buffer");
+		MemoryAllocation& visibleInstances = RequestFrameGPUBuffer(m_VisibleInstanceBuffers, builder.GetVisibleInstanceBufferSize(),
+			L"Visible Instance Buffer");
+		MemoryAllocation& counts = RequestFrameGPUBuffer(m_IndirectCountBuffers, builder.GetCountBufferSize(), L"Indirect Count Buffer");
+
+		D3D12_GPU_VIRTUAL_ADDRESS const uploadAddress = upload.GetGPUVirtualAddress();
+		D3D12_GPU_VIRTUAL_ADDRESS const instancesAddress = uploadAddress + builder.GetInstancesOffset();
+
+		//--------------------------- Culling, compute queue ---------------------------------
+		CommandContext cullContext = ComputeQueue().RequestContext(m_CullInstancesPipelineState.Get());
+		ID3D12GraphicsCommandList2* cullCmdList = cullContext.CmdList.Get();
+
+		// Every view starts from the template with no visible instances and no commands.
+		for (std::size_t v = 0; v < numViews; ++v)
+		{
+			cullCmdList->CopyBufferRegion(groupCommands.GetResource(), builder.GetCommandOffset(v), upload.GetResource(),
+				builder.GetCommandTemplateOffset(), builder.GetCommandTemplateSize());
+		}
+		cullCmdList->CopyBufferRegion(counts.GetResource(), 0, upload.GetResource(), builder.GetZeroCountsOffset(), builder.GetCountBufferSize());
+
+		// The copies promoted the buffers from the common state, the other two are promoted by their first unordered access.
+		std::array<CD3DX12_RESOURCE_BARRIER, 2> const copyBarriers = {
+			CD3DX12_RESOURCE_BARRIER::Transition(groupCommands.GetResource(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+			CD3DX12_RESOURCE_BARRIER::Transition(counts.GetResource(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_UNORDERED_ACCESS) };
+		cullCmdList->ResourceBarrier((UINT)copyBarriers.size(), copyBarriers.data());
+
+		cullCmdList->SetComputeRootSignature(m_CullRootSignature->GetRootSignature().Get());
+		cullCmdList->SetComputeRootShaderResourceView(1, instancesAddress);
+		cullCmdList->SetComputeRootShaderResourceView(2, uploadAddress + builder.GetMeshesOffset());
+		cullCmdList->SetComputeRootUnorderedAccessView(3, groupCommands.GetResource()->GetGPUVirtualAddress());
+		cullCmdList->SetComputeRootUnorderedAccessView(4, visibleInstances.GetResource()->GetGPUVirtualAddress());
+		cullCmdList->SetComputeRootUnorderedAccessView(5, commands.GetResource()->GetGPUVirtualAddress());
+		cullCmdList->SetComputeRootUnorderedAccessView(6, counts.GetResource()->GetGPUVirtualAddress());
+
+		// The views write disjoint ranges, so their dispatches need no barriers between them.
+		for (std::size_t v = 0; v < numViews; ++v)
+		{
+			CullConstants const constants = builder.GetCullConstants(v, views[v].ViewFrustum);
+			cullCmdList->SetComputeRoot32BitConstants(0, NumCullConstants, &constants, 0);
+			cullCmdList->Dispatch(IndirectDrawBuilder::GetNumThreadGroups(builder.GetNumInstances()), 1, 1);
+		}
+
+		// Compaction reads the instance counts the culling pass accumulated.
+		CD3DX12_RESOURCE_BARRIER const cullBarrier = CD3DX12_RESOURCE_BARRIER::UAV(groupCommands.GetResource());
+		cullCmdList->ResourceBarrier(1, &cullBarrier);
+
+		cullCmdList->SetPipelineState(m_CompactCommandsPipelineState.Get());
+		for (std::size_t v = 0; v < numViews; ++v)
+		{
+			CullConstants const constants = builder.GetCullConstants(v, views[v].ViewFrustum);
+			cullCmdList->SetComputeRoot32BitConstants(0, NumCullConstants, &constants, 0);
+			cullCmdList->Dispatch(IndirectDrawBuilder::GetNumThreadGroups(builder.GetNumGroups()), 1, 1);
+		}
+
+		uint64_t const cullFenceValue = ComputeQueue().ExecuteCommandList(cullCmdList);
+		ComputeQueue().DiscardContext(cullFenceValue, cullContext);
+		// Everything the graphics queue executes from now on, this frame's lists included, waits for the culling.
+		GfxQueue().InsertWaitForQueueFence(ComputeQueue(), cullFenceValue);
+
+		//--------------------------- Drawing, graphics queue ---------------------------------
+		// One list per view, a view costs the same handful of commands however many instances and groups it has.
+		std::size_t const firstContext = m_NumActiveRecordingContexts;
+		m_RecordingContexts.resize(std::max(m_RecordingContexts.size(), firstContext + numViews));
+		MeshBinding const& mesh = m_Meshes[BoxMeshID];
+		for (std::size_t v = 0; v < numViews; ++v)
+		{
+			ID3D12GraphicsCommandList2* gfxCmdList = BeginRecordingContext(firstContext + v, views[v]);
+			if (v == 0)
+			{
+				// The buffers decayed to the common state when the compute list finished.
+				std::array<CD3DX12_RESOURCE_BARRIER, 3> const drawBarriers = {
+					CD3DX12_RESOURCE_BARRIER::Transition(commands.GetResource(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT),
+					CD3DX12_RESOURCE_BARRIER::Transition(counts.GetResource(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT),
+					CD3DX12_RESOURCE_BARRIER::Transition(visibleInstances.GetResource(), D3D12_RESOURCE_STATE_COMMON,
+						D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE) };
+				gfxCmdList->ResourceBarrier((UINT)drawBarriers.size(), drawBarriers.data());
+			}
+
+			gfxCmdList->SetPipelineState(m_IndirectPipelineState.Get());
+			gfxCmdList->SetGraphicsRootSignature(m_IndirectRootSignature->GetRootSignature().Get());
+			gfxCmdList->SetGraphicsRootConstantBufferView(0, viewConstantBuffer.GetGPUVirtualAddress() + ViewSetup::GetConstantsOffset(v));
+			gfxCmdList->SetGraphicsRootShaderResourceView(2, instancesAddress);
+			gfxCmdList->SetGraphicsRootShaderResourceView(3, visibleInstances.GetResource()->GetGPUVirtualAddress());
+			gfxCmdList->IASetVertexBuffers(0UL, 1UL, &mesh.VertexBufferView);
+			gfxCmdList->IASetIndexBuffer(&mesh.IndexBufferView);
+			gfxCmdList->ExecuteIndirect(m_IndirectCommandSignature.Get(), (UINT)builder.GetNumGroups(),
+				commands.GetResource(), builder.GetCommandOffset(v), counts.GetResource(), IndirectDrawBuilder::GetCountOffset(v));
+		}
+		m_NumActiveRecordingContexts += numViews;
+	}
+
+	void Renderer::RecordDrawPackets(ID3D12GraphicsCommandList2* gfxCmdList, std::size_t Begin, std::size_t End,
+		D3D12_GPU_VIRTUAL_ADDRESS viewConstantsAddress, D3D12_GPU_VIRTUAL_ADDRESS instanceBufferAddress) const
+	{
+		// A command list starts without any state, so the first packet binds everything and the following ones only what differs.
+		constexpr uint32_t Unbound = UINT32_MAX;
+		uint32_t pipelineID = Unbound;
+		uint32_t rootSignatureID = Unbound;
+		uint32_t meshID = Unbound;
+
+		for (std::size_t i = Begin; i < End; ++i)
 		{
-			auto&&BC = view.get<ECS::BoxComponent>(entity);
-
-			float fWidth = (float)m_pOutputWindow->GetWidth();
-			float fHeight = (float)m_pOutputWindow->GetHeight();
-
-			float aspectRatio = fWidth / fHeight;
-			ECS::TransformComponent TC{};
-			//TC.Translation.z = 1.0f;
-			//TC.Translation.x = (BC.ScreenPosition.x / fWidth - 0.5f) * 2.0f;
-			//TC.Translation.y = (0.5f - BC.ScreenPosition.y / fHeight) * 2.0f;
-			TC.Scale = { 1.0f,1.0f,1.0f };
-
-			DirectX::XMStoreFloat4(&TC.Rotation, DirectX::XMQuaternionRotationRollPitchYaw(0.0f, DirectX::XMConvertToRadians(180.0f), 0.0f));
-			DirectX::XMMATRIX mvpMatrix = DirectX::XMMatrixMultiply(TC.GetTransform(), cameraComponent->GetViewMatrix());
-			mvpMatrix = DirectX::XMMatrixMultiply(mvpMatrix, cameraComponent->GetProjectionMatrix(aspectRatio));
-
-			gfxCmdList->SetPipelineState(m_PipelineState.Get());
-			gfxCmdList->SetGraphicsRootSignature(m_Sig->GetRootSignature().Get());
-			gfxCmdList->IASetVertexBuffers(0UL, 1UL, &m_VB->GetView());
-			gfxCmdList->IASetIndexBuffer(&m_IB->GetView());
-
-			gfxCmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-			gfxCmdList->SetGraphicsRoot32BitConstants(0, sizeof(DirectX::XMMATRIX) / 4, &mvpMatrix, 0);
-			gfxCmdList->SetGraphicsRoot32BitConstants(1, sizeof(DirectX::XMFLOAT4) / 4, &BC.Color, 0);
-			gfxCmdList->DrawIndexedInstanced(indices.size(), 1, 0, 0, 0);
+			DrawPacket const& packet = m_RenderQueue.GetSortedPacket(i);
+
+			if (packet.PipelineID != pipelineID)
+			{
+				pipelineID = packet.PipelineID;
+				gfxCmdList->SetPipelineState(m_PipelineStates[pipelineID]);
+			}
+
+			if (packet.RootSignatureID != rootSignatureID)
+			{
+				rootSignatureID = packet.RootSignatureID;
+				gfxCmdList->SetGraphicsRootSignature(m_RootSignatures[rootSignatureID]);
+				// Setting a root signature resets the root arguments, the per-frame ones have to be bound again.
+				gfxCmdList->SetGraphicsRootConstantBufferView(0, viewConstantsAddress);
+				gfxCmdList->SetGraphicsRootShaderResourceView(2, instanceBufferAddress);
+			}
+
+			MeshBinding const& mesh = m_Meshes[packet.MeshID];
+			if (packet.MeshID != meshID)
+			{
+				meshID = packet.MeshID;
+				gfxCmdList->IASetVertexBuffers(0UL, 1UL, &mesh.VertexBufferView);
+				gfxCmdList->IASetIndexBuffer(&mesh.IndexBufferView);
+			}
+
+			gfxCmdList->SetGraphicsRoot32BitConstant(1, packet.FirstInstance, 0);
+			gfxCmdList->DrawIndexedInstanced(mesh.NumIndices, packet.NumInstances, 0, 0, 0);
 		}
 	}
 
+	UploadBuffer& Renderer::RequestFrameBuffer(std::array<std::unique_ptr<UploadBuffer>, NumFramesInFlight>& Buffers,
+		std::size_t RequiredSize, std::wstring const& Name)
+	{
+		auto& buffer = Buffers[m_CurrentBackBufferIndex];
+		if (!buffer || buffer->GetBufferSize() < RequiredSize)
+		{
+			// Grow geometrically so that a steadily growing scene does not reallocate every frame.
+			std::size_t const newSize = std::max(RequiredSize, buffer ? buffer->GetBufferSize() * 2 : RequiredSize);
+			buffer = std::make_unique<UploadBuffer>(MemAllocator(), newSize, Name);
+		}
+		return *buffer;
+	}
+
+	MemoryAllocation& Renderer::RequestFrameGPUBuffer(std::array<std::unique_ptr<MemoryAllocation>, NumFramesInFlight>& Buffers,
+		std::size_t RequiredSize, LPCWSTR Name)
+	{
+		auto& buffer = Buffers[m_CurrentBackBufferIndex];
+		if (!buffer || buffer->GetResource()->GetDesc().Width < RequiredSize)
+		{
+			std::size_t const newSize = std::max(RequiredSize, buffer ? (std::size_t)buffer->GetResource()->GetDesc().Width * 2 : RequiredSize);
+
+			D3D12MA::ALLOCATION_DESC allocationDesc{};
+			allocationDesc.HeapType = D3D12_HEAP_TYPE_DEFAULT;
+			auto const resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(newSize, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
+
+			buffer = MemAllocator().CreateResource(&allocationDesc, &resourceDesc, D3D12_RESOURCE_STATE_COMMON, nullptr);
+			buffer->SetName(Name);
+		}
+		return *buffer;
+	}
+
+	ID3D12GraphicsCommandList2* Renderer::BeginRecordingContext(std::size_t ContextIndex, RenderView const& View)
+	{
+		CommandContext& context = m_RecordingContexts[ContextIndex];
+		context = GfxQueue().RequestContext();
+
+		ID3D12GraphicsCommandList2* gfxCmdList = context.CmdList.Get();
+		D3D12_CPU_DESCRIPTOR_HANDLE const rtv = m_BackBufferRTVs.GetHandle(m_CurrentBackBufferIndex);
+		D3D12_CPU_DESCRIPTOR_HANDLE const dsv = m_DepthBufferDSV.GetHandle();
+
+		// Command lists do not inherit state from each other, so every task sets it once for all of its draws. The pipeline state, root
+		// signature and buffers are bound by RecordDrawPackets as the packets require them.
+		D3D12_VIEWPORT const viewport = CD3DX12_VIEWPORT(View.ViewportX, View.ViewportY, View.ViewportWidth, View.ViewportHeight);
+		D3D12_RECT const scissorRect = CD3DX12_RECT((LONG)View.ViewportX, (LONG)View.ViewportY,
+			(LONG)(View.ViewportX + View.ViewportWidth), (LONG)(View.ViewportY + View.ViewportHeight));
+		gfxCmdList->OMSetRenderTargets(1, &rtv, FALSE, &dsv);
+		gfxCmdList->RSSetViewports(1, &viewport);
+		gfxCmdList->RSSetScissorRects(1, &scissorRect);
+		gfxCmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		// The bindless heaps stay bound for the whole list, so materials only differ in their root constants.
+		std::array<ID3D12DescriptorHeap*, 2> const heaps = { m_BindlessResourceHeap->GetHeap(), m_BindlessSamplerHeap->GetHeap() };
+		gfxCmdList->SetDescriptorHeaps((UINT)heaps.size(), heaps.data());
+		return gfxCmdList;
+	}
+
 	void Renderer::Present()
 	{
 		if (!m_pOutputWindow) throw std::exception("Called Renderer::Present with an invalid window.");
 
-		ID3D12GraphicsCommandList2* gfxCmdList = m_CmdList.Get();
+		// The back buffer transition has to be recorded after the last draw, which lives in the last recording context if there is one.
+		ID3D12GraphicsCommandList2* lastCmdList = m_NumActiveRecordingContexts > 0 ?
+			m_RecordingContexts[m_NumActiveRecordingContexts - 1].CmdList.Get() : m_MainContext.CmdList.Get();
 		auto const& backBuffer = m_BackBuffers[m_CurrentBackBufferIndex];
 
 		CD3DX12_RESOURCE_BARRIER resBarrier = CD3DX12_RESOURCE_BARRIER::Transition(backBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT);
-		gfxCmdList->ResourceBarrier(1UL, &resBarrier);
+		lastCmdList->ResourceBarrier(1UL, &resBarrier);
+
+		m_SubmissionCmdLists.clear();
+		m_SubmissionCmdLists.push_back(m_MainContext.CmdList.Get());
+		for (std::size_t i = 0; i < m_NumActiveRecordingContexts; ++i)
+		{
+			m_SubmissionCmdLists.push_back(m_RecordingContexts[i].CmdList.Get());
+		}
 
-		m_FrameFenceValues[m_CurrentBackBufferIndex] = GfxQueue().ExecuteCommandList(gfxCmdList);
+		// The frame's dynamic descriptors have to be in the shader-visible heaps before the GPU reads them.
+		m_BindlessResourceHeap->FlushDynamicCopies();
+		m_BindlessSamplerHeap->FlushDynamicCopies();
 
-		bool EnableVSync = true;
-		UINT syncInterval = EnableVSync ? 1 : 0;
-		UINT presentFlags = Device().IsTearingSupported() && !EnableVSync ? DXGI_PRESENT_ALLOW_TEARING : 0;
+		uint64_t const frameFenceValue = GfxQueue().ExecuteCommandLists(m_SubmissionCmdLists.data(), (uint32_t)m_SubmissionCmdLists.size());
 
-		SwpChain().Present(syncInterval, presentFlags);
+		// The contexts go back to the queue, their allocators are handed out again once the GPU has passed this frame's fence.
+		GfxQueue().DiscardContext(frameFenceValue, m_MainContext);
+		for (std::size_t i = 0; i < m_NumActiveRecordingContexts; ++i)
+		{
+			GfxQueue().DiscardContext(frameFenceValue, m_RecordingContexts[i]);
+		}
+		m_NumActiveRecordingContexts = 0;
+		GfxQueue().ReleaseIdleContexts();
+
+		m_BindlessResourceHeap->EndFrame(frameFenceValue);
+		m_BindlessSamplerHeap->EndFrame(frameFenceValue);
+		uint64_t const completedFenceValue = GfxQueue().PollCurrentFenceValue();
+		m_BindlessResourceHeap->ReleaseStaleDescriptors(completedFenceValue);
+		m_BindlessSamplerHeap->ReleaseStaleDescriptors(completedFenceValue);
+
+		// No wait here, the CPU only blocks in BeginFrame() once it is too many frames ahead of the GPU.
+		SwpChain().Present(m_FramePacer->GetSyncInterval(), m_FramePacer->GetPresentFlags());
 		m_CurrentBackBufferIndex = SwpChain().GetCurrentBackBufferIndex();
 
-		m_CmdListController->WaitForFence(m_FrameFenceValues[m_CurrentBackBufferIndex]);
+		m_FramePacer->EndFrame(frameFenceValue);
 	}
 
 	void Renderer::InitVariables()
 	{
 		m_DescriptorSizes = GetDescriptorHandleIncrementSizes(Device().GetDevice2Raw());
 
-		m_CmdAllocatorPool = std::make_unique<CommandAllocatorPool>(Device().GetDevice2Raw(), D3D12_COMMAND_LIST_TYPE_DIRECT);
+		m_RecordingContexts.resize(m_ThreadPool->GetMaxParallelism());
 
 		//--------------------------- Descriptor Heaps ---------------------------------
-		D3D12_DESCRIPTOR_HEAP_DESC rtvDescHeapDesc;
-		rtvDescHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
-		rtvDescHeapDesc.NumDescriptors = NumFramesInFlight;
-		rtvDescHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
-		rtvDescHeapDesc.NodeMask = 0;
+		m_RTVAllocator = std::make_unique<CPUDescriptorAllocator>(Device().GetDevice2Raw(), D3D12_DESCRIPTOR_HEAP_TYPE_RTV,
+			RTVDescriptorsPerPage);
+		m_DSVAllocator = std::make_unique<CPUDescriptorAllocator>(Device().GetDevice2Raw(), D3D12_DESCRIPTOR_HEAP_TYPE_DSV,
+			DSVDescriptorsPerPage);
+		m_BackBufferRTVs = m_RTVAllocator->Allocate(NumFramesInFlight);
+		m_DepthBufferDSV = m_DSVAllocator->Allocate();
+
+		m_BindlessResourceHeap = std::make_unique<BindlessDescriptorHeap>(Device().GetDevice2Raw(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
+			NumBindlessResourceDescriptors, L"Bindless Resource Heap", NumDynamicResourceDescriptors);
+		m_BindlessSamplerHeap = std::make_unique<BindlessDescriptorHeap>(Device().GetDevice2Raw(), D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER,
+			NumBindlessSamplerDescriptors, L"Bindless Sampler Heap", NumDynamicSamplerDescriptors);
 
-		ThrowIfFailed(Device()->CreateDescriptorHeap(&rtvDescHeapDesc, IID_PPV_ARGS(&m_RTVDescriptorHeap)));
-
-		D3D12_DESCRIPTOR_HEAP_DESC dsvDescHeapDesc;
-		dsvDescHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
-		dsvDescHeapDesc.NumDescriptors = 1;
-		dsvDescHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
-		dsvDescHeapDesc.NodeMask = 0;
-
-		ThrowIfFailed(Device()->CreateDescriptorHeap(&dsvDescHeapDesc, IID_PPV_ARGS(&m_DSVDescriptorHeap)));
-
-		// Create the command allocators
-		for (auto& cmdAllocator : m_CmdAllocators)
-		{
-			cmdAllocator = m_CmdAllocatorPool->RequestCommandAllocator(m_FrameNumber);
-		}
-		ThrowIfFailed(Device()->CreateCommandList(0, 
-			D3D12_COMMAND_LIST_TYPE_DIRECT, 
-			m_CmdAllocators[SwpChain().GetCurrentBackBufferIndex()].Get(), 
-			nullptr, 
-			IID_PPV_ARGS(&m_CmdList)));
-
-		ThrowIfFailed(m_CmdList->Close());
-		
 		if(m_pOutputWindow)
 		{
 			// Get the resources that SwapChain creates for the HWND and assign them to m_BackBuffers and set the RTV descriptor heap accordingly. 
-			SwpChain().CreateBackBuffersFromSwapChain(Device().GetDevice2Raw(), m_BackBuffers, m_RTVDescriptorHeap.Get());
+			SwpChain().CreateBackBuffersFromSwapChain(Device().GetDevice2Raw(), m_BackBuffers, m_BackBufferRTVs.GetHandle());
 			this->ResizeDepthBuffer(m_pOutputWindow->GetWidth(), m_pOutputWindow->GetHeight());
 		}
 	}
@@ -228,25 +543,25 @@ namespace RSim::Graphics
 		indicesSubresourceData.RowPitch = indices.size() * sizeof(uint32_t);
 		indicesSubresourceData.SlicePitch = indicesSubresourceData.RowPitch;
 
-		Device()->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COPY, IID_PPV_ARGS(&m_CopyCmdAllocator));
-		Device()->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_COPY, m_CopyCmdAllocator.Get(), nullptr, IID_PPV_ARGS(&m_CopyCmdList));
+		CommandContext copyContext = CopyQueue().RequestContext();
 
-		::UpdateSubresources(m_CopyCmdList.Get(),m_VBResource->GetResource(),VBIntermediate->GetResource(),0,0,1,&verticesSubresourceData);
-		::UpdateSubresources(m_CopyCmdList.Get(), m_IBResource->GetResource(), IBIntermediate->GetResource(), 0, 0, 1, &indicesSubresourceData);
+		::UpdateSubresources(copyContext.CmdList.Get(),m_VBResource->GetResource(),VBIntermediate->GetResource(),0,0,1,&verticesSubresourceData);
+		::UpdateSubresources(copyContext.CmdList.Get(), m_IBResource->GetResource(), IBIntermediate->GetResource(), 0, 0, 1, &indicesSubresourceData);
 
-		uint64_t signal = CopyQueue().ExecuteCommandList(m_CopyCmdList.Get());
+		uint64_t signal = CopyQueue().ExecuteCommandList(copyContext.CmdList.Get());
+		CopyQueue().DiscardContext(signal, copyContext);
 		CopyQueue().WaitForFence(signal);
 #pragma warning(disable: 4267)
 		m_VB = std::make_unique<VertexBuffer>(m_VBResource->GetResource(), D3D12_RESOURCE_STATE_COMMON, (uint32_t)sizeof(DirectX::XMFLOAT3), (uint32_t)vertices.size() * (uint32_t)sizeof(DirectX::XMFLOAT3));
 		m_IB = std::make_unique<IndexBuffer>(m_IBResource->GetResource(), D3D12_RESOURCE_STATE_COMMON, indices.size() * sizeof(uint32_t), DXGI_FORMAT_R32_UINT);
 #pragma warning(default: 4267)
 
-		ShaderBlob VS = ShaderCompiler::CompileShader(ShaderCompilationParameters::VertexShaderDefaults(L"Shaders/vertex.vsh"));
-		ShaderBlob PS = ShaderCompiler::CompileShader(ShaderCompilationParameters::PixelShaderDefaults(L"Shaders/pixel.psh"));
+		ShaderBlob VS = ShaderCompiler::CompileShader(ShaderCompilationParameters::VertexShaderDefaults(L"Shaders/instanced.vsh"));
+		ShaderBlob PS = ShaderCompiler::CompileShader(ShaderCompilationParameters::PixelShaderDefaults(L"Shaders/instanced.psh"));
 
 		VertexLayout layout(VS);
 
-		RootSignatureFileDeserializer file("RootSignatures/basic.yml");
+		RootSignatureFileDeserializer file("RootSignatures/instanced_rootsig.yml");
 
 		HRESULT hr;
 		SerializedRootSignature blob = SerializeRootSignature(file, Device().GetDevice2Raw(), hr);
@@ -279,22 +594,105 @@ namespace RSim::Graphics
 		D3D12_PIPELINE_STATE_STREAM_DESC pipelineStateStreamDesc = { sizeof(PipelineStateStream), &pipelineStateStream };
 
 		Device()->CreatePipelineState(&pipelineStateStreamDesc, IID_PPV_ARGS(&m_PipelineState));
+
+		m_PipelineStates.push_back(m_PipelineState.Get());
+		m_RootSignatures.push_back(m_Sig->GetRootSignature().Get());
+		m_Materials.push_back(MaterialBinding{ 0, 0 });
+		m_Meshes.push_back(MeshBinding{ m_VB->GetView(), m_IB->GetView(), (UINT)indices.size() });
+
+		InitGPUDrivenRendering();
+	}
+
+	void Renderer::InitGPUDrivenRendering()
+	{
+		// The quad's bounds, the same as the CPU path culls with.
+		IndirectMesh quad{};
+		quad.NumIndices = (uint32_t)indices.size();
+		quad.LocalExtent[0] = 0.5f;
+		quad.LocalExtent[1] = 0.5f;
+		m_IndirectMeshes.push_back(quad);
+
+		HRESULT hr;
+
+		//--------------------------- Culling ---------------------------------
+		RootSignatureFileDeserializer cullFile("RootSignatures/gpu_cull_rootsig.yml");
+		SerializedRootSignature cullBlob = SerializeRootSignature(cullFile, Device().GetDevice2Raw(), hr);
+		m_CullRootSignature = std::make_unique<RootSignature>(Device().GetDevice2Raw(), cullBlob);
+
+		ShaderBlob cullCS = ShaderCompiler::CompileShader(ShaderCompilationParameters::ComputeShaderDefaults(L"Shaders/gpu_cull.csh", "CullInstances"));
+		ShaderBlob compactCS = ShaderCompiler::CompileShader(ShaderCompilationParameters::ComputeShaderDefaults(L"Shaders/gpu_cull.csh", "CompactCommands"));
+
+		D3D12_COMPUTE_PIPELINE_STATE_DESC computeDesc{};
+		computeDesc.pRootSignature = m_CullRootSignature->GetRootSignature().Get();
+		computeDesc.CS = CD3DX12_SHADER_BYTECODE(cullCS.Blob.Get());
+		ThrowIfFailed(Device()->CreateComputePipelineState(&computeDesc, IID_PPV_ARGS(&m_CullInstancesPipelineState)));
+		computeDesc.CS = CD3DX12_SHADER_BYTECODE(compactCS.Blob.Get());
+		ThrowIfFailed(Device()->CreateComputePipelineState(&computeDesc, IID_PPV_ARGS(&m_CompactCommandsPipelineState)));
+
+		//--------------------------- Drawing ---------------------------------
+		ShaderBlob VS = ShaderCompiler::CompileShader(ShaderCompilationParameters::VertexShaderDefaults(L"Shaders/instanced_indirect.vsh"));
+		ShaderBlob PS = ShaderCompiler::CompileShader(ShaderCompilationParameters::PixelShaderDefaults(L"Shaders/instanced.psh"));
+		VertexLayout layout(VS);
+
+		RootSignatureFileDeserializer drawFile("RootSignatures/instanced_indirect_rootsig.yml");
+		SerializedRootSignature drawBlob = SerializeRootSignature(drawFile, Device().GetDevice2Raw(), hr);
+		m_IndirectRootSignature = std::make_unique<RootSignature>(Device().GetDevice2Raw(), drawBlob);
+
+		struct PipelineStateStream
+		{
+			CD3DX12_PIPELINE_STATE_STREAM_ROOT_SIGNATURE pRootSignature;
+			CD3DX12_PIPELINE_STATE_STREAM_INPUT_LAYOUT InputLayout;
+			CD3DX12_PIPELINE_STATE_STREAM_PRIMITIVE_TOPOLOGY PrimitiveTopologyType;
+			CD3DX12_PIPELINE_STATE_STREAM_VS VS;
+			CD3DX12_PIPELINE_STATE_STREAM_PS PS;
+			CD3DX12_PIPELINE_STATE_STREAM_RENDER_TARGET_FORMATS RTVFormats;
+			CD3DX12_PIPELINE_STATE_STREAM_DEPTH_STENCIL_FORMAT DSVFormat;
+		} pipelineStateStream;
+
+		D3D12_RT_FORMAT_ARRAY rtvFormats = {};
+		rtvFormats.NumRenderTargets = 1;
+		rtvFormats.RTFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+
+		auto inputLayout = layout.GetD3D12InputLayout();
+		pipelineStateStream.pRootSignature = m_IndirectRootSignature->GetRootSignature().Get();
+		pipelineStateStream.InputLayout = { inputLayout.data(), static_cast<UINT>(inputLayout.size()) };
+		pipelineStateStream.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+		pipelineStateStream.VS = CD3DX12_SHADER_BYTECODE(VS.Blob.Get());
+		pipelineStateStream.PS = CD3DX12_SHADER_BYTECODE(PS.Blob.Get());
+		pipelineStateStream.RTVFormats = rtvFormats;
+		pipelineStateStream.DSVFormat = DXGI_FORMAT_D32_FLOAT;
+
+		D3D12_PIPELINE_STATE_STREAM_DESC pipelineStateStreamDesc = { sizeof(PipelineStateStream), &pipelineStateStream };
+		ThrowIfFailed(Device()->CreatePipelineState(&pipelineStateStreamDesc, IID_PPV_ARGS(&m_IndirectPipelineState)));
+
+		// An IndirectCommand: the first-instance root constant, then the draw.
+		std::array<D3D12_INDIRECT_ARGUMENT_DESC, 2> arguments{};
+		arguments[0].Type = D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT;
+		arguments[0].Constant.RootParameterIndex = 1;
+		arguments[0].Constant.DestOffsetIn32BitValues = 0;
+		arguments[0].Constant.Num32BitValuesToSet = 1;
+		arguments[1].Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED;
+
+		D3D12_COMMAND_SIGNATURE_DESC commandSignatureDesc{};
+		commandSignatureDesc.ByteStride = sizeof(IndirectCommand);
+		commandSignatureDesc.NumArgumentDescs = (UINT)arguments.size();
+		commandSignatureDesc.pArgumentDescs = arguments.data();
+		// The signature changes a root argument, so it is tied to the root signature.
+		ThrowIfFailed(Device()->CreateCommandSignature(&commandSignatureDesc, m_IndirectRootSignature->GetRootSignature().Get(),
+			IID_PPV_ARGS(&m_IndirectCommandSignature)));
 	}
 
 	void Renderer::ClearDepthStencilView(D3D12_CLEAR_FLAGS flags, FLOAT depth) const
 	{
-		D3D12_CPU_DESCRIPTOR_HANDLE dsv = m_DSVDescriptorHeap->GetCPUDescriptorHandleForHeapStart();
-		m_CmdList->ClearDepthStencilView(dsv, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 1UL, &m_ScissorRect);
+		D3D12_CPU_DESCRIPTOR_HANDLE dsv = m_DepthBufferDSV.GetHandle();
+		m_MainContext.CmdList->ClearDepthStencilView(dsv, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 1UL, &m_ScissorRect);
 	}
 
 	void Renderer::ClearRenderTargetView(FLOAT const color[]) const
 	{
-		CD3DX12_CPU_DESCRIPTOR_HANDLE rtv(
-			m_RTVDescriptorHeap->GetCPUDescriptorHandleForHeapStart(),
-			(INT)m_CurrentBackBufferIndex,
-			m_DescriptorSizes.RTVIncrementSize);
+		D3D12_CPU_DESCRIPTOR_HANDLE rtv = m_BackBufferRTVs.GetHandle(m_CurrentBackBufferIndex);
 
-		m_CmdList->ClearRenderTargetView(rtv, color, 1, &m_ScissorRect);
+		m_MainContext.CmdList->ClearRenderTargetView(rtv, color, 1, &m_ScissorRect);
 	}
 
 	void Renderer::Resize(uint32_t width, uint32_t height)
@@ -304,7 +702,6 @@ namespace RSim::Graphics
 		for (size_t i = 0; i < NumFramesInFlight; ++i)
 		{
 			m_BackBuffers[i]->Release();
-			m_FrameFenceValues[i] = m_CmdListController->GetGraphicsQueue().GetNextFenceValue();
 		}
 
 		DXGI_SWAP_CHAIN_DESC swapChainDesc{};
@@ -313,12 +710,7 @@ namespace RSim::Graphics
 
 		m_CurrentBackBufferIndex = m_SwapChain->GetCurrentBackBufferIndex();
 
-		m_Viewport.Width = static_cast<FLOAT>(width);
-		m_Viewport.Height = static_cast<FLOAT>(height);
-		m_Viewport.TopLeftX = 0.0f;
-		m_Viewport.TopLeftY = 0.0f;
-
-		SwpChain().CreateBackBuffersFromSwapChain(Device().GetDevice2Raw(), m_BackBuffers, m_RTVDescriptorHeap.Get());
+		SwpChain().CreateBackBuffersFromSwapChain(Device().GetDevice2Raw(), m_BackBuffers, m_BackBufferRTVs.GetHandle());
 		m_DepthBuffer.reset();
 		this->ResizeDepthBuffer(width, height);
 	}
@@ -345,6 +737,6 @@ namespace RSim::Graphics
 		DSVDescription.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
 		DSVDescription.Texture2D.MipSlice = 0;
 		DSVDescription.Flags = D3D12_DSV_FLAG_NONE;
-		Device()->CreateDepthStencilView(m_DepthBuffer->GetResource(), &DSVDescription, m_DSVDescriptorHeap->GetCPUDescriptorHandleForHeapStart());
+		Device()->CreateDepthStencilView(m_DepthBuffer->GetResource(), &DSVDescription, m_DepthBufferDSV.GetHandle());
 	}
 }
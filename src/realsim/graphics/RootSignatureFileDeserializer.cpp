@@ -1,5 +1,7 @@
 #include "realsim/graphics/RootSignatureFileDeserializer.h"
 
+#include <algorithm>
+#include <climits>
 
 namespace RSim::Graphics
 {
@@ -257,8 +259,18 @@ namespace RSim::Graphics
 		//	registerSpace);
 		CD3DX12_ROOT_PARAMETER1 param1{};
 
-		// SWITCH
-		param1.InitAsConstantBufferView(shaderRegister, registerSpace, *rootDescriptorFlag, visibility);
+		switch (*StringToRootParameterType(typeStr))
+		{
+		case D3D12_ROOT_PARAMETER_TYPE_SRV:
+			param1.InitAsShaderResourceView(shaderRegister, registerSpace, *rootDescriptorFlag, visibility);
+			break;
+		case D3D12_ROOT_PARAMETER_TYPE_UAV:
+			param1.InitAsUnorderedAccessView(shaderRegister, registerSpace, *rootDescriptorFlag, visibility);
+			break;
+		default:
+			param1.InitAsConstantBufferView(shaderRegister, registerSpace, *rootDescriptorFlag, visibility);
+			break;
+		}
 		return param1;
 	}
 
@@ -303,7 +315,10 @@ namespace RSim::Graphics
 			}
 
 			auto rangeName = Serialization::AsIf<std::string>(rangeNameNode);
+			// 'unbounded' ranges reach to the end of the heap, which is how the bindless tables index the whole heap.
 			auto numDescriptors = Serialization::AsIf<int32_t>(numDescriptorsNode);
+			if (!numDescriptors && Serialization::AsIf<std::string>(numDescriptorsNode) == std::optional<std::string>("unbounded"))
+				numDescriptors = -1;
 			auto baseShaderRegister = Serialization::AsIf<int32_t>(baseShaderRegisterNode);
 			auto registerSpace = Serialization::AsIf<int32_t>(registerSpaceNode);
 			auto descriptorRangeTypeStr = Serialization::AsIf<std::string>(descriptorRangeTypeNode);
@@ -329,9 +344,31 @@ namespace RSim::Graphics
 				return std::nullopt;
 			}
 
+			if (*numDescriptors == 0 || *numDescriptors < -1)
+			{
+				rsim_error("'num_descriptors' of the range '{0}' in the root parameter '{1}' needs to be positive or 'unbounded'.",
+				           *rangeName, parameterName);
+				return std::nullopt;
+			}
+
+			/* 'offset_from_table_start' is optional, ranges follow the previous one by default. Several unbounded ranges in different
+			 * register spaces all starting at 0 alias the whole heap, one for every kind of resource the shaders index into. */
+			UINT offsetFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
+			if (YAML::Node const offsetNode = rangeNode["offset_from_table_start"])
+			{
+				auto const offset = Serialization::AsIf<int32_t>(offsetNode);
+				if (!offset || *offset < 0)
+				{
+					rsim_error("'offset_from_table_start' of the range '{0}' in the root parameter '{1}' needs to be a non-negative integer.",
+					           *rangeName, parameterName);
+					return std::nullopt;
+				}
+				offsetFromTableStart = (UINT)*offset;
+			}
+
 			CD3DX12_DESCRIPTOR_RANGE1 range{};
-			range.Init(*descriptorRangeType, (UINT)*numDescriptors, (UINT)*baseShaderRegister, (UINT)*registerSpace,
-			           *descriptorRangeFlags, D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND);
+			range.Init(*descriptorRangeType, *numDescriptors == -1 ? UINT_MAX : (UINT)*numDescriptors, (UINT)*baseShaderRegister,
+			           (UINT)*registerSpace, *descriptorRangeFlags, offsetFromTableStart);
 
 			//acc3d_debug(
 			//	"root_parameter_name={7}\nrange_name={0}\nindex={1}\nnum_descriptors={2}\nbase_shader_register={3}\nregister_space={4}\ndescriptor_range_type={5}\ndescriptor_range_flags={6}\n"
@@ -339,15 +376,82 @@ namespace RSim::Graphics
 			//	*descriptorRangeFlagsStr, parameterName);
 
 
-			m_DescriptorRanges[index].push_back(range);
+			m_DescriptorRanges.back().push_back(range);
 			++i;
 		}
 
+		if (!ValidateDescriptorRanges(m_DescriptorRanges.back(), parameterName))
+			return std::nullopt;
+
 		CD3DX12_ROOT_PARAMETER1 param1{};
-		param1.InitAsDescriptorTable((UINT)descriptorRangesNode.size(), m_DescriptorRanges[index].data(), visibility);
+		param1.InitAsDescriptorTable((UINT)m_DescriptorRanges.back().size(), m_DescriptorRanges.back().data(), visibility);
 		return param1;
 	}
 
+	bool RootSignatureFileDeserializer::ValidateDescriptorRanges(std::vector<CD3DX12_DESCRIPTOR_RANGE1> const& ranges,
+		std::string_view parameterName)
+	{
+		if (ranges.empty())
+		{
+			rsim_error("The descriptor table '{0}' has no ranges.", parameterName);
+			return false;
+		}
+
+		bool const hasSamplers = std::any_of(ranges.begin(), ranges.end(),
+			[](auto const& range) { return range.RangeType == D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER; });
+		bool const hasResources = std::any_of(ranges.begin(), ranges.end(),
+			[](auto const& range) { return range.RangeType != D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER; });
+		if (hasSamplers && hasResources)
+		{
+			rsim_error("The descriptor table '{0}' mixes sampler ranges with CBV/SRV/UAV ranges, they live in different heaps.", parameterName);
+			return false;
+		}
+
+		for (std::size_t i = 0; i < ranges.size(); ++i)
+		{
+			auto const& range = ranges[i];
+			bool const unbounded = range.NumDescriptors == UINT_MAX;
+
+			// An appended range would start at the end of an unbounded one, which has no end.
+			if (i > 0 && ranges[i - 1].NumDescriptors == UINT_MAX && range.OffsetInDescriptorsFromTableStart == D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND)
+			{
+				rsim_error("Range {0} of the descriptor table '{1}' follows an unbounded range, it needs an 'offset_from_table_start'.",
+				           i, parameterName);
+				return false;
+			}
+
+			if (!unbounded && (uint64_t)range.BaseShaderRegister + range.NumDescriptors > UINT_MAX)
+			{
+				rsim_error("The registers of range {0} of the descriptor table '{1}' overflow.", i, parameterName);
+				return false;
+			}
+
+			// Shader registers of the same type and space must not overlap, an unbounded range takes every register from its base on.
+			for (std::size_t j = 0; j < i; ++j)
+			{
+				auto const& other = ranges[j];
+				if (other.RangeType != range.RangeType || other.RegisterSpace != range.RegisterSpace)
+					continue;
+
+				uint64_t const end = unbounded ? UINT64_MAX : (uint64_t)range.BaseShaderRegister + range.NumDescriptors;
+				uint64_t const otherEnd = other.NumDescriptors == UINT_MAX ? UINT64_MAX : (uint64_t)other.BaseShaderRegister + other.NumDescriptors;
+				if (range.BaseShaderRegister < otherEnd && other.BaseShaderRegister < end)
+				{
+					rsim_error("Ranges {0} and {1} of the descriptor table '{2}' bind the same registers in space {3}.",
+					           j, i, parameterName, range.RegisterSpace);
+					return false;
+				}
+			}
+
+			if (unbounded && !(range.Flags & D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE))
+			{
+				rsim_warn("Unbounded range {0} of the descriptor table '{1}' is not 'descriptors_volatile', so every descriptor of the "
+				          "heap has to stay unchanged from setting the table until the GPU has executed the command list.", i, parameterName);
+			}
+		}
+		return true;
+	}
+
 
 	std::optional<std::pair<int32_t, int32_t>> RootSignatureFileDeserializer::ValidateShaderRegisterAndRegisterSpace(
 		YAML::Node const& node, std::string_view parameterName)
@@ -14,6 +14,12 @@ namespace RSim::Graphics
 		return { ShaderPath, nullptr,D3D_COMPILE_STANDARD_FILE_INCLUDE,"main","ps_5_1",0,ShaderType::Pixel };
 	}
 
+	ShaderCompilationParameters ShaderCompilationParameters::ComputeShaderDefaults(
+		LPCWSTR ShaderPath, LPCSTR EntryPoint)
+	{
+		return { ShaderPath, nullptr,D3D_COMPILE_STANDARD_FILE_INCLUDE,EntryPoint,"cs_5_1",0,ShaderType::Compute };
+	}
+
 	ShaderBlob ShaderCompiler::CompileShader(ShaderCompilationParameters const& param)
 	{
 		rsim_trace("Attempting to compile shader : '{0}'", Utils::WideStringToUTF8(std::wstring(param.ShaderPath)).c_str());
@@ -89,6 +89,10 @@ namespace RSim::Graphics
 			D3D12_SIGNATURE_PARAMETER_DESC signatureParameterDesc;
 			ThrowIfFailed(pReflection->GetInputParameterDesc(i, &signatureParameterDesc));
 
+			// System values such as SV_InstanceID and SV_VertexID are generated by the input assembler, not fetched from a vertex buffer.
+			if (signatureParameterDesc.SystemValueType != D3D_NAME_UNDEFINED)
+				continue;
+
 			VertexLayoutElement layoutElement{};
 
 			if (signatureParameterDesc.Mask == 1)
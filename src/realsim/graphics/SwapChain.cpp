@@ -22,7 +22,8 @@ namespace RSim::Graphics
 
 		bool tearingSupported = device.IsTearingSupported();
 		rsim_trace("Tearing Supported : {0}", tearingSupported);
-		swapChainDesc.Flags = tearingSupported ? DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING : 0;
+		swapChainDesc.Flags = DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+		swapChainDesc.Flags |= tearingSupported ? DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING : 0;
 
 		auto const& pDevice = device.GetDevice2();
 		HRESULT hr = pDXGIFactory->CreateSwapChainForHwnd(pCmdQueue,
@@ -67,10 +68,10 @@ namespace RSim::Graphics
 
 	void SwapChain::CreateBackBuffersFromSwapChain(ID3D12Device* pDevice,
 	                                               std::array<ID3D12Resource*, NumFramesInFlight>& pBackBufferResources,
-	                                               ID3D12DescriptorHeap* pDescHeap) const
+	                                               D3D12_CPU_DESCRIPTOR_HANDLE FirstRTV) const
 	{
 		// Back Buffer Resources
-		CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(pDescHeap->GetCPUDescriptorHandleForHeapStart());
+		CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(FirstRTV);
 
 		auto const DescriptorHandleIncrementSizes = GetDescriptorHandleIncrementSizes(pDevice);
 
@@ -111,4 +112,18 @@ namespace RSim::Graphics
 			}
 		}
 	}
+
+	HANDLE SwapChain::GetFrameLatencyWaitableObject() const
+	{
+		Microsoft::WRL::ComPtr<IDXGISwapChain2> pSwapChain2;
+		ThrowIfFailed(m_DXGISwapChain.As(&pSwapChain2));
+		return pSwapChain2->GetFrameLatencyWaitableObject();
+	}
+
+	void SwapChain::SetMaximumFrameLatency(UINT maxLatency) const
+	{
+		Microsoft::WRL::ComPtr<IDXGISwapChain2> pSwapChain2;
+		ThrowIfFailed(m_DXGISwapChain.As(&pSwapChain2));
+		ThrowIfFailed(pSwapChain2->SetMaximumFrameLatency(maxLatency));
+	}
 }
@@ -0,0 +1,90 @@
+#include "realsim/graphics/ViewSetup.h"
+#include "realsim/ecs/PerspectiveCameraComponent.h"
+
+#include <cstring>
+
+namespace RSim::Graphics
+{
+	bool ViewSetup::ViewInputs::operator==(ViewInputs const& Other) const
+	{
+		// Bitwise, a camera that was not touched compares equal and anything else is simply recomputed
+		return std::memcmp(this, &Other, sizeof(ViewInputs)) == 0;
+	}
+
+	std::size_t ViewSetup::Build(entt::registry& Registry, float OutputWidth, float OutputHeight)
+	{
+		std::swap(m_Views, m_PreviousViews);
+		std::swap(m_Inputs, m_PreviousInputs);
+		m_Views.clear();
+		m_Inputs.clear();
+		m_NumRecomputed = 0;
+
+		auto const cameras = Registry.view<ECS::PerspectiveCameraComponent>();
+		for (entt::entity const camera : cameras)
+		{
+			if (cameras.get<ECS::PerspectiveCameraComponent>(camera).IsPrimaryCamera)
+			{
+				AddView(Registry, camera, OutputWidth, OutputHeight);
+				break;
+			}
+		}
+		for (entt::entity const camera : cameras)
+		{
+			ECS::PerspectiveCameraComponent const& component = cameras.get<ECS::PerspectiveCameraComponent>(camera);
+			if (component.IsActive && !component.IsPrimaryCamera)
+				AddView(Registry, camera, OutputWidth, OutputHeight);
+		}
+		return m_Views.size();
+	}
+
+	void ViewSetup::AddView(entt::registry& Registry, entt::entity Camera, float OutputWidth, float OutputHeight)
+	{
+		ECS::PerspectiveCameraComponent const& camera = Registry.get<ECS::PerspectiveCameraComponent>(Camera);
+
+		ViewInputs inputs{};
+		DirectX::XMStoreFloat4x4(&inputs.ViewMatrix, camera.GetViewMatrix());
+		inputs.FOVHalfAngle = camera.FOVHalfAngle;
+		inputs.NearZ = camera.NearZ;
+		inputs.FarZ = camera.FarZ;
+		inputs.ViewportX = camera.ViewportX * OutputWidth;
+		inputs.ViewportY = camera.ViewportY * OutputHeight;
+		inputs.ViewportWidth = camera.ViewportWidth * OutputWidth;
+		inputs.ViewportHeight = camera.ViewportHeight * OutputHeight;
+		m_Inputs.push_back(inputs);
+
+		for (std::size_t i = 0; i < m_PreviousViews.size(); ++i)
+		{
+			if (m_PreviousViews[i].Camera == Camera && m_PreviousInputs[i] == inputs)
+			{
+				m_Views.push_back(m_PreviousViews[i]);
+				return;
+			}
+		}
+
+		RenderView& view = m_Views.emplace_back();
+		view.Camera = Camera;
+		view.ViewportX = inputs.ViewportX;
+		view.ViewportY = inputs.ViewportY;
+		view.ViewportWidth = inputs.ViewportWidth;
+		view.ViewportHeight = inputs.ViewportHeight;
+
+		float const aspectRatio = inputs.ViewportHeight > 0.0f ? inputs.ViewportWidth / inputs.ViewportHeight : 1.0f;
+		DirectX::XMMATRIX const viewMatrix = camera.GetViewMatrix();
+		DirectX::XMMATRIX const projection = camera.GetProjectionMatrix(aspectRatio);
+		DirectX::XMStoreFloat4x4(&view.Constants.View, viewMatrix);
+		DirectX::XMStoreFloat4x4(&view.Constants.Projection, projection);
+		DirectX::XMStoreFloat4x4(&view.Constants.ViewProjection, DirectX::XMMatrixMultiply(viewMatrix, projection));
+		DirectX::XMStoreFloat4(&view.Constants.CameraPosition, camera.GetCameraPosition());
+		view.ViewFrustum = Frustum::FromViewProjection(view.Constants.ViewProjection.m);
+		++m_NumRecomputed;
+	}
+
+	void ViewSetup::WriteConstants(void* pDestination) const
+	{
+		auto* const pBytes = static_cast<std::byte*>(pDestination);
+		for (std::size_t i = 0; i < m_Views.size(); ++i)
+		{
+			std::memcpy(pBytes + GetConstantsOffset(i), &m_Views[i].Constants, sizeof(ViewConstants));
+		}
+	}
+}
@@ -0,0 +1,71 @@
+#include "doctest/doctest.h"
+
+#include "realsim/graphics/NullDevice.h"
+
+#include <memory>
+#include <vector>
+
+using namespace RSim;
+
+TEST_CASE("Idle command allocators above the kept number are destroyed oldest first")
+{
+	Graphics::NullDevice device;
+	Graphics::NullCommandAllocatorPool pool(&device, Graphics::NullCommandListType::Direct);
+
+	// Eight allocators, discarded with fence values 1..8.
+	std::vector<std::weak_ptr<Graphics::NullCommandAllocator>> allocators;
+	{
+		std::vector<std::shared_ptr<Graphics::NullCommandAllocator>> inUse;
+		for (int i = 0; i < 8; ++i)
+		{
+			inUse.push_back(pool.RequestCommandAllocator(0));
+			allocators.push_back(inUse.back());
+		}
+		for (uint64_t i = 0; i < inUse.size(); ++i)
+		{
+			pool.DiscardAllocator(i + 1, inUse[i]);
+		}
+	}
+	CHECK(pool.Size() == 8);
+
+	// Nothing is released while fewer allocators than the kept number are completed.
+	CHECK(pool.ReleaseIdleAllocators(3, 3) == 0);
+	CHECK(pool.Size() == 8);
+
+	// Six are completed, two of them are kept. The four oldest are destroyed, the ones still waiting for the GPU are not.
+	CHECK(pool.ReleaseIdleAllocators(6, 2) == 4);
+	CHECK(pool.Size() == 4);
+	for (std::size_t i = 0; i < allocators.size(); ++i)
+	{
+		CHECK(allocators[i].expired() == (i < 4));
+	}
+
+	// The kept ones are reused before new allocators are created.
+	auto const reused = pool.RequestCommandAllocator(6);
+	CHECK(reused == allocators[4].lock());
+	CHECK(pool.Size() == 4);
+
+	pool.DiscardAllocator(9, reused);
+	CHECK(pool.ReleaseIdleAllocators(9, 0) == 4);
+	CHECK(pool.Size() == 0);
+	// Only the allocator held here is left.
+	CHECK(reused.use_count() == 1);
+	for (std::size_t i = 0; i < allocators.size(); ++i)
+	{
+		CHECK(allocators[i].expired() == (i != 4));
+	}
+}
+
+TEST_CASE("Releasing idle allocators with nothing discarded does nothing")
+{
+	Graphics::NullDevice device;
+	Graphics::NullCommandAllocatorPool pool(&device, Graphics::NullCommandListType::Compute);
+	CHECK(pool.ReleaseIdleAllocators(100, 0) == 0);
+
+	auto const allocator = pool.RequestCommandAllocator(100);
+	CHECK(pool.ReleaseIdleAllocators(100, 0) == 0);
+	CHECK(pool.Size() == 1);
+	pool.DiscardAllocator(101, allocator);
+	CHECK(pool.ReleaseIdleAllocators(100, 0) == 0);
+	CHECK(pool.ReleaseIdleAllocators(101, 0) == 1);
+}
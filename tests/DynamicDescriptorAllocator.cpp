@@ -0,0 +1,109 @@
+#include "doctest/doctest.h"
+
+#include "realsim/graphics/DynamicDescriptorAllocator.h"
+#include "realsim/graphics/NullDevice.h"
+
+#include <cstring>
+#include <vector>
+
+using namespace RSim;
+
+TEST_CASE("Dynamic descriptors are allocated from per-frame chunks that are reused once the frame's fence completes")
+{
+	Graphics::DynamicDescriptorAllocator allocator(1000, 64, 16);
+
+	// The first frame fills one chunk and starts a second, a request larger than a chunk gets a chunk of its own.
+	CHECK(allocator.Allocate(10) == 1000);
+	CHECK(allocator.Allocate(6) == 1010);
+	CHECK(allocator.Allocate(1) == 1016);
+	CHECK(allocator.Allocate(20) == 1032);
+	CHECK(allocator.GetNumFrameChunks() == 3);
+	CHECK(allocator.GetNumFreeDescriptors() == 12);
+	allocator.EndFrame(1);
+	CHECK(allocator.GetNumFrameChunks() == 0);
+
+	// The remaining descriptors are too few for a chunk, the next frame has to wait for the first frame's fence.
+	CHECK(allocator.Allocate(1) == Graphics::DynamicDescriptorAllocator::InvalidIndex);
+	allocator.EndFrame(2);
+
+	allocator.ReleaseCompletedFrames(1);
+	CHECK(allocator.GetNumFreeDescriptors() == 64);
+	CHECK(allocator.Allocate(16) == 1000);
+	allocator.EndFrame(3);
+
+	allocator.ReleaseCompletedFrames(2);
+	CHECK(allocator.GetNumFreeDescriptors() == 48);
+	allocator.ReleaseCompletedFrames(3);
+	CHECK(allocator.GetNumFreeDescriptors() == 64);
+}
+
+TEST_CASE("Descriptor copies are merged into contiguous ranges and copied like CopyDescriptors does")
+{
+	Graphics::NullDevice device;
+	uint32_t const descriptorSize = device.GetDescriptorHandleIncrementSize(Graphics::NullDescriptorHeapType::CBV_SRV_UAV);
+	auto const sources = device.CreateDescriptorHeap(Graphics::NullDescriptorHeapType::CBV_SRV_UAV, 16, false);
+	auto const shaderVisible = device.CreateDescriptorHeap(Graphics::NullDescriptorHeapType::CBV_SRV_UAV, 16, true);
+
+	// Every source descriptor is filled with its index.
+	std::size_t const sourceStart = sources->GetCPUDescriptorHandleForHeapStart();
+	std::size_t const destStart = shaderVisible->GetCPUDescriptorHandleForHeapStart();
+	for (uint32_t i = 0; i < 16; ++i)
+	{
+		std::memset(reinterpret_cast<void*>(sourceStart + (std::size_t)i * descriptorSize), (int)i, descriptorSize);
+	}
+	std::memset(reinterpret_cast<void*>(destStart), 0xFF, (std::size_t)16 * descriptorSize);
+
+	// Sources 2,3,4 and 9,10 go to destinations 0..4, then source 5 to destination 8.
+	std::vector<uint32_t> const sourceIndices = { 2, 3, 4, 9, 10, 5 };
+	std::vector<uint32_t> const destIndices = { 0, 1, 2, 3, 4, 8 };
+	Graphics::DescriptorCopyBatch batch(descriptorSize);
+	for (std::size_t i = 0; i < sourceIndices.size(); ++i)
+	{
+		batch.Add(sourceStart + (std::size_t)sourceIndices[i] * descriptorSize, sourceStart, destStart + (std::size_t)destIndices[i] * descriptorSize,
+			destStart, 1);
+	}
+
+	CHECK(batch.GetNumDescriptors() == 6);
+	std::vector<uint32_t> const expectedSourceSizes = { 3, 2, 1 };
+	std::vector<uint32_t> const expectedDestSizes = { 5, 1 };
+	REQUIRE(batch.GetSourceSizes() == expectedSourceSizes);
+	REQUIRE(batch.GetDestSizes() == expectedDestSizes);
+	CHECK(batch.GetSourceStarts()[1] == sourceStart + (std::size_t)9 * descriptorSize);
+	CHECK(batch.GetDestStarts()[1] == destStart + (std::size_t)8 * descriptorSize);
+
+	batch.EmulateCopy();
+	for (std::size_t i = 0; i < sourceIndices.size(); ++i)
+	{
+		auto const* pDescriptor = reinterpret_cast<unsigned char const*>(destStart + (std::size_t)destIndices[i] * descriptorSize);
+		CHECK(pDescriptor[0] == sourceIndices[i]);
+		CHECK(pDescriptor[descriptorSize - 1] == sourceIndices[i]);
+	}
+	CHECK(*reinterpret_cast<unsigned char const*>(destStart + (std::size_t)5 * descriptorSize) == 0xFF);
+
+	batch.Clear();
+	CHECK(batch.IsEmpty());
+	CHECK(batch.GetSourceStarts().empty());
+}
+
+TEST_CASE("Descriptor copies are only merged within the same heap")
+{
+	Graphics::NullDevice device;
+	uint32_t const descriptorSize = device.GetDescriptorHandleIncrementSize(Graphics::NullDescriptorHeapType::CBV_SRV_UAV);
+	auto const sources = device.CreateDescriptorHeap(Graphics::NullDescriptorHeapType::CBV_SRV_UAV, 4, false);
+	auto const shaderVisible = device.CreateDescriptorHeap(Graphics::NullDescriptorHeapType::CBV_SRV_UAV, 4, true);
+	std::size_t const sourceStart = sources->GetCPUDescriptorHandleForHeapStart();
+	std::size_t const destStart = shaderVisible->GetCPUDescriptorHandleForHeapStart();
+
+	// The second source follows the first in memory but is said to be in another heap, as the end of one heap and the start of the next
+	// may be.
+	std::size_t const otherHeap = sourceStart + (std::size_t)2 * descriptorSize;
+	Graphics::DescriptorCopyBatch batch(descriptorSize);
+	batch.Add(sourceStart + descriptorSize, sourceStart, destStart, destStart, 1);
+	batch.Add(otherHeap, otherHeap, destStart + descriptorSize, destStart, 1);
+	batch.Add(otherHeap + descriptorSize, otherHeap, destStart + (std::size_t)2 * descriptorSize, destStart, 1);
+
+	std::vector<uint32_t> const expectedSourceSizes = { 1, 2 };
+	std::vector<uint32_t> const expectedDestSizes = { 3 };
+	CHECK(batch.GetSourceSizes() == expectedSourceSizes);
+	CHECK(batch.GetDestSizes() == expectedDestSizes);
+}
@@ -0,0 +1,53 @@
+#include "doctest/doctest.h"
+
+#include "realsim/graphics/FrameLatencyTracker.h"
+
+using namespace RSim;
+
+TEST_CASE("The CPU waits for the frame MaxFrameLatency frames back")
+{
+	Graphics::FrameLatencyTracker tracker(2);
+	CHECK(!tracker.GetFenceValueToWaitFor().has_value());
+
+	tracker.EndFrame(10, 0, 16.0f, 0.0f);
+	CHECK(!tracker.GetFenceValueToWaitFor().has_value());
+	tracker.EndFrame(11, 0, 16.0f, 0.0f);
+	CHECK(tracker.GetFenceValueToWaitFor().value_or(0) == 10);
+	tracker.EndFrame(12, 10, 16.0f, 0.0f);
+	CHECK(tracker.GetFenceValueToWaitFor().value_or(0) == 11);
+	// The fence values wrap around the NumFramesInFlight slots.
+	tracker.EndFrame(13, 11, 16.0f, 0.0f);
+	CHECK(tracker.GetFenceValueToWaitFor().value_or(0) == 12);
+	CHECK(tracker.GetFrameNumber() == 4);
+
+	// A latency of one waits for the previous frame.
+	tracker.SetMaxFrameLatency(1);
+	CHECK(tracker.GetFenceValueToWaitFor().value_or(0) == 13);
+}
+
+TEST_CASE("The frame latency is clamped to the number of frames in flight")
+{
+	Graphics::FrameLatencyTracker tracker(0);
+	CHECK(tracker.GetMaxFrameLatency() == 1);
+	tracker.SetMaxFrameLatency(100);
+	CHECK(tracker.GetMaxFrameLatency() == Graphics::NumFramesInFlight);
+}
+
+TEST_CASE("Frame pacing statistics count the unfinished frames and smooth the timings")
+{
+	Graphics::FrameLatencyTracker tracker(3);
+	tracker.EndFrame(1, 0, 20.0f, 5.0f);
+	auto const& statistics = tracker.GetStatistics();
+	CHECK(statistics.FrameCount == 1);
+	CHECK(statistics.CPUFrameTimeMs == 20.0f);
+	CHECK(statistics.CPUWaitTimeMs == 5.0f);
+	CHECK(statistics.CPUBusyRatio == doctest::Approx(0.75f));
+	CHECK(statistics.FramesInFlight == 1.0f);
+
+	// Two more frames submitted while the GPU finished none, then a sample 10ms longer moves the average by a tenth of that.
+	tracker.EndFrame(2, 0, 20.0f, 5.0f);
+	tracker.EndFrame(3, 1, 30.0f, 5.0f);
+	CHECK(statistics.CPUFrameTimeMs == doctest::Approx(21.0f));
+	CHECK(statistics.FramesInFlight > 1.0f);
+	CHECK(statistics.FramesInFlight < 2.0f);
+}
@@ -0,0 +1,55 @@
+#include "doctest/doctest.h"
+
+#include "realsim/graphics/FreeListAllocator.h"
+
+using namespace RSim;
+
+TEST_CASE("Freed blocks are merged with their free neighbours")
+{
+	Graphics::FreeListAllocator allocator(100);
+	auto a = allocator.Allocate(10);
+	auto b = allocator.Allocate(20);
+	auto c = allocator.Allocate(30);
+	REQUIRE(a.IsValid());
+	REQUIRE(b.IsValid());
+	REQUIRE(c.IsValid());
+	CHECK(a.Offset == 0);
+	CHECK(b.Offset == 10);
+	CHECK(c.Offset == 30);
+	CHECK(allocator.GetFreeSize() == 40);
+	CHECK(!allocator.Allocate(41).IsValid());
+
+	// Freeing the block after a free block, before a free block, and between two free blocks.
+	allocator.Free(a);
+	CHECK(!a.IsValid());
+	CHECK(allocator.GetNumFreeBlocks() == 2);
+	allocator.Free(c);
+	CHECK(allocator.GetNumFreeBlocks() == 2);
+	allocator.Free(b);
+	CHECK(allocator.GetNumFreeBlocks() == 1);
+	CHECK(allocator.IsEmpty());
+
+	auto whole = allocator.Allocate(100);
+	CHECK(whole.Offset == 0);
+	CHECK(allocator.IsFull());
+	allocator.Free(whole);
+}
+
+TEST_CASE("GPU allocations are reused only once their fence has completed")
+{
+	Graphics::FreeListGPUAllocator allocator(4);
+	auto first = allocator.Allocate(2);
+	auto second = allocator.Allocate(2);
+	REQUIRE(allocator.IsFull());
+
+	allocator.Free(first, 5);
+	allocator.Free(second, 6);
+	CHECK(allocator.GetStaleAllocationsSize() == 4);
+	CHECK(!allocator.Allocate(1).IsValid());
+
+	allocator.ReleaseStaleAllocations(5);
+	CHECK(allocator.GetFreeSize() == 2);
+	allocator.ReleaseStaleAllocations(6);
+	CHECK(allocator.GetStaleAllocationsSize() == 0);
+	CHECK(allocator.IsEmpty());
+}
@@ -0,0 +1,124 @@
+#include "doctest/doctest.h"
+
+#include "realsim/core/ThreadPool.h"
+#include "realsim/graphics/FrustumCulling.h"
+
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace RSim;
+
+namespace
+{
+	// Left-handed perspective projection with a [0, 1] depth range, looking down +z from the origin.
+	Graphics::Frustum MakeFrustum()
+	{
+		float const nearZ = 0.1f;
+		float const farZ = 100.0f;
+		float const yScale = 1.0f / std::tan(0.5f);
+		float const xScale = yScale / 1.5f;
+		float const projection[4][4] = {
+			{ xScale, 0.0f, 0.0f, 0.0f },
+			{ 0.0f, yScale, 0.0f, 0.0f },
+			{ 0.0f, 0.0f, farZ / (farZ - nearZ), 1.0f },
+			{ 0.0f, 0.0f, -nearZ * farZ / (farZ - nearZ), 0.0f } };
+		return Graphics::Frustum::FromViewProjection(projection);
+	}
+}
+
+TEST_CASE("frustum culling keeps boxes in front of the camera")
+{
+	Graphics::Frustum const frustum = MakeFrustum();
+	Graphics::BoundingBoxes boxes;
+	boxes.Resize(4);
+	boxes.Set(0, 0.0f, 0.0f, 10.0f, 1.0f, 1.0f, 1.0f);   // In front
+	boxes.Set(1, 0.0f, 0.0f, -10.0f, 1.0f, 1.0f, 1.0f);  // Behind
+	boxes.Set(2, 50.0f, 0.0f, 10.0f, 1.0f, 1.0f, 1.0f);  // Far to the right
+	boxes.Set(3, 0.0f, 0.0f, 100.5f, 1.0f, 1.0f, 1.0f);  // Straddles the far plane
+
+	Graphics::FrustumCuller culler;
+	REQUIRE(culler.Cull(frustum, boxes, nullptr) == 2);
+	CHECK(culler.GetVisibleIndices()[0] == 0);
+	CHECK(culler.GetVisibleIndices()[1] == 3);
+}
+
+TEST_CASE("parallel SIMD frustum culling matches the scalar test on 1M boxes")
+{
+	constexpr std::size_t NumBoxes = 1'000'000;
+
+	Graphics::Frustum const frustum = MakeFrustum();
+	Graphics::BoundingBoxes boxes;
+	boxes.Resize(NumBoxes);
+
+	std::mt19937 rng(42);
+	std::uniform_real_distribution<float> position(-150.0f, 150.0f);
+	std::uniform_real_distribution<float> extent(0.0f, 2.0f);
+	for (std::size_t i = 0; i < NumBoxes; ++i)
+		boxes.Set(i, position(rng), position(rng), position(rng), extent(rng), extent(rng), extent(rng));
+
+	std::vector<uint32_t> expected;
+	for (std::size_t i = 0; i < NumBoxes; ++i)
+	{
+		if (Graphics::FrustumCuller::IsVisible(frustum, boxes, i))
+			expected.push_back((uint32_t)i);
+	}
+
+	Core::ThreadPool pool;
+	Graphics::FrustumCuller culler;
+
+	auto const start = std::chrono::steady_clock::now();
+	culler.Cull(frustum, boxes, &pool);
+	auto const elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	MESSAGE("Culled " << NumBoxes << " boxes on " << pool.GetMaxParallelism() << " threads in " << elapsed << " ms");
+
+	CHECK(culler.GetVisibleIndices() == expected);
+
+	culler.Cull(frustum, boxes, nullptr);
+	CHECK(culler.GetVisibleIndices() == expected);
+}
+
+TEST_CASE("SIMD and scalar frustum culling agree on boxes touching a plane")
+{
+	// An oblique plane, the other planes accept everything.
+	Graphics::Frustum frustum{};
+	for (auto& plane : frustum.Planes)
+	{
+		plane = Graphics::FrustumPlane{ 0.0f, 0.0f, 0.0f, 1.0f };
+	}
+	float const length = std::sqrt(0.3f * 0.3f + 0.5f * 0.5f + 0.7f * 0.7f);
+	Graphics::FrustumPlane const plane{ 0.3f / length, -0.5f / length, 0.7f / length, 13.37f };
+	frustum.Planes[2] = plane;
+
+	// Boxes pushed along the plane's normal until they just touch it, where rounding decides whether they are visible.
+	constexpr std::size_t NumBoxes = 4096;
+	Graphics::BoundingBoxes boxes;
+	boxes.Resize(NumBoxes);
+	std::mt19937 rng(7);
+	std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+	std::uniform_real_distribution<float> extent(0.0f, 2.0f);
+	for (std::size_t i = 0; i < NumBoxes; ++i)
+	{
+		float const x = position(rng), y = position(rng), z = position(rng);
+		float const ex = extent(rng), ey = extent(rng), ez = extent(rng);
+		float const distance = plane.NormalX * x + plane.NormalY * y + plane.NormalZ * z + plane.Distance;
+		float const radius = std::abs(plane.NormalX) * ex + std::abs(plane.NormalY) * ey + std::abs(plane.NormalZ) * ez;
+		float const push = -(distance + radius);
+		boxes.Set(i, x + push * plane.NormalX, y + push * plane.NormalY, z + push * plane.NormalZ, ex, ey, ez);
+	}
+
+	std::vector<uint32_t> expected;
+	for (std::size_t i = 0; i < NumBoxes; ++i)
+	{
+		if (Graphics::FrustumCuller::IsVisible(frustum, boxes, i))
+			expected.push_back((uint32_t)i);
+	}
+	// Rounding puts some of the boxes on either side of the plane.
+	CHECK(!expected.empty());
+	CHECK(expected.size() < NumBoxes);
+
+	Graphics::FrustumCuller culler;
+	culler.Cull(frustum, boxes, nullptr);
+	CHECK(culler.GetVisibleIndices() == expected);
+}
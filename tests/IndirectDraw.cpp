@@ -0,0 +1,178 @@
+#include "doctest/doctest.h"
+
+#include "realsim/graphics/IndirectDraw.h"
+#include "realsim/graphics/NullDevice.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+using namespace RSim;
+
+namespace
+{
+	DirectX::XMFLOAT4X4 Translation(float X, float Y, float Z)
+	{
+		return DirectX::XMFLOAT4X4(
+			1.0f, 0.0f, 0.0f, 0.0f,
+			0.0f, 1.0f, 0.0f, 0.0f,
+			0.0f, 0.0f, 1.0f, 0.0f,
+			X, Y, Z, 1.0f);
+	}
+
+	Graphics::IndirectMesh UnitCube(uint32_t NumIndices, uint32_t FirstIndex)
+	{
+		Graphics::IndirectMesh mesh{};
+		mesh.NumIndices = NumIndices;
+		mesh.FirstIndex = FirstIndex;
+		mesh.LocalExtent[0] = mesh.LocalExtent[1] = mesh.LocalExtent[2] = 0.5f;
+		return mesh;
+	}
+
+	/**
+	 * \brief The half-space x >= MinX, as a frustum whose other planes accept everything.
+	 */
+	Graphics::Frustum HalfSpace(float MinX)
+	{
+		Graphics::Frustum frustum{};
+		for (auto& plane : frustum.Planes)
+		{
+			plane = Graphics::FrustumPlane{ 0.0f, 0.0f, 0.0f, 1.0f };
+		}
+		frustum.Planes[0] = Graphics::FrustumPlane{ 1.0f, 0.0f, 0.0f, -MinX };
+		return frustum;
+	}
+}
+
+TEST_CASE("The indirect draw buffers are laid out for the culling passes and culled per view")
+{
+	// Instances alternate between two meshes, every fourth one with another material.
+	constexpr std::size_t NumInstances = 40;
+	std::vector<Graphics::InstanceGroupKey> keys(NumInstances);
+	for (std::size_t i = 0; i < NumInstances; ++i)
+	{
+		keys[i] = Graphics::InstanceGroupKey{ (uint32_t)(i % 2), i % 4 == 3 ? 1u : 0u };
+	}
+	std::vector<Graphics::IndirectMesh> const meshes = { UnitCube(36, 0), UnitCube(6, 36) };
+
+	Graphics::IndirectDrawBuilder builder;
+	builder.Build(keys.data(), keys.size(), meshes.data(), meshes.size(), 2);
+	REQUIRE(builder.GetNumGroups() == 3);
+	CHECK(builder.GetMeshesOffset() % Graphics::IndirectDrawBuilder::SectionAlignment == 0);
+	CHECK(builder.GetCommandTemplateOffset() % Graphics::IndirectDrawBuilder::SectionAlignment == 0);
+	CHECK(builder.GetZeroCountsOffset() % Graphics::IndirectDrawBuilder::SectionAlignment == 0);
+	CHECK(builder.GetMeshesOffset() >= NumInstances * sizeof(Graphics::GPUInstance));
+	CHECK(builder.GetCommandBufferSize() == 2 * 3 * sizeof(Graphics::IndirectCommand));
+	CHECK(builder.GetCommandOffset(1) == 3 * sizeof(Graphics::IndirectCommand));
+	CHECK(builder.GetCountOffset(1) == sizeof(uint32_t));
+	CHECK(Graphics::IndirectDrawBuilder::GetNumThreadGroups(NumInstances) == 1);
+	CHECK(Graphics::IndirectDrawBuilder::GetNumThreadGroups(65) == 2);
+
+	Graphics::NullDevice device;
+	auto const upload = device.CreateCommittedResource(builder.GetUploadSize());
+	auto const groupCommands = device.CreateCommittedResource(builder.GetCommandBufferSize());
+	auto const commands = device.CreateCommittedResource(builder.GetCommandBufferSize());
+	auto const visibleInstances = device.CreateCommittedResource(builder.GetVisibleInstanceBufferSize());
+	auto const counts = device.CreateCommittedResource(builder.GetCountBufferSize());
+
+	// Instance i sits at x = i, so the half-space x >= MinX keeps the instances from MinX on.
+	auto* const pUpload = static_cast<std::byte*>(upload->Map());
+	for (std::size_t i = 0; i < NumInstances; ++i)
+	{
+		builder.WriteInstance(pUpload, i, Translation((float)i, 0.0f, 0.0f), DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f));
+	}
+	builder.WriteTables(pUpload);
+
+	auto const* const pInstances = reinterpret_cast<Graphics::GPUInstance const*>(pUpload + builder.GetInstancesOffset());
+	auto const* const pTemplate = reinterpret_cast<Graphics::IndirectCommand const*>(pUpload + builder.GetCommandTemplateOffset());
+	std::vector<Graphics::InstanceGroup> const& groups = builder.GetGroups();
+	for (std::size_t g = 0; g < groups.size(); ++g)
+	{
+		CHECK(pTemplate[g].FirstInstance == groups[g].FirstInstance);
+		CHECK(pTemplate[g].Draw.InstanceCount == 0);
+		CHECK(pTemplate[g].Draw.IndexCountPerInstance == meshes[groups[g].Key.MeshID].NumIndices);
+		CHECK(pTemplate[g].Draw.StartIndexLocation == meshes[groups[g].Key.MeshID].FirstIndex);
+		CHECK(pTemplate[g].Draw.StartInstanceLocation == 0);
+		for (uint32_t slot = groups[g].FirstInstance; slot < groups[g].FirstInstance + groups[g].NumInstances; ++slot)
+		{
+			CHECK(pInstances[slot].GroupIndex == g);
+			CHECK(pInstances[slot].MeshIndex == groups[g].Key.MeshID);
+		}
+	}
+
+	// What the copies at the start of the compute list do.
+	for (std::size_t v = 0; v < builder.GetNumViews(); ++v)
+	{
+		std::memcpy(static_cast<std::byte*>(groupCommands->Map()) + builder.GetCommandOffset(v), pTemplate, builder.GetCommandTemplateSize());
+	}
+	std::memcpy(counts->Map(), pUpload + builder.GetZeroCountsOffset(), builder.GetCountBufferSize());
+
+	// View 0 sees everything, view 1 only the instances at x >= 30 (the box of instance 29 reaches up to 29.5).
+	Graphics::Frustum const frusta[2] = { HalfSpace(-1000.0f), HalfSpace(30.0f) };
+	auto* const pGroupCommands = static_cast<Graphics::IndirectCommand*>(groupCommands->Map());
+	auto* const pCommands = static_cast<Graphics::IndirectCommand*>(commands->Map());
+	auto* const pVisible = static_cast<uint32_t*>(visibleInstances->Map());
+	auto* const pCounts = static_cast<uint32_t*>(counts->Map());
+	for (std::size_t v = 0; v < 2; ++v)
+	{
+		Graphics::IndirectDrawBuilder::EmulateCulling(builder.GetCullConstants(v, frusta[v]),
+			pInstances, reinterpret_cast<Graphics::IndirectMesh const*>(pUpload + builder.GetMeshesOffset()),
+			pGroupCommands, pVisible, pCommands, pCounts);
+	}
+
+	REQUIRE(pCounts[0] == 3);
+	REQUIRE(pCounts[1] == 3);
+	for (std::size_t v = 0; v < 2; ++v)
+	{
+		uint32_t numDrawn = 0;
+		Graphics::IndirectCommand const* pViewCommands = pCommands + builder.GetCommandOffset(v) / sizeof(Graphics::IndirectCommand);
+		for (uint32_t c = 0; c < pCounts[v]; ++c)
+		{
+			Graphics::IndirectCommand const& command = pViewCommands[c];
+			CHECK(command.Draw.InstanceCount > 0);
+			numDrawn += command.Draw.InstanceCount;
+			for (uint32_t i = 0; i < command.Draw.InstanceCount; ++i)
+			{
+				// Every drawn instance is visible to the view and belongs to the command's group.
+				uint32_t const instance = pVisible[command.FirstInstance + i];
+				CHECK(pInstances[instance].World._41 >= (v == 0 ? 0.0f : 30.0f));
+				CHECK(meshes[pInstances[instance].MeshIndex].NumIndices == command.Draw.IndexCountPerInstance);
+			}
+		}
+		CHECK(numDrawn == (v == 0 ? NumInstances : 10));
+	}
+}
+
+TEST_CASE("Groups without visible instances are not drawn")
+{
+	std::vector<Graphics::InstanceGroupKey> const keys = { { 0, 0 }, { 1, 0 }, { 0, 0 } };
+	std::vector<Graphics::IndirectMesh> const meshes = { UnitCube(36, 0), UnitCube(36, 0) };
+
+	Graphics::IndirectDrawBuilder builder;
+	builder.Build(keys.data(), keys.size(), meshes.data(), meshes.size(), 1);
+	REQUIRE(builder.GetNumGroups() == 2);
+
+	std::vector<std::byte> upload(builder.GetUploadSize());
+	builder.WriteInstance(upload.data(), 0, Translation(10.0f, 0.0f, 0.0f), {});
+	builder.WriteInstance(upload.data(), 1, Translation(-10.0f, 0.0f, 0.0f), {});
+	builder.WriteInstance(upload.data(), 2, Translation(20.0f, 0.0f, 0.0f), {});
+	builder.WriteTables(upload.data());
+
+	std::vector<Graphics::IndirectCommand> groupCommands(builder.GetNumGroups());
+	std::memcpy(groupCommands.data(), upload.data() + builder.GetCommandTemplateOffset(), builder.GetCommandTemplateSize());
+	std::vector<Graphics::IndirectCommand> commands(builder.GetNumGroups());
+	std::vector<uint32_t> visible(builder.GetNumInstances());
+	uint32_t count = 0;
+
+	Graphics::IndirectDrawBuilder::EmulateCulling(builder.GetCullConstants(0, HalfSpace(0.0f)),
+		reinterpret_cast<Graphics::GPUInstance const*>(upload.data()),
+		reinterpret_cast<Graphics::IndirectMesh const*>(upload.data() + builder.GetMeshesOffset()),
+		groupCommands.data(), visible.data(), commands.data(), &count);
+
+	REQUIRE(count == 1);
+	CHECK(commands[0].Draw.InstanceCount == 2);
+	CHECK(commands[0].FirstInstance == 0);
+	CHECK(visible[0] == builder.GetGroups()[0].FirstInstance);
+	CHECK(visible[1] == builder.GetGroups()[0].FirstInstance + 1);
+}
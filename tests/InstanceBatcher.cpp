@@ -0,0 +1,93 @@
+#include "doctest/doctest.h"
+
+#include "realsim/graphics/InstanceBatcher.h"
+
+#include <cstddef>
+#include <vector>
+
+using namespace RSim;
+
+TEST_CASE("Draws are grouped by mesh and material in the order their groups first appear")
+{
+	// Mesh 1 is drawn with two materials, the draws of each group are interleaved with the others.
+	std::vector<Graphics::InstanceGroupKey> const keys = {
+		{ 1, 0 }, { 0, 0 }, { 1, 0 }, { 1, 2 }, { 0, 0 }, { 1, 0 }, { 1, 2 }
+	};
+	Graphics::InstanceBatcher batcher;
+	batcher.Build(keys.data(), keys.size());
+
+	auto const& groups = batcher.GetGroups();
+	REQUIRE(groups.size() == 3);
+	CHECK(groups[0].Key == keys[0]);
+	CHECK(groups[1].Key == keys[1]);
+	CHECK(groups[2].Key == keys[3]);
+	CHECK(groups[0].FirstInstance == 0);
+	CHECK(groups[0].NumInstances == 3);
+	CHECK(groups[1].FirstInstance == 3);
+	CHECK(groups[1].NumInstances == 2);
+	CHECK(groups[2].FirstInstance == 5);
+	CHECK(groups[2].NumInstances == 2);
+	CHECK(batcher.GetNumInstances() == keys.size());
+
+	// Draws keep their relative order within their group's contiguous range of slots.
+	std::vector<uint32_t> const expectedSlots = { 0, 3, 1, 5, 4, 2, 6 };
+	for (std::size_t i = 0; i < keys.size(); ++i)
+	{
+		CHECK(batcher.GetInstanceIndex(i) == expectedSlots[i]);
+	}
+}
+
+TEST_CASE("Every draw gets its own slot inside its group's range")
+{
+	constexpr std::size_t NumDraws = 1000;
+	std::vector<Graphics::InstanceGroupKey> keys(NumDraws);
+	for (std::size_t i = 0; i < NumDraws; ++i)
+	{
+		keys[i] = Graphics::InstanceGroupKey{ (uint32_t)(i * 7 % 5), (uint32_t)(i % 3) };
+	}
+	Graphics::InstanceBatcher batcher;
+	batcher.Build(keys.data(), keys.size());
+	CHECK(batcher.GetGroups().size() == 15);
+
+	std::vector<int> slotUses(NumDraws, 0);
+	for (std::size_t i = 0; i < NumDraws; ++i)
+	{
+		uint32_t const slot = batcher.GetInstanceIndex(i);
+		REQUIRE(slot < NumDraws);
+		++slotUses[slot];
+
+		bool inGroup = false;
+		for (auto const& group : batcher.GetGroups())
+		{
+			if (group.Key == keys[i])
+			{
+				inGroup = slot >= group.FirstInstance && slot < group.FirstInstance + group.NumInstances;
+			}
+		}
+		CHECK(inGroup);
+	}
+	for (int const uses : slotUses)
+	{
+		CHECK(uses == 1);
+	}
+}
+
+TEST_CASE("Rebuilding the batches replaces the previous groups")
+{
+	std::vector<Graphics::InstanceGroupKey> const first = { { 0, 0 }, { 1, 0 }, { 2, 0 } };
+	std::vector<Graphics::InstanceGroupKey> const second = { { 2, 0 }, { 2, 0 } };
+	Graphics::InstanceBatcher batcher;
+	batcher.Build(first.data(), first.size());
+	batcher.Build(second.data(), second.size());
+
+	REQUIRE(batcher.GetGroups().size() == 1);
+	CHECK(batcher.GetGroups()[0].Key == second[0]);
+	CHECK(batcher.GetGroups()[0].NumInstances == 2);
+	CHECK(batcher.GetNumInstances() == 2);
+	CHECK(batcher.GetInstanceIndex(0) == 0);
+	CHECK(batcher.GetInstanceIndex(1) == 1);
+
+	batcher.Build(nullptr, 0);
+	CHECK(batcher.GetGroups().empty());
+	CHECK(batcher.GetNumInstances() == 0);
+}
@@ -0,0 +1,99 @@
+#include "doctest/doctest.h"
+
+#include "realsim/core/LinearArena.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace RSim;
+
+namespace
+{
+	bool IsAligned(void const* Pointer, std::size_t Alignment)
+	{
+		return reinterpret_cast<std::uintptr_t>(Pointer) % Alignment == 0;
+	}
+}
+
+TEST_CASE("Arena allocations are aligned and padding counts towards the used size")
+{
+	Core::LinearArena arena(1024);
+	CHECK(arena.GetUsedSize() == 0);
+
+	auto* const first = static_cast<std::byte*>(arena.Allocate(1, 1));
+	CHECK(arena.GetUsedSize() == 1);
+
+	// 1 byte used, so an 8-byte aligned allocation is padded by 7 bytes.
+	auto* const second = static_cast<std::byte*>(arena.Allocate(8, 8));
+	CHECK(IsAligned(second, 8));
+	CHECK(second == first + 8);
+	CHECK(arena.GetUsedSize() == 16);
+
+	std::size_t const alignments[] = { 1, 2, 4, 8, 16, alignof(std::max_align_t) };
+	for (int i = 0; i < 50; ++i)
+	{
+		std::size_t const alignment = alignments[i % 6];
+		void* const pointer = arena.Allocate((std::size_t)i % 7 + 1, alignment);
+		CHECK(IsAligned(pointer, alignment));
+	}
+}
+
+TEST_CASE("The arena grows past its first block without moving earlier allocations")
+{
+	constexpr std::size_t BlockSize = 256;
+	Core::LinearArena arena(BlockSize);
+
+	// 10 allocations of 100 bytes, two fit into a block.
+	std::vector<std::byte*> allocations;
+	for (int i = 0; i < 10; ++i)
+	{
+		auto* const pointer = static_cast<std::byte*>(arena.Allocate(100, 4));
+		std::memset(pointer, i, 100);
+		allocations.push_back(pointer);
+	}
+	for (std::size_t i = 0; i < allocations.size(); ++i)
+	{
+		CHECK(allocations[i][0] == (std::byte)i);
+		CHECK(allocations[i][99] == (std::byte)i);
+	}
+	// The second allocation of a block follows the first one, the next one starts a new block.
+	CHECK(allocations[1] == allocations[0] + 100);
+	CHECK(allocations[2] != allocations[1] + 100);
+
+	// Larger than a block, it gets a block of its own and is still usable in full.
+	auto* const large = static_cast<std::byte*>(arena.Allocate(4 * BlockSize, 16));
+	CHECK(IsAligned(large, 16));
+	std::memset(large, 0xAB, 4 * BlockSize);
+	CHECK(allocations[9][0] == (std::byte)9);
+	CHECK(arena.GetUsedSize() >= 10 * 100 + 4 * BlockSize);
+}
+
+TEST_CASE("Reset rewinds the arena and reuses its blocks")
+{
+	Core::LinearArena arena(256);
+	std::vector<void*> firstPass;
+	for (int i = 0; i < 10; ++i)
+	{
+		firstPass.push_back(arena.Allocate(100, 8));
+	}
+	void* const large = arena.Allocate(1000, 8);
+
+	arena.Reset();
+	CHECK(arena.GetUsedSize() == 0);
+
+	// The same sequence of allocations gets the same memory back, nothing new is allocated.
+	for (int i = 0; i < 10; ++i)
+	{
+		CHECK(arena.Allocate(100, 8) == firstPass[(std::size_t)i]);
+	}
+	CHECK(arena.Allocate(1000, 8) == large);
+	// Every block's second allocation is padded from offset 100 to 104.
+	CHECK(arena.GetUsedSize() == 10 * 100 + 5 * 4 + 1000);
+
+	// Moving the arena keeps its blocks.
+	Core::LinearArena moved = std::move(arena);
+	moved.Reset();
+	CHECK(moved.Allocate(100, 8) == firstPass[0]);
+}
@@ -0,0 +1,61 @@
+#include "doctest/doctest.h"
+
+#include "realsim/math/Alignment.h"
+
+#include <cstdint>
+
+// Everything is constexpr, the results are checked at compile time first and at run time below, where MSVC takes a different path
+static_assert(Math::CountTrailingZeros(1) == 0);
+static_assert(Math::CountTrailingZeros(0x80ULL) == 7);
+static_assert(Math::CountTrailingZeros(uint64_t(1) << 63) == 63);
+static_assert(Math::CountTrailingZeros(0) == 64);
+static_assert(Math::CountLeadingZeros(1) == 63);
+static_assert(Math::CountLeadingZeros(~0ULL) == 0);
+static_assert(Math::CountLeadingZeros(0) == 64);
+static_assert(Math::PopCount(0) == 0);
+static_assert(Math::PopCount(0xF0F0ULL) == 8);
+static_assert(Math::PopCount(~0ULL) == 64);
+
+static_assert(Math::Log2Floor(1) == 0);
+static_assert(Math::Log2Floor(1000) == 9);
+static_assert(Math::Log2(0) == 0);
+static_assert(Math::Log2(1) == 0);
+static_assert(Math::Log2(1024) == 10);
+static_assert(Math::Log2(1025) == 11);
+static_assert(Math::NextPowerOfTwo(0) == 1);
+static_assert(Math::NextPowerOfTwo(33) == 64);
+static_assert(Math::NextPowerOfTwo(uint64_t(1) << 40) == uint64_t(1) << 40);
+
+// Values past 2^31 used to shift a 32-bit int
+static_assert(Math::AlignPowerOfTwo(uint64_t(0x1'0000'0001)) == 0x2'0000'0000ULL);
+static_assert(Math::AlignPowerOfTwo(0u) == 0u);
+static_assert(Math::AlignPowerOfTwo(100u) == 128u);
+
+static_assert(Math::AlignUp(13u, 8) == 16u);
+static_assert(Math::AlignUp(16u, 8) == 16u);
+static_assert(Math::AlignDown(13u, 8) == 8u);
+static_assert(Math::IsAligned(256u, 256));
+static_assert(!Math::IsAligned(257u, 256));
+static_assert(Math::DivideByMultiple(65u, 64) == 2u);
+static_assert(Math::IsPowerOfTwo(64u) && !Math::IsPowerOfTwo(65u));
+
+TEST_CASE("Bit utilities give the same results at run time as at compile time")
+{
+	for (uint32_t bit = 0; bit < 64; ++bit)
+	{
+		volatile uint64_t const value = uint64_t(1) << bit;
+		CHECK(Math::CountTrailingZeros(value) == bit);
+		CHECK(Math::CountLeadingZeros(value) == 63 - bit);
+		CHECK(Math::PopCount(value) == 1);
+		CHECK(Math::PopCount(value - 1) == bit);
+		CHECK(Math::Log2Floor(value) == bit);
+		CHECK(Math::Log2(value) == bit);
+		if (bit > 1)
+			CHECK(Math::NextPowerOfTwo(value - 1) == value);
+	}
+
+	volatile uint64_t const zero = 0;
+	CHECK(Math::CountTrailingZeros(zero) == 64);
+	CHECK(Math::CountLeadingZeros(zero) == 64);
+	CHECK(Math::AlignPowerOfTwo(uint64_t(zero)) == 0);
+}
@@ -0,0 +1,116 @@
+#include "doctest/doctest.h"
+
+#include "realsim/graphics/FencedObjectPool.h"
+#include "realsim/graphics/NullDevice.h"
+
+#include <chrono>
+#include <thread>
+
+using namespace RSim;
+
+TEST_CASE("Null fences only move forward")
+{
+	Graphics::NullFence fence(5);
+	CHECK(fence.GetCompletedValue() == 5);
+	fence.Signal(8);
+	CHECK(fence.GetCompletedValue() == 8);
+	fence.Signal(3);
+	CHECK(fence.GetCompletedValue() == 8);
+	fence.WaitForValue(8);
+}
+
+TEST_CASE("Null queues signal their fences after the submitted work")
+{
+	Graphics::NullDeviceDesc desc{};
+	desc.FenceCompletionLatency = std::chrono::milliseconds(20);
+	Graphics::NullDevice device(desc);
+	auto const queue = device.CreateCommandQueue(Graphics::NullCommandListType::Direct);
+	auto const fence = device.CreateFence(0);
+	auto const allocator = device.CreateCommandAllocator(Graphics::NullCommandListType::Direct);
+	auto const list = device.CreateCommandList(Graphics::NullCommandListType::Direct, allocator.get());
+
+	list->RecordCommands(3);
+	list->Close();
+	Graphics::NullCommandList* const lists[] = { list.get() };
+
+	auto const start = std::chrono::steady_clock::now();
+	queue->ExecuteCommandLists(1, lists);
+	queue->Signal(fence.get(), 1);
+	fence->WaitForValue(1);
+
+	CHECK(std::chrono::steady_clock::now() - start >= desc.FenceCompletionLatency);
+	CHECK(fence->GetCompletedValue() == 1);
+	CHECK(queue->GetNumExecuteCalls() == 1);
+	CHECK(queue->GetNumExecutedCommandLists() == 1);
+	CHECK(queue->GetNumSignals() == 1);
+	CHECK(allocator->GetNumRecordedCommands() == 3);
+}
+
+TEST_CASE("A null queue waiting on another queue's fence does not run ahead of it")
+{
+	Graphics::NullDevice device;
+	auto const producer = device.CreateFence(0);
+	auto const consumer = device.CreateFence(0);
+	auto const queue = device.CreateCommandQueue(Graphics::NullCommandListType::Compute);
+
+	queue->Wait(producer.get(), 1);
+	queue->Signal(consumer.get(), 1);
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	CHECK(consumer->GetCompletedValue() == 0);
+
+	producer->Signal(1);
+	consumer->WaitForValue(1);
+	CHECK(consumer->GetCompletedValue() == 1);
+}
+
+TEST_CASE("Fenced objects are handed out in order once their fence has completed")
+{
+	Graphics::FencedObjectPool<int> pool;
+	CHECK(pool.IsEmpty());
+	pool.Discard(1, 10);
+	pool.Discard(2, 20);
+	pool.Discard(4, 40);
+	CHECK(pool.GetNumPendingObjects() == 3);
+
+	CHECK(!pool.TryAcquire(0).has_value());
+	CHECK(pool.GetNumCompletedObjects(2) == 2);
+	CHECK(pool.GetNumCompletedObjects(3) == 2);
+
+	auto const first = pool.TryAcquire(3);
+	REQUIRE(first.has_value());
+	CHECK(*first == 10);
+	CHECK(pool.TryAcquire(3).value_or(0) == 20);
+	CHECK(!pool.TryAcquire(3).has_value());
+	CHECK(pool.TryAcquire(4).value_or(0) == 40);
+	CHECK(pool.IsEmpty());
+}
+
+TEST_CASE("Command allocators are recycled through the pool once the GPU is done with them")
+{
+	Graphics::NullDevice device;
+	Graphics::NullCommandAllocatorPool pool(&device, Graphics::NullCommandListType::Direct);
+
+	auto const first = pool.RequestCommandAllocator(0);
+	auto const second = pool.RequestCommandAllocator(0);
+	CHECK(first != second);
+	CHECK(pool.Size() == 2);
+
+	pool.DiscardAllocator(1, first);
+	pool.DiscardAllocator(2, second);
+
+	// Only the first allocator's fence has completed, so it is reused and reset, the pool does not grow.
+	auto const reused = pool.RequestCommandAllocator(1);
+	CHECK(reused == first);
+	CHECK(reused->GetNumResets() == 1);
+	CHECK(pool.Size() == 2);
+
+	// Nothing else is complete, a new allocator is created.
+	auto const third = pool.RequestCommandAllocator(1);
+	CHECK(third != second);
+	CHECK(pool.Size() == 3);
+
+	pool.DiscardAllocator(3, reused);
+	pool.DiscardAllocator(3, third);
+	CHECK(pool.ReleaseIdleAllocators(3, 1) == 2);
+	CHECK(pool.Size() == 1);
+}
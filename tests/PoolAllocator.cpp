@@ -0,0 +1,131 @@
+#include "doctest/doctest.h"
+
+#include "realsim/graphics/PoolAllocator.h"
+
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace RSim;
+
+TEST_CASE("Freed pool blocks are reused before the pool grows")
+{
+	Graphics::PoolAllocator pool(256, 4);
+	std::vector<Graphics::PoolAllocator::Allocation> blocks;
+	for (int i = 0; i < 4; ++i)
+	{
+		blocks.push_back(pool.Allocate());
+	}
+	CHECK(pool.GetNumSlabs() == 1);
+	CHECK(pool.GetNumAllocatedBlocks() == 4);
+
+	std::size_t const freedOffset = blocks[2].Offset;
+	pool.Free(blocks[2]);
+	CHECK(!blocks[2].IsValid());
+
+	blocks[2] = pool.Allocate();
+	CHECK(blocks[2].Offset == freedOffset);
+	CHECK(pool.GetNumSlabs() == 1);
+
+	// A full pool grows by a slab whose offsets follow the first one.
+	auto const next = pool.Allocate();
+	CHECK(pool.GetNumSlabs() == 2);
+	CHECK(pool.GetSlabIndex(next.Offset) == 1);
+	CHECK(pool.GetOffsetInSlab(next.Offset) == 0);
+
+	for (auto& block : blocks)
+	{
+		pool.Free(block);
+	}
+	pool.Free(next.Offset);
+	CHECK(pool.IsEmpty());
+}
+
+TEST_CASE("A pool at its maximum number of slabs fails to allocate once full")
+{
+	Graphics::PoolAllocator pool(64, 3, 2);
+	std::vector<Graphics::PoolAllocator::Allocation> blocks;
+	for (int i = 0; i < 6; ++i)
+	{
+		blocks.push_back(pool.Allocate());
+		REQUIRE(blocks.back().IsValid());
+	}
+	CHECK(!pool.Allocate().IsValid());
+	CHECK(pool.GetNumSlabs() == 2);
+
+	pool.Free(blocks[4]);
+	blocks[4] = pool.Allocate();
+	CHECK(blocks[4].IsValid());
+
+	for (auto& block : blocks)
+	{
+		pool.Free(block);
+	}
+	CHECK(pool.IsEmpty());
+}
+
+TEST_CASE("Pool blocks are aligned to the block size and unique, also past the first mask word")
+{
+	// 100 blocks per slab need two mask words, the second one only partially used.
+	Graphics::PoolAllocator pool(256, 100);
+	std::set<std::size_t> offsets;
+	std::vector<Graphics::PoolAllocator::Allocation> blocks;
+	for (int i = 0; i < 250; ++i)
+	{
+		auto const block = pool.Allocate();
+		REQUIRE(block.IsValid());
+		CHECK(block.Size == 256);
+		CHECK(block.Offset % 256 == 0);
+		CHECK(pool.GetOffsetInSlab(block.Offset) < pool.GetSlabSize());
+		offsets.insert(block.Offset);
+		blocks.push_back(block);
+	}
+	CHECK(offsets.size() == 250);
+	CHECK(pool.GetNumSlabs() == 3);
+
+	for (auto& block : blocks)
+	{
+		pool.Free(block);
+	}
+	CHECK(pool.IsEmpty());
+}
+
+TEST_CASE("Moving a pool moves its allocations")
+{
+	Graphics::PoolAllocator pool(128, 8);
+	auto block = pool.Allocate();
+
+	Graphics::PoolAllocator moved(std::move(pool));
+	CHECK(pool.GetNumAllocatedBlocks() == 0);
+	CHECK(moved.GetNumAllocatedBlocks() == 1);
+
+	Graphics::PoolAllocator assigned(128, 8);
+	assigned = std::move(moved);
+	CHECK(moved.GetNumAllocatedBlocks() == 0);
+	CHECK(assigned.GetNumAllocatedBlocks() == 1);
+
+	assigned.Free(block);
+	CHECK(assigned.IsEmpty());
+}
+
+TEST_CASE("GPU pool blocks are reused only once their fence has completed")
+{
+	Graphics::PoolGPUAllocator pool(256, 2, 1);
+	auto first = pool.Allocate();
+	auto second = pool.Allocate();
+	std::size_t const firstOffset = first.Offset;
+
+	pool.Free(first, 3);
+	pool.Free(second, 4);
+	CHECK(pool.GetNumStaleAllocations() == 2);
+	CHECK(!pool.Allocate().IsValid());
+
+	pool.ReleaseStaleAllocations(3);
+	CHECK(pool.GetNumStaleAllocations() == 1);
+	auto third = pool.Allocate();
+	CHECK(third.Offset == firstOffset);
+
+	pool.Free(third, 5);
+	pool.ReleaseStaleAllocations(5);
+	CHECK(pool.IsEmpty());
+}
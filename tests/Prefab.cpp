@@ -0,0 +1,217 @@
+#include "doctest/doctest.h"
+
+#include "realsim/ecs/Entity.h"
+#include "realsim/ecs/Link.h"
+#include "realsim/ecs/Prefab.h"
+#include "realsim/ecs/Scene.h"
+
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+
+using namespace RSim;
+
+namespace
+{
+	constexpr std::size_t NumRobots = 50'000;
+
+	ECS::Prefab MakeRobot()
+	{
+		ECS::Prefab robot;
+		uint32_t const body = robot.AddEntity("Robot");
+		uint32_t const arm = robot.AddEntity("Arm", ECS::TransformComponent{ { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 0.0f, 1.0f }, { 1.0f, 1.0f, 1.0f } }, body);
+		robot.AddEntity("Gripper", ECS::TransformComponent{ { 0.0f, 0.5f, 0.0f }, { 0.0f, 0.0f, 0.0f, 1.0f }, { 1.0f, 1.0f, 1.0f } }, arm);
+		robot.AddEntity("LeftWheel", {}, body);
+		robot.AddEntity("RightWheel", {}, body);
+		robot.AddComponent(arm, ECS::BoxComponent{ { 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f, 1.0f }, 0.0f });
+		return robot;
+	}
+
+	/**
+	 * \brief Checks that the two subtrees have the same shape and names, and that every link of one refers to the entity at the same
+	 * place in the other.
+	 */
+	void CheckSameSubtree(ECS::Scene& Lhs, entt::entity LhsRoot, ECS::Scene& Rhs, entt::entity RhsRoot)
+	{
+		std::unordered_map<entt::entity, entt::entity> lhsToRhs;
+		std::vector<std::pair<entt::entity, entt::entity>> queue{ { LhsRoot, RhsRoot } };
+		for (std::size_t head = 0; head < queue.size(); ++head)
+		{
+			auto const [lhs, rhs] = queue[head];
+			lhsToRhs.emplace(lhs, rhs);
+			ECS::Link const& lhsLink = Lhs.GetComponent<ECS::Link>(lhs);
+			ECS::Link const& rhsLink = Rhs.GetComponent<ECS::Link>(rhs);
+			REQUIRE(lhsLink.GetNumChildren() == rhsLink.GetNumChildren());
+			for (entt::entity lhsChild = lhsLink.GetFirstChild(), rhsChild = rhsLink.GetFirstChild(); lhsChild != entt::null;
+				lhsChild = Lhs.GetComponent<ECS::Link>(lhsChild).GetNextSibling(), rhsChild = Rhs.GetComponent<ECS::Link>(rhsChild).GetNextSibling())
+			{
+				REQUIRE(rhsChild != entt::null);
+				queue.emplace_back(lhsChild, rhsChild);
+			}
+		}
+
+		bool same = true;
+		for (auto const& [lhs, rhs] : queue)
+		{
+			ECS::Link const& lhsLink = Lhs.GetComponent<ECS::Link>(lhs);
+			ECS::Link const& rhsLink = Rhs.GetComponent<ECS::Link>(rhs);
+			// Links out of the subtree, the roots' parent and siblings, only have to agree on being null
+			auto const maps = [&](entt::entity LhsEntity, entt::entity RhsEntity)
+			{
+				auto const it = lhsToRhs.find(LhsEntity);
+				return it != lhsToRhs.end() ? it->second == RhsEntity : (RhsEntity == entt::null) == (LhsEntity == entt::null);
+			};
+			same = same && Lhs.GetComponent<ECS::NameComponent>(lhs).Name == Rhs.GetComponent<ECS::NameComponent>(rhs).Name &&
+				maps(lhsLink.GetFirstChild(), rhsLink.GetFirstChild()) && maps(lhsLink.GetLastChild(), rhsLink.GetLastChild()) &&
+				maps(lhsLink.GetPreviousSibling(), rhsLink.GetPreviousSibling()) && maps(lhsLink.GetNextSibling(), rhsLink.GetNextSibling()) &&
+				maps(lhsLink.GetParent(), rhsLink.GetParent()) && lhsLink.GetChildIndex() == rhsLink.GetChildIndex();
+		}
+		CHECK(same);
+	}
+}
+
+TEST_CASE("Prefab copies have the template's hierarchy, names and components")
+{
+	ECS::Scene scene;
+	ECS::Entity world = scene.CreateEntity();
+	world.AddChild(scene.CreateEntity());
+	world.EnableChildArray();
+
+	ECS::Prefab const robot = MakeRobot();
+	std::vector<entt::entity> entities;
+	robot.Instantiate(scene, 3, entities, world);
+	REQUIRE(entities.size() == 3 * robot.GetNumEntities());
+
+	CHECK(world.GetLink().GetNumChildren() == 4);
+	CHECK(world.GetChildAt(3) == ECS::Entity{ &scene, entities[2] });
+	CHECK(ECS::Entity{ &scene, entities[0] }.GetPreviousSibling() == world.GetChildAt(0));
+
+	for (std::size_t copy = 0; copy < 3; ++copy)
+	{
+		ECS::Entity root{ &scene, entities[copy] };
+		CHECK(root.GetParent() == world);
+		CHECK(root.GetLink().GetChildIndex() == copy + 1);
+		CHECK(root.GetName().Name == "Robot");
+		CHECK(root.GetLink().GetNumChildren() == 3);
+
+		ECS::Entity gripper = root.FindByPath("Arm/Gripper");
+		REQUIRE_FALSE(gripper.IsNull());
+		CHECK(gripper == ECS::Entity{ &scene, entities[2 * 3 + copy] });
+		CHECK(gripper.GetParent().GetComponent<ECS::BoxComponent>().Color.x == 1.0f);
+		CHECK(root.GetChildByName("RightWheel").GetPreviousSibling().GetName().Name == "LeftWheel");
+	}
+
+	scene.Update(0.0f);
+	ECS::Entity gripper{ &scene, entities[2 * 3] };
+	CHECK(gripper.GetComponent<ECS::WorldTransformComponent>().World._42 == 1.5f);
+}
+
+TEST_CASE("A prefab made from a subtree copies it")
+{
+	ECS::Scene scene;
+	ECS::Entity source = scene.CreateEntity();
+	source.SetName("Tree");
+	ECS::Entity branch = scene.CreateEntity();
+	branch.SetName("Branch");
+	branch.AddComponent<ECS::BoxComponent>().Rotation = 2.0f;
+	source.AddChild(branch);
+	source.EnableChildArray();
+
+	ECS::Prefab const tree = ECS::Prefab::FromSubtree(scene, source);
+	CHECK(tree.GetNumEntities() == 2);
+
+	scene.EnableNameIndex();
+	std::vector<entt::entity> entities;
+	tree.Instantiate(scene, 2, entities);
+	for (std::size_t copy = 0; copy < 2; ++copy)
+	{
+		ECS::Entity root{ &scene, entities[copy] };
+		CHECK(root.GetParent().IsNull());
+		CHECK(root.GetPreviousSibling().IsNull());
+		CHECK(root.GetNextSibling().IsNull());
+		CHECK(root.HasChildArray());
+		ECS::Entity copiedBranch = root.GetChildByName("Branch");
+		REQUIRE_FALSE(copiedBranch.IsNull());
+		CHECK(copiedBranch.GetComponent<ECS::BoxComponent>().Rotation == 2.0f);
+	}
+}
+
+TEST_CASE("Instantiating robots from a prefab is faster than creating them entity by entity")
+{
+	ECS::Prefab const robot = MakeRobot();
+
+	ECS::Scene perEntity;
+	std::vector<entt::entity> bodies;
+	bodies.reserve(NumRobots);
+	auto start = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < NumRobots; ++i)
+	{
+		ECS::Entity body = perEntity.CreateEntity();
+		bodies.push_back(body);
+		body.SetName("Robot");
+		ECS::Entity arm = perEntity.CreateEntity();
+		arm.SetName("Arm");
+		arm.AddComponent<ECS::BoxComponent>();
+		body.AddChild(arm);
+		ECS::Entity gripper = perEntity.CreateEntity();
+		gripper.SetName("Gripper");
+		arm.AddChild(gripper);
+		for (char const* wheel : { "LeftWheel", "RightWheel" })
+		{
+			ECS::Entity entity = perEntity.CreateEntity();
+			entity.SetName(wheel);
+			body.AddChild(entity);
+		}
+	}
+	auto const perEntityMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	ECS::Scene instanced;
+	std::vector<entt::entity> entities;
+	start = std::chrono::steady_clock::now();
+	robot.Instantiate(instanced, NumRobots, entities);
+	auto const instancedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	MESSAGE(NumRobots << " robots: " << perEntityMs << " ms entity by entity, " << instancedMs << " ms from the prefab");
+	CHECK(instanced.GetEnTTRegistry().alive() == perEntity.GetEnTTRegistry().alive());
+
+	// Both ways build the same robots
+	for (std::size_t i = 0; i < NumRobots; ++i)
+	{
+		CheckSameSubtree(perEntity, bodies[i], instanced, entities[i]);
+	}
+}
+
+TEST_CASE("Copies instantiated without a parent are independent roots")
+{
+	ECS::Scene scene;
+	ECS::Prefab const robot = MakeRobot();
+	std::vector<entt::entity> entities;
+	robot.Instantiate(scene, 3, entities);
+
+	auto const checkRoot = [&](entt::entity Root)
+	{
+		ECS::Entity root{ &scene, Root };
+		CHECK(root.GetParent().IsNull());
+		CHECK(root.GetPreviousSibling().IsNull());
+		CHECK(root.GetNextSibling().IsNull());
+		CHECK(root.GetLink().GetNumChildren() == 3);
+	};
+	for (std::size_t copy = 0; copy < 3; ++copy)
+	{
+		checkRoot(entities[copy]);
+	}
+
+	// Destroying one copy leaves the others untouched
+	CHECK(scene.DestroySubtree(ECS::Entity{ &scene, entities[1] }) == robot.GetNumEntities());
+	checkRoot(entities[0]);
+	checkRoot(entities[2]);
+
+	// Re-parenting one copy does not drag another along
+	ECS::Entity holder = scene.CreateEntity();
+	holder.AddChild(ECS::Entity{ &scene, entities[0] });
+	CHECK(holder.GetLink().GetNumChildren() == 1);
+	CHECK(ECS::Entity{ &scene, entities[0] }.GetParent() == holder);
+	CHECK(ECS::Entity{ &scene, entities[0] }.GetNextSibling().IsNull());
+	checkRoot(entities[2]);
+	CHECK(ECS::Entity{ &scene, entities[2] }.FindByPath("Arm/Gripper").GetName().Name == "Gripper");
+}
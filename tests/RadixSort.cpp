@@ -0,0 +1,109 @@
+#include "doctest/doctest.h"
+
+#include "realsim/core/RadixSort.h"
+#include "realsim/core/ThreadPool.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace RSim;
+
+namespace
+{
+	/**
+	 * \brief Entries with random keys restricted to KeyMask, the values are the original positions.
+	 */
+	std::vector<Core::RadixSortEntry> RandomEntries(std::size_t Count, uint64_t KeyMask, uint64_t KeyBase, uint32_t Seed)
+	{
+		std::mt19937_64 random(Seed);
+		std::vector<Core::RadixSortEntry> entries(Count);
+		for (std::size_t i = 0; i < Count; ++i)
+		{
+			entries[i] = Core::RadixSortEntry{ KeyBase | (random() & KeyMask), (uint32_t)i };
+		}
+		return entries;
+	}
+
+	/**
+	 * \brief Radix sorts the entries and checks keys and values against std::stable_sort, which also checks the sort is stable.
+	 */
+	void CheckAgainstStableSort(Core::ThreadPool* pPool, std::vector<Core::RadixSortEntry> Entries)
+	{
+		std::vector<Core::RadixSortEntry> expected = Entries;
+		std::stable_sort(expected.begin(), expected.end(), [](Core::RadixSortEntry const& lhs, Core::RadixSortEntry const& rhs)
+		{
+			return lhs.Key < rhs.Key;
+		});
+
+		std::vector<Core::RadixSortEntry> scratch(Entries.size());
+		Core::RadixSort(pPool, Entries.data(), scratch.data(), Entries.size());
+
+		bool matches = true;
+		for (std::size_t i = 0; i < Entries.size(); ++i)
+		{
+			matches = matches && Entries[i].Key == expected[i].Key && Entries[i].Value == expected[i].Value;
+		}
+		CHECK(matches);
+	}
+}
+
+TEST_CASE("Radix sort keeps entries with equal keys in their original order")
+{
+	// Only 16 distinct keys over 1000 entries, spread over the high and the low byte.
+	CheckAgainstStableSort(nullptr, RandomEntries(1000, 0xC000'0000'0000'0003ull, 0, 1));
+
+	std::vector<Core::RadixSortEntry> entries = { { 3, 0 }, { 1, 1 }, { 3, 2 }, { 1, 3 }, { 2, 4 } };
+	std::vector<Core::RadixSortEntry> scratch(entries.size());
+	Core::RadixSort(nullptr, entries.data(), scratch.data(), entries.size());
+	std::vector<uint32_t> values;
+	for (auto const& entry : entries)
+	{
+		values.push_back(entry.Value);
+	}
+	std::vector<uint32_t> const expectedValues = { 1, 3, 4, 0, 2 };
+	CHECK(values == expectedValues);
+}
+
+TEST_CASE("Radix sort skips bytes that are the same in every key")
+{
+	// Bytes 0, 3 and 6 vary, the odd number of passes leaves the result in the scratch buffer before it is copied back.
+	CheckAgainstStableSort(nullptr, RandomEntries(5000, 0x00FF'0000'FF00'00FFull, 0x1200'3400'0056'7800ull, 2));
+	// A single varying byte that is not the lowest one.
+	CheckAgainstStableSort(nullptr, RandomEntries(5000, 0x0000'FF00'0000'0000ull, 0xAB00'0000'0000'0000ull, 3));
+
+	// Every key equal, no pass runs and nothing moves.
+	std::vector<Core::RadixSortEntry> entries(100, Core::RadixSortEntry{ 0x0123'4567'89AB'CDEFull, 0 });
+	for (std::size_t i = 0; i < entries.size(); ++i)
+	{
+		entries[i].Value = (uint32_t)i;
+	}
+	std::vector<Core::RadixSortEntry> scratch(entries.size());
+	Core::RadixSort(nullptr, entries.data(), scratch.data(), entries.size());
+	bool unchanged = true;
+	for (std::size_t i = 0; i < entries.size(); ++i)
+	{
+		unchanged = unchanged && entries[i].Value == (uint32_t)i;
+	}
+	CHECK(unchanged);
+
+	// Nothing to sort.
+	Core::RadixSort(nullptr, nullptr, nullptr, 0);
+	Core::RadixSortEntry single{ 42, 7 };
+	Core::RadixSortEntry singleScratch{};
+	Core::RadixSort(nullptr, &single, &singleScratch, 1);
+	CHECK(single.Key == 42);
+	CHECK(single.Value == 7);
+}
+
+TEST_CASE("The parallel radix sort matches std::stable_sort")
+{
+	Core::ThreadPool pool(3);
+	// Enough entries for every thread to get a task, with duplicate keys so that stability across tasks is checked too.
+	CheckAgainstStableSort(&pool, RandomEntries(200000, 0xFFFF'0000'0000'0FFFull, 0, 4));
+	CheckAgainstStableSort(&pool, RandomEntries(200000, ~0ull, 0, 5));
+	// Two tasks' worth, fewer tasks than threads.
+	CheckAgainstStableSort(&pool, RandomEntries(40000, 0x0000'00FF'00FF'0000ull, 0, 6));
+}
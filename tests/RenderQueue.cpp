@@ -0,0 +1,114 @@
+#include "doctest/doctest.h"
+
+#include "realsim/core/ThreadPool.h"
+#include "realsim/graphics/RenderQueue.h"
+
+#include <cstddef>
+#include <vector>
+
+using namespace RSim;
+
+namespace
+{
+	Graphics::DrawPacket Packet(uint32_t PipelineID, uint32_t MaterialID, uint32_t MeshID, uint32_t FirstInstance)
+	{
+		Graphics::DrawPacket packet{};
+		packet.PipelineID = PipelineID;
+		packet.MaterialID = MaterialID;
+		packet.MeshID = MeshID;
+		packet.FirstInstance = FirstInstance;
+		return packet;
+	}
+
+	/**
+	 * \brief The FirstInstance of every packet in sort order, the tests use it to tell the packets apart.
+	 */
+	std::vector<uint32_t> SortedOrder(Graphics::RenderQueue const& Queue)
+	{
+		std::vector<uint32_t> order;
+		for (std::size_t i = 0; i < Queue.GetNumPackets(); ++i)
+		{
+			order.push_back(Queue.GetSortedPacket(i).FirstInstance);
+		}
+		return order;
+	}
+}
+
+TEST_CASE("Opaque packets are sorted by state and then front-to-back, transparent ones back-to-front after them")
+{
+	Graphics::RenderQueue queue;
+	queue.Submit(Graphics::RenderPass::Transparent, Packet(0, 0, 0, 0), 0.2f);
+	queue.Submit(Graphics::RenderPass::Opaque, Packet(1, 0, 0, 1), 0.1f);
+	queue.Submit(Graphics::RenderPass::Opaque, Packet(0, 0, 0, 2), 0.9f);
+	queue.Submit(Graphics::RenderPass::Transparent, Packet(1, 0, 0, 3), 0.8f);
+	queue.Submit(Graphics::RenderPass::Opaque, Packet(0, 0, 0, 4), 0.3f);
+	queue.Submit(Graphics::RenderPass::Opaque, Packet(0, 1, 0, 5), 0.0f);
+	queue.Submit(Graphics::RenderPass::Transparent, Packet(0, 0, 0, 6), 0.5f);
+	queue.Sort(nullptr);
+
+	// Opaque: pipeline 0 material 0 front-to-back (4, 2), pipeline 0 material 1 (5), pipeline 1 (1).
+	// Transparent: back-to-front regardless of state (3, 6, 0).
+	std::vector<uint32_t> const expected = { 4, 2, 5, 1, 3, 6, 0 };
+	CHECK(SortedOrder(queue) == expected);
+	for (std::size_t i = 1; i < queue.GetNumPackets(); ++i)
+	{
+		CHECK(queue.GetSortedKey(i - 1) <= queue.GetSortedKey(i));
+	}
+}
+
+TEST_CASE("Sort keys clamp the depth and order the fields as documented")
+{
+	using Graphics::RenderQueue;
+	auto const packet = Packet(5, 7, 9, 0);
+
+	CHECK(RenderQueue::MakeSortKey(Graphics::RenderPass::Opaque, packet, -1.0f) == RenderQueue::MakeSortKey(Graphics::RenderPass::Opaque, packet, 0.0f));
+	CHECK(RenderQueue::MakeSortKey(Graphics::RenderPass::Opaque, packet, 2.0f) == RenderQueue::MakeSortKey(Graphics::RenderPass::Opaque, packet, 1.0f));
+
+	// Opaque keys only differ in their low depth bits when just the depth changes.
+	uint64_t const opaqueNear = RenderQueue::MakeSortKey(Graphics::RenderPass::Opaque, packet, 0.0f);
+	uint64_t const opaqueFar = RenderQueue::MakeSortKey(Graphics::RenderPass::Opaque, packet, 1.0f);
+	CHECK(opaqueNear < opaqueFar);
+	CHECK((opaqueNear ^ opaqueFar) >> RenderQueue::DepthBits == 0);
+
+	// Any transparent packet sorts after any opaque one, and a nearer one after a farther one.
+	uint64_t const transparentNear = RenderQueue::MakeSortKey(Graphics::RenderPass::Transparent, Packet(0, 0, 0, 0), 0.0f);
+	uint64_t const transparentFar = RenderQueue::MakeSortKey(Graphics::RenderPass::Transparent, packet, 1.0f);
+	CHECK(opaqueFar < transparentFar);
+	CHECK(transparentFar < transparentNear);
+
+	// The largest IDs that fit fill their fields without touching the pass.
+	Graphics::DrawPacket widest{};
+	widest.PipelineID = (1u << RenderQueue::PipelineBits) - 1;
+	widest.RootSignatureID = (1u << RenderQueue::RootSignatureBits) - 1;
+	widest.MaterialID = (1u << RenderQueue::MaterialBits) - 1;
+	widest.MeshID = (1u << RenderQueue::MeshBits) - 1;
+	uint64_t const widestKey = RenderQueue::MakeSortKey(Graphics::RenderPass::Opaque, widest, 0.0f);
+	CHECK(widestKey >> (64 - RenderQueue::PassBits) == (uint64_t)Graphics::RenderPass::Opaque);
+	CHECK(widestKey == (~uint64_t{ 0 } >> RenderQueue::PassBits & ~((uint64_t{ 1 } << RenderQueue::DepthBits) - 1)));
+}
+
+TEST_CASE("Packets with equal keys keep their submission order, also when sorted in parallel")
+{
+	Core::ThreadPool pool(3);
+	Graphics::RenderQueue queue;
+	constexpr uint32_t NumPackets = 100000;
+	for (uint32_t i = 0; i < NumPackets; ++i)
+	{
+		queue.Submit(Graphics::RenderPass::Opaque, Packet(i % 3, 0, 0, i), 0.5f);
+	}
+	queue.Sort(&pool);
+
+	REQUIRE(queue.GetNumPackets() == NumPackets);
+	bool ordered = true;
+	for (std::size_t i = 1; i < NumPackets; ++i)
+	{
+		auto const& previous = queue.GetSortedPacket(i - 1);
+		auto const& current = queue.GetSortedPacket(i);
+		ordered = ordered && (previous.PipelineID < current.PipelineID ||
+			(previous.PipelineID == current.PipelineID && previous.FirstInstance < current.FirstInstance));
+	}
+	CHECK(ordered);
+
+	queue.Clear();
+	CHECK(queue.GetNumPackets() == 0);
+}
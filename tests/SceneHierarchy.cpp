@@ -0,0 +1,410 @@
+#include "doctest/doctest.h"
+
+#include "realsim/ecs/Scene.h"
+#include "realsim/ecs/Entity.h"
+#include "realsim/ecs/Link.h"
+#include "realsim/ecs/SceneHistory.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace RSim;
+
+namespace
+{
+	constexpr std::size_t NumEntities = 100'000;
+
+	/**
+	 * \brief Builds a tree of Count entities under Root where every entity has up to Fanout children, filled breadth-first.
+	 */
+	std::vector<ECS::Entity> BuildTree(ECS::Scene& Scene, ECS::Entity Root, std::size_t Count, std::size_t Fanout)
+	{
+		std::vector<ECS::Entity> entities{ Root };
+		entities.reserve(Count);
+		for (std::size_t i = 1; i < Count; ++i)
+		{
+			ECS::Entity child = Scene.CreateEntity();
+			entities[(i - 1) / Fanout].AddChild(child);
+			entities.push_back(child);
+		}
+		return entities;
+	}
+
+	/**
+	 * \brief Checks the parent's children are Expected in this order, through the sibling links in both directions, GetChildAt(), the
+	 * child indices that GetChildAt() renumbers and the ChildArray if the parent has one.
+	 */
+	void CheckChildren(ECS::Entity Parent, std::vector<ECS::Entity> const& Expected)
+	{
+		entt::entity const none = entt::null;
+		ECS::Link const& parentLink = Parent.GetLink();
+		REQUIRE(parentLink.GetNumChildren() == Expected.size());
+		CHECK(parentLink.GetFirstChild() == (Expected.empty() ? none : (entt::entity)Expected.front()));
+		CHECK(parentLink.GetLastChild() == (Expected.empty() ? none : (entt::entity)Expected.back()));
+
+		for (std::size_t i = 0; i < Expected.size(); ++i)
+		{
+			ECS::Link const& link = Expected[i].GetLink();
+			CHECK(link.GetParent() == (entt::entity)Parent);
+			CHECK(link.GetPreviousSibling() == (i > 0 ? (entt::entity)Expected[i - 1] : none));
+			CHECK(link.GetNextSibling() == (i + 1 < Expected.size() ? (entt::entity)Expected[i + 1] : none));
+			CHECK(Parent.GetChildAt(i) == Expected[i]);
+		}
+		CHECK_FALSE(parentLink.HasStaleChildIndices());
+		for (std::size_t i = 0; i < Expected.size(); ++i)
+			CHECK(Expected[i].GetLink().GetChildIndex() == i);
+
+		if (Parent.HasChildArray())
+		{
+			std::vector<entt::entity> expectedArray;
+			for (ECS::Entity const& child : Expected)
+				expectedArray.push_back(child);
+			CHECK(Parent.GetComponent<ECS::ChildArray>().GetChildren() == expectedArray);
+		}
+	}
+
+	double TimeDestroySubtree(ECS::Scene& Scene, ECS::Entity Root, std::size_t& NumDestroyed)
+	{
+		auto const start = std::chrono::steady_clock::now();
+		NumDestroyed = Scene.DestroySubtree(Root);
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+TEST_CASE("DestroySubtree destroys a wide hierarchy and detaches it from its parent")
+{
+	ECS::Scene scene;
+	ECS::Entity parent = scene.CreateEntity();
+	ECS::Entity sibling = scene.CreateEntity();
+	ECS::Entity root = scene.CreateEntity();
+	parent.AddChild(sibling);
+	parent.AddChild(root);
+
+	std::vector<ECS::Entity> const tree = BuildTree(scene, root, NumEntities, 8);
+
+	std::size_t numDestroyed = 0;
+	double const elapsed = TimeDestroySubtree(scene, root, numDestroyed);
+	MESSAGE("Destroyed a " << NumEntities << "-entity hierarchy with fanout 8 in " << elapsed << " ms");
+
+	CHECK(numDestroyed == NumEntities);
+	CHECK(scene.GetEnTTRegistry().alive() == 2);
+	for (ECS::Entity const entity : tree)
+		REQUIRE_FALSE(scene.GetEnTTRegistry().valid(entity));
+
+	ECS::Link const& parentLink = scene.GetComponent<ECS::Link>(parent);
+	CHECK(parentLink.GetNumChildren() == 1);
+	CHECK(parentLink.GetFirstChild() == (entt::entity)sibling);
+	CHECK(parentLink.GetLastChild() == (entt::entity)sibling);
+}
+
+TEST_CASE("DestroySubtree handles a deep hierarchy without recursing")
+{
+	ECS::Scene scene;
+	ECS::Entity root = scene.CreateEntity();
+	BuildTree(scene, root, NumEntities, 1);
+
+	std::size_t numDestroyed = 0;
+	double const elapsed = TimeDestroySubtree(scene, root, numDestroyed);
+	MESSAGE("Destroyed a " << NumEntities << "-entity chain in " << elapsed << " ms");
+
+	CHECK(numDestroyed == NumEntities);
+	CHECK(scene.GetEnTTRegistry().alive() == 0);
+}
+
+TEST_CASE("Destroying an entity through the registry takes its descendants with it")
+{
+	ECS::Scene scene;
+	ECS::Entity parent = scene.CreateEntity();
+	ECS::Entity root = scene.CreateEntity();
+	parent.AddChild(root);
+	BuildTree(scene, root, 1000, 4);
+
+	scene.GetEnTTRegistry().destroy(root);
+
+	CHECK(scene.GetEnTTRegistry().alive() == 1);
+	CHECK(scene.GetComponent<ECS::Link>(parent).GetNumChildren() == 0);
+	CHECK(scene.GetComponent<ECS::Link>(parent).GetFirstChild() == entt::null);
+}
+
+TEST_CASE("Names are interned and entities can be found by path with and without the name index")
+{
+	ECS::Scene scene;
+	ECS::Entity robot = scene.CreateEntity();
+	ECS::Entity arm = scene.CreateEntity();
+	ECS::Entity gripper = scene.CreateEntity();
+	ECS::Entity other = scene.CreateEntity();
+	robot.SetName("Robot");
+	arm.SetName("Arm");
+	gripper.SetName("Gripper");
+	other.SetName("Arm");
+	robot.AddChild(arm);
+	arm.AddChild(gripper);
+
+	CHECK(arm.GetName().ID == other.GetName().ID);
+	CHECK(arm.GetName().Name == "Arm");
+
+	for (bool const indexed : { false, true })
+	{
+		if (indexed)
+			scene.EnableNameIndex();
+
+		CHECK(scene.FindByPath("Robot/Arm/Gripper") == gripper);
+		CHECK(scene.FindByPath("/Robot//Arm/") == arm);
+		CHECK(robot.FindByPath("Arm/Gripper") == gripper);
+		CHECK(scene.FindByPath("Robot/Gripper").IsNull());
+		CHECK(scene.FindByPath("Robot/Leg").IsNull());
+		CHECK(robot.GetChildByName("Arm") == arm);
+	}
+
+	// The index follows renames, re-parenting and destruction
+	gripper.SetName("Claw");
+	CHECK(scene.FindByPath("Robot/Arm/Gripper").IsNull());
+	CHECK(scene.FindByPath("Robot/Arm/Claw") == gripper);
+
+	robot.AddChild(gripper);
+	CHECK(scene.FindByPath("Robot/Claw") == gripper);
+	robot.RemoveChild(gripper);
+	CHECK(scene.FindByPath("Claw") == gripper);
+
+	scene.Destroy(gripper);
+	CHECK(scene.FindByPath("Claw").IsNull());
+	CHECK(scene.FindByPath("Arm") == other);
+
+	scene.Destroy(robot);
+	scene.DisableNameIndex();
+	CHECK(scene.FindByPath("Robot").IsNull());
+	CHECK(scene.FindByPath("Arm") == other);
+}
+
+TEST_CASE("Children keep their order and dense indices as they are added and removed")
+{
+	for (bool const childArray : { false, true })
+	{
+		ECS::Scene scene;
+		ECS::Entity parent = scene.CreateEntity();
+		if (childArray)
+			parent.EnableChildArray();
+
+		std::vector<ECS::Entity> children;
+		for (int i = 0; i < 7; ++i)
+		{
+			children.push_back(scene.CreateEntity());
+			parent.AddChild(children.back());
+		}
+		CheckChildren(parent, children);
+
+		// From the middle, the front and the back.
+		ECS::Entity const middle = children[3];
+		parent.RemoveChild(middle);
+		children.erase(children.begin() + 3);
+		CheckChildren(parent, children);
+		CHECK(middle.GetLink().GetParent() == entt::null);
+		CHECK(middle.GetLink().GetChildIndex() == ECS::Link::InvalidChildIndex());
+		CHECK(middle.GetLink().GetPreviousSibling() == entt::null);
+		CHECK(middle.GetLink().GetNextSibling() == entt::null);
+
+		parent.RemoveChildAt(0);
+		children.erase(children.begin());
+		CheckChildren(parent, children);
+
+		parent.RemoveChild(children.back());
+		children.pop_back();
+		CheckChildren(parent, children);
+
+		// Re-adding appends at the end, re-parenting removes the child from its old parent in order.
+		parent.AddChild(middle);
+		children.push_back(middle);
+		CheckChildren(parent, children);
+
+		ECS::Entity other = scene.CreateEntity();
+		other.AddChild(children[1]);
+		CheckChildren(other, { children[1] });
+		children.erase(children.begin() + 1);
+		CheckChildren(parent, children);
+
+		parent.TryRemoveChildAt(children.size());
+		CheckChildren(parent, children);
+
+		while (!children.empty())
+		{
+			parent.RemoveChildAt(children.size() / 2);
+			children.erase(children.begin() + (std::ptrdiff_t)(children.size() / 2));
+			CheckChildren(parent, children);
+		}
+	}
+}
+
+TEST_CASE("Removing a child touches a fixed number of links and the indices are renumbered once")
+{
+	constexpr std::size_t NumChildren = 1000;
+	for (bool const childArray : { false, true })
+	{
+		ECS::Scene scene;
+		ECS::Entity parent = scene.CreateEntity();
+		if (childArray)
+			parent.EnableChildArray();
+		std::vector<ECS::Entity> children;
+		for (std::size_t i = 0; i < NumChildren; ++i)
+		{
+			children.push_back(scene.CreateEntity());
+			parent.AddChild(children.back());
+		}
+		scene.Update(0.0f);
+
+		ECS::SceneHistory history(scene, 4);
+		// The parent, the child and its two neighbours, however many siblings come after it
+		parent.RemoveChild(children[1]);
+		CHECK(history.GetNumCurrentChanges() == 4);
+		parent.RemoveChild(children[10]);
+		CHECK(history.GetNumCurrentChanges() == 7);
+		CHECK(parent.GetLink().HasStaleChildIndices());
+		CHECK(children.back().GetLink().GetChildIndex() == NumChildren - 1);
+
+		// Appending while stale keeps the indices increasing along the sibling list
+		ECS::Entity const appended = scene.CreateEntity();
+		parent.AddChild(appended);
+		CHECK(appended.GetLink().GetChildIndex() > children.back().GetLink().GetChildIndex());
+
+		std::vector<ECS::Entity> visited;
+		parent.ForEachChild([&](ECS::Entity Child) { visited.push_back(Child); });
+		children.erase(children.begin() + 10);
+		children.erase(children.begin() + 1);
+		children.push_back(appended);
+		CHECK(visited == children);
+
+		CHECK(scene.SortHierarchy());
+		CHECK_FALSE(parent.GetLink().HasStaleChildIndices());
+		bool dense = true;
+		for (std::size_t i = 0; i < children.size(); ++i)
+			dense = dense && children[i].GetLink().GetChildIndex() == i;
+		CHECK(dense);
+		if (childArray)
+			CHECK(parent.GetComponent<ECS::ChildArray>().GetChildren().size() == children.size());
+
+		// The renumbering is recorded, undoing the tick puts the removed children back in their places
+		history.CommitTick();
+		REQUIRE(history.Restore(0));
+		CHECK(parent.GetLink().GetNumChildren() == NumChildren);
+		CHECK(parent.GetChildAt(1).GetLink().GetChildIndex() == 1);
+		CHECK(parent.GetChildAt(NumChildren - 1).GetLink().GetChildIndex() == NumChildren - 1);
+	}
+}
+
+TEST_CASE("The child array mirrors the sibling list when it is enabled, disabled and re-enabled")
+{
+	ECS::Scene scene;
+	ECS::Entity parent = scene.CreateEntity();
+	std::vector<ECS::Entity> children;
+	for (int i = 0; i < 5; ++i)
+	{
+		children.push_back(scene.CreateEntity());
+		parent.AddChild(children.back());
+	}
+
+	parent.EnableChildArray();
+	CHECK(parent.HasChildArray());
+	CheckChildren(parent, children);
+
+	parent.RemoveChild(children[2]);
+	children.erase(children.begin() + 2);
+	CheckChildren(parent, children);
+
+	// Changes while it is disabled are picked up when it is enabled again.
+	parent.DisableChildArray();
+	CHECK(!parent.HasChildArray());
+	parent.RemoveChild(children[0]);
+	children.erase(children.begin());
+	children.push_back(scene.CreateEntity());
+	parent.AddChild(children.back());
+	parent.EnableChildArray();
+	CheckChildren(parent, children);
+
+	std::vector<ECS::Entity> visited;
+	parent.ForEachChild([&](ECS::Entity Child) { visited.push_back(Child); });
+	CHECK(visited == children);
+}
+
+TEST_CASE("SortHierarchy puts the hierarchy pools into depth-first pre-order")
+{
+	constexpr std::size_t NumEntities = 500;
+	ECS::Scene scene;
+	std::mt19937 random(11);
+
+	// Entities are linked in shuffled order to random earlier ones, so creation order says nothing about the hierarchy.
+	std::vector<ECS::Entity> entities;
+	for (std::size_t i = 0; i < NumEntities; ++i)
+		entities.push_back(scene.CreateEntity());
+	std::shuffle(entities.begin(), entities.end(), random);
+	for (std::size_t i = 1; i < NumEntities; ++i)
+	{
+		if (random() % 8 == 0)
+			continue;
+		entities[random() % i].AddChild(entities[i]);
+	}
+	// Some re-parenting, so that sibling order differs from the order the children were added in.
+	for (std::size_t i = 0; i < 50; ++i)
+	{
+		ECS::Entity const child = entities[NumEntities / 2 + i];
+		ECS::Entity parent = child.GetParent();
+		if ((entt::entity)parent != entt::null)
+			parent.RemoveChild(child).AddChild(child);
+	}
+
+	CHECK(!scene.IsHierarchySorted());
+	CHECK(scene.SortHierarchy());
+	CHECK(scene.IsHierarchySorted());
+	CHECK(!scene.SortHierarchy());
+
+	entt::registry& registry = scene.GetEnTTRegistry();
+	auto const links = registry.view<ECS::Link>();
+	auto const transforms = registry.view<ECS::TransformComponent>();
+	auto const worldTransforms = registry.view<ECS::WorldTransformComponent>();
+	std::vector<entt::entity> const linkOrder(links.begin(), links.end());
+	std::vector<entt::entity> const transformOrder(transforms.begin(), transforms.end());
+	std::vector<entt::entity> const worldTransformOrder(worldTransforms.begin(), worldTransforms.end());
+	REQUIRE(linkOrder.size() == NumEntities);
+	CHECK(transformOrder == linkOrder);
+	CHECK(worldTransformOrder == linkOrder);
+
+	std::unordered_map<entt::entity, std::size_t> position;
+	for (std::size_t i = 0; i < linkOrder.size(); ++i)
+		position[linkOrder[i]] = i;
+
+	// Subtree sizes, computed from the back since every child comes after its parent.
+	std::unordered_map<entt::entity, std::size_t> subtreeSize;
+	for (std::size_t i = linkOrder.size(); i-- > 0;)
+	{
+		std::size_t size = 1;
+		for (entt::entity child = links.get<ECS::Link>(linkOrder[i]).GetFirstChild(); child != entt::null;
+			child = links.get<ECS::Link>(child).GetNextSibling())
+		{
+			size += subtreeSize[child];
+		}
+		subtreeSize[linkOrder[i]] = size;
+	}
+
+	// Pre-order: a parent comes right before its first child, and every child's subtree is followed by its next sibling.
+	bool parentsFirst = true, preOrder = true;
+	for (entt::entity const entity : linkOrder)
+	{
+		ECS::Link const& link = links.get<ECS::Link>(entity);
+		if (link.GetParent() != entt::null)
+			parentsFirst = parentsFirst && position[link.GetParent()] < position[entity];
+		if (link.GetFirstChild() != entt::null)
+			preOrder = preOrder && position[link.GetFirstChild()] == position[entity] + 1;
+		if (link.GetNextSibling() != entt::null)
+			preOrder = preOrder && position[link.GetNextSibling()] == position[entity] + subtreeSize[entity];
+	}
+	CHECK(parentsFirst);
+	CHECK(preOrder);
+
+	// A structural change invalidates the order, the next Update() sorts again.
+	entities[3].AddChild(scene.CreateEntity());
+	CHECK(!scene.IsHierarchySorted());
+	scene.Update(0.0f);
+	CHECK(scene.IsHierarchySorted());
+}
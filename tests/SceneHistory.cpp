@@ -0,0 +1,170 @@
+#include "doctest/doctest.h"
+
+#include "realsim/core/ThreadPool.h"
+#include "realsim/ecs/Entity.h"
+#include "realsim/ecs/Link.h"
+#include "realsim/ecs/PerspectiveCameraComponent.h"
+#include "realsim/ecs/Scene.h"
+#include "realsim/ecs/SceneHistory.h"
+
+#include <cstddef>
+#include <vector>
+
+using namespace RSim;
+
+TEST_CASE("A restored tick brings back transforms, links and destroyed entities")
+{
+	ECS::Scene scene;
+	ECS::Entity root = scene.CreateEntity();
+	root.SetName("Root");
+	std::vector<ECS::Entity> children;
+	for (int i = 0; i < 4; ++i)
+	{
+		children.push_back(scene.CreateEntity());
+		children.back().GetLocalTransform().Translation.x = (float)i;
+		root.AddChild(children.back());
+	}
+	scene.Update(0.0f);
+
+	ECS::SceneHistory history(scene, 8);
+	CHECK(history.GetCurrentTick() == 0);
+
+	// Tick 0: move a child and rename the root
+	children[1].GetLocalTransform().Translation.x = 10.0f;
+	children[1].GetLocalTransform().Translation.x = 20.0f;
+	root.SetName("Moved");
+	CHECK(history.GetNumCurrentChanges() == 2);
+	history.CommitTick();
+
+	// Tick 1: reparent a child, destroy another and create a new one
+	children[0].AddChild(children[3]);
+	scene.Destroy(children[2]);
+	ECS::Entity created = scene.CreateEntity();
+	root.AddChild(created);
+	history.CommitTick();
+	scene.Update(0.0f);
+
+	CHECK(history.GetOldestRestorableTick() == 0);
+	CHECK_FALSE(history.Restore(3));
+
+	REQUIRE(history.Restore(1));
+	CHECK(history.GetCurrentTick() == 1);
+	CHECK(scene.GetEnTTRegistry().valid(children[2]));
+	CHECK_FALSE(scene.GetEnTTRegistry().valid(created));
+	CHECK(children[2].GetParent() == root);
+	CHECK(children[3].GetParent() == root);
+	CHECK(children[0].GetLink().GetNumChildren() == 0);
+	CHECK(root.GetLink().GetNumChildren() == 4);
+	CHECK(children[1].GetLocalTransform().Translation.x == 20.0f);
+
+	REQUIRE(history.Restore(0));
+	CHECK(children[1].GetLocalTransform().Translation.x == 1.0f);
+	CHECK(root.GetName().Name == "Root");
+	CHECK(scene.FindByPath("Root") == root);
+
+	// The world transforms of the restored entities are recomputed
+	scene.Update(0.0f);
+	CHECK(children[1].GetComponent<ECS::WorldTransformComponent>().World._41 == 1.0f);
+
+	// Ticks after the restored one are gone
+	CHECK_FALSE(history.Restore(1));
+}
+
+TEST_CASE("Only the oldest Capacity ticks are dropped")
+{
+	ECS::Scene scene;
+	ECS::Entity entity = scene.CreateEntity();
+	ECS::SceneHistory history(scene, 4);
+	for (int tick = 0; tick < 10; ++tick)
+	{
+		entity.GetLocalTransform().Translation.y = (float)tick;
+		history.CommitTick();
+	}
+
+	CHECK(history.GetCurrentTick() == 10);
+	CHECK(history.GetOldestRestorableTick() == 6);
+	CHECK_FALSE(history.Restore(5));
+	REQUIRE(history.Restore(6));
+	// Tick 6 began with the value written in tick 5
+	CHECK(entity.GetLocalTransform().Translation.y == 5.0f);
+}
+
+TEST_CASE("An undone destroy brings back every component the transform system and the hierarchy need")
+{
+	ECS::Scene scene;
+	ECS::Entity root = scene.CreateEntity();
+	ECS::Entity parent = scene.CreateEntity();
+	root.AddChild(parent);
+	parent.EnableChildArray();
+	parent.AddComponent<ECS::PerspectiveCameraComponent>(true).FarZ = 50.0f;
+	parent.GetLocalTransform().Translation.x = 5.0f;
+	std::vector<ECS::Entity> children;
+	for (int i = 0; i < 3; ++i)
+	{
+		children.push_back(scene.CreateEntity());
+		children.back().GetLocalTransform().Translation.x = (float)i;
+		parent.AddChild(children.back());
+	}
+	scene.Update(0.0f);
+
+	ECS::SceneHistory history(scene, 4);
+	scene.Destroy(parent);
+	history.CommitTick();
+	scene.Update(0.0f);
+	REQUIRE_FALSE(scene.GetEnTTRegistry().valid(parent));
+
+	REQUIRE(history.Restore(0));
+	auto& registry = scene.GetEnTTRegistry();
+	REQUIRE(registry.valid(parent));
+	CHECK(registry.all_of<ECS::WorldTransformComponent>(parent));
+	REQUIRE(registry.all_of<ECS::PerspectiveCameraComponent>(parent));
+	CHECK(parent.GetComponent<ECS::PerspectiveCameraComponent>().IsPrimaryCamera);
+	CHECK(parent.GetComponent<ECS::PerspectiveCameraComponent>().FarZ == 50.0f);
+	REQUIRE(parent.HasChildArray());
+	CHECK(registry.get<ECS::ChildArray>(parent).GetChildren().size() == children.size());
+
+	// The transform system reaches the restored entity and reads its world transform for the children
+	scene.Update(0.0f);
+	CHECK(parent.GetComponent<ECS::WorldTransformComponent>().World._41 == 5.0f);
+	for (std::size_t i = 0; i < children.size(); ++i)
+	{
+		REQUIRE(registry.valid(children[i]));
+		CHECK(children[i].GetParent() == parent);
+		CHECK(children[i].GetComponent<ECS::WorldTransformComponent>().World._41 == 5.0f + (float)i);
+	}
+
+	// Rebuilding the restored child arrays is not recorded as a change of the new tick
+	CHECK(history.GetNumCurrentChanges() == 0);
+}
+
+TEST_CASE("Transforms changed from several threads at once are all recorded")
+{
+	constexpr std::size_t NumEntities = 4096;
+	ECS::Scene scene;
+	std::vector<ECS::Entity> entities;
+	for (std::size_t i = 0; i < NumEntities; ++i)
+	{
+		entities.push_back(scene.CreateEntity());
+	}
+	ECS::SceneHistory history(scene, 2);
+
+	Core::ThreadPool pool(4);
+	pool.ParallelFor(NumEntities, 64, [&](std::size_t Begin, std::size_t End, std::size_t)
+	{
+		// Every entity is announced twice, only its first change is recorded
+		for (int pass = 0; pass < 2; ++pass)
+		{
+			for (std::size_t i = Begin; i < End; ++i)
+			{
+				entities[i].GetLocalTransform().Translation.y = (float)pass;
+				scene.WillModify<ECS::NameComponent>(entities[i]);
+			}
+		}
+	});
+	CHECK(history.GetNumCurrentChanges() == 2 * NumEntities);
+
+	// The transforms were marked dirty from the workers too
+	scene.Update(0.0f);
+	CHECK(scene.GetTransformSystem().GetNumUpdatedLastFrame() == NumEntities);
+	CHECK(scene.GetComponent<ECS::WorldTransformComponent>(entities.back()).World._42 == 1.0f);
+}
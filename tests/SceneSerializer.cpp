@@ -0,0 +1,287 @@
+#include "doctest/doctest.h"
+
+#include "realsim/core/Logger.h"
+#include "realsim/ecs/Entity.h"
+#include "realsim/ecs/Link.h"
+#include "realsim/ecs/Scene.h"
+#include "realsim/ecs/SceneSerializer.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace RSim;
+
+namespace
+{
+	constexpr std::size_t NumEntities = 100'000;
+
+	/**
+	 * \brief Copies the snapshot into 16-byte aligned memory, as a mapped file would be.
+	 */
+	std::vector<std::max_align_t> Aligned(std::vector<std::byte> const& Bytes)
+	{
+		std::vector<std::max_align_t> aligned((Bytes.size() + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t));
+		std::memcpy(aligned.data(), Bytes.data(), Bytes.size());
+		return aligned;
+	}
+
+	// Layout of the snapshot as written by SaveToMemory(): a 32-byte file header, then one 32-byte header per pool in the order
+	// Transform, WorldTransform, Link, Name, Box, PerspectiveCamera, ChildArray.
+	constexpr std::size_t TransformPoolIndex = 0;
+	constexpr std::size_t LinkPoolIndex = 2;
+	constexpr std::size_t NamePoolIndex = 3;
+
+	std::size_t PoolHeaderOffset(std::size_t Pool)
+	{
+		return 32 + Pool * 32;
+	}
+
+	template<typename T>
+	T Read(std::vector<std::byte> const& Bytes, std::size_t Offset)
+	{
+		T value;
+		std::memcpy(&value, Bytes.data() + Offset, sizeof(T));
+		return value;
+	}
+
+	template<typename T>
+	void Write(std::vector<std::byte>& Bytes, std::size_t Offset, T Value)
+	{
+		std::memcpy(Bytes.data() + Offset, &Value, sizeof(T));
+	}
+
+	std::size_t PoolIndicesOffset(std::vector<std::byte> const& Bytes, std::size_t Pool)
+	{
+		return (std::size_t)Read<uint64_t>(Bytes, PoolHeaderOffset(Pool) + 16);
+	}
+
+	std::size_t PoolDataOffset(std::vector<std::byte> const& Bytes, std::size_t Pool)
+	{
+		return (std::size_t)Read<uint64_t>(Bytes, PoolHeaderOffset(Pool) + 24);
+	}
+
+	// Stored links are 32 bytes of uint32_t file indices, in the order of the Link pool, which is also the order of the file indices.
+	constexpr std::size_t FirstChildField = 0;
+	constexpr std::size_t LastChildField = 4;
+	constexpr std::size_t PreviousSiblingField = 8;
+	constexpr std::size_t NextSiblingField = 12;
+	constexpr std::size_t ParentField = 16;
+	constexpr std::size_t NumChildrenField = 20;
+	constexpr std::size_t ChildIndexField = 24;
+	constexpr uint32_t InvalidFileIndex = UINT32_MAX;
+
+	void WriteLink(std::vector<std::byte>& Bytes, std::size_t Link, std::size_t Field, uint32_t Value)
+	{
+		Write<uint32_t>(Bytes, PoolDataOffset(Bytes, LinkPoolIndex) + Link * 32 + Field, Value);
+	}
+
+	/**
+	 * \brief Loads the snapshot into an empty scene, checks that it is rejected and that nothing was added.
+	 */
+	void CheckRejected(std::vector<std::byte> const& Bytes)
+	{
+		ECS::Scene scene;
+		auto const aligned = Aligned(Bytes);
+		CHECK_FALSE(ECS::SceneSerializer::LoadFromMemory(scene, reinterpret_cast<std::byte const*>(aligned.data()), Bytes.size()));
+		CHECK(scene.GetEnTTRegistry().alive() == 0);
+	}
+}
+
+TEST_CASE("A saved scene loads back with the same hierarchy, names and components")
+{
+	ECS::Scene source;
+	std::vector<ECS::Entity> entities{ source.CreateEntity() };
+	entities[0].SetName("Robot");
+	entities[0].EnableChildArray();
+	for (std::size_t i = 1; i < NumEntities; ++i)
+	{
+		ECS::Entity entity = source.CreateEntity();
+		entity.GetLocalTransform().Translation.x = (float)i;
+		entities[(i - 1) / 4].AddChild(entity);
+		entities.push_back(entity);
+	}
+	entities[1].SetName("Arm");
+	entities[5].SetName("Gripper");
+	entities[5].AddComponent<ECS::BoxComponent>().Color.x = 0.25f;
+	source.Update(0.0f);
+	source.SortHierarchy();
+
+	std::vector<std::byte> const bytes = ECS::SceneSerializer::SaveToMemory(source);
+	auto const aligned = Aligned(bytes);
+
+	ECS::Scene loaded;
+	auto const start = std::chrono::steady_clock::now();
+	REQUIRE(ECS::SceneSerializer::LoadFromMemory(loaded, reinterpret_cast<std::byte const*>(aligned.data()), bytes.size()));
+	auto const elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	MESSAGE("Loaded " << NumEntities << " entities from " << bytes.size() / 1024 << " KiB in " << elapsed << " ms");
+
+	CHECK(loaded.GetEnTTRegistry().alive() == NumEntities);
+
+	ECS::Entity gripper = loaded.FindByPath("Robot/Arm/Gripper");
+	REQUIRE_FALSE(gripper.IsNull());
+	CHECK(gripper.GetComponent<ECS::BoxComponent>().Color.x == 0.25f);
+	CHECK(gripper.GetLocalTransform().Translation.x == 5.0f);
+	CHECK(gripper.GetParent().GetLink().GetNumChildren() == 4);
+	CHECK(gripper.GetTopParent().HasChildArray());
+	CHECK(gripper.GetComponent<ECS::WorldTransformComponent>().World._41 == 6.0f);
+
+	// The loaded hierarchy is a live one
+	ECS::Entity arm = loaded.FindByPath("Robot/Arm");
+	arm.RemoveChild(gripper);
+	CHECK(arm.GetLink().GetNumChildren() == 3);
+	std::size_t const numDestroyed = loaded.DestroySubtree(gripper) + loaded.DestroySubtree(loaded.FindByPath("Robot"));
+	CHECK(numDestroyed == NumEntities);
+}
+
+TEST_CASE("Corrupt scene snapshots are rejected without touching the scene")
+{
+	if (!Core::Logger::GetLogger())
+	{
+		Core::Logger::Init();
+	}
+	ECS::Scene source;
+	ECS::Entity root = source.CreateEntity();
+	root.AddChild(source.CreateEntity());
+	std::vector<std::byte> bytes = ECS::SceneSerializer::SaveToMemory(source);
+
+	ECS::Scene loaded;
+	auto truncated = Aligned(bytes);
+	CHECK_FALSE(ECS::SceneSerializer::LoadFromMemory(loaded, reinterpret_cast<std::byte const*>(truncated.data()), bytes.size() / 2));
+
+	bytes[4] = std::byte{ 0xFF };
+	auto const wrongVersion = Aligned(bytes);
+	CHECK_FALSE(ECS::SceneSerializer::LoadFromMemory(loaded, reinterpret_cast<std::byte const*>(wrongVersion.data()), bytes.size()));
+	CHECK(loaded.GetEnTTRegistry().alive() == 0);
+}
+
+TEST_CASE("Every pool of a scene snapshot is validated before any entity is created")
+{
+	if (!Core::Logger::GetLogger())
+	{
+		Core::Logger::Init();
+	}
+	ECS::Scene source;
+	ECS::Entity root = source.CreateEntity();
+	root.SetName("Root");
+	root.AddChild(source.CreateEntity());
+	root.AddChild(source.CreateEntity());
+	std::vector<std::byte> const valid = ECS::SceneSerializer::SaveToMemory(source);
+	{
+		ECS::Scene loaded;
+		auto const aligned = Aligned(valid);
+		REQUIRE(ECS::SceneSerializer::LoadFromMemory(loaded, reinterpret_cast<std::byte const*>(aligned.data()), valid.size()));
+	}
+
+	// Wrong element size
+	{
+		std::vector<std::byte> bytes = valid;
+		std::size_t const elementSize = PoolHeaderOffset(TransformPoolIndex) + 8;
+		Write<uint32_t>(bytes, elementSize, Read<uint32_t>(bytes, elementSize) + 16);
+		CheckRejected(bytes);
+	}
+	// Missing required pool, an unknown component is skipped and leaves the snapshot without links
+	{
+		std::vector<std::byte> bytes = valid;
+		Write<uint32_t>(bytes, PoolHeaderOffset(LinkPoolIndex), 1000);
+		CheckRejected(bytes);
+	}
+	// Entity index out of range
+	{
+		std::vector<std::byte> bytes = valid;
+		Write<uint32_t>(bytes, PoolIndicesOffset(bytes, TransformPoolIndex) + 2 * sizeof(uint32_t), 3);
+		CheckRejected(bytes);
+	}
+	// Duplicate entity index
+	{
+		std::vector<std::byte> bytes = valid;
+		std::size_t const indices = PoolIndicesOffset(bytes, NamePoolIndex);
+		Write<uint32_t>(bytes, indices + 2 * sizeof(uint32_t), Read<uint32_t>(bytes, indices));
+		CheckRejected(bytes);
+	}
+	// Link to an entity that does not exist, patched into the parent of the second stored link
+	{
+		std::vector<std::byte> bytes = valid;
+		Write<uint32_t>(bytes, PoolDataOffset(bytes, LinkPoolIndex) + 32 + 16, 3);
+		CheckRejected(bytes);
+	}
+	// Name that is not in the string table
+	{
+		std::vector<std::byte> bytes = valid;
+		Write<uint32_t>(bytes, PoolDataOffset(bytes, NamePoolIndex), 1000);
+		CheckRejected(bytes);
+	}
+}
+
+TEST_CASE("Snapshots whose links do not form a consistent hierarchy are rejected")
+{
+	if (!Core::Logger::GetLogger())
+	{
+		Core::Logger::Init();
+	}
+	// Stored depth-first: the root is link 0, its children are links 1 and 2
+	ECS::Scene source;
+	ECS::Entity root = source.CreateEntity();
+	root.AddChild(source.CreateEntity());
+	root.AddChild(source.CreateEntity());
+	std::vector<std::byte> const valid = ECS::SceneSerializer::SaveToMemory(source);
+
+	// Sibling back-link that does not point at the previous sibling
+	{
+		std::vector<std::byte> bytes = valid;
+		WriteLink(bytes, 2, PreviousSiblingField, InvalidFileIndex);
+		CheckRejected(bytes);
+	}
+	// Sibling list that loops back onto itself
+	{
+		std::vector<std::byte> bytes = valid;
+		WriteLink(bytes, 1, NextSiblingField, 1);
+		CheckRejected(bytes);
+	}
+	// More children than the sibling list holds
+	{
+		std::vector<std::byte> bytes = valid;
+		WriteLink(bytes, 0, NumChildrenField, 3);
+		CheckRejected(bytes);
+	}
+	// A child that names the parent but is cut out of its sibling list
+	{
+		std::vector<std::byte> bytes = valid;
+		WriteLink(bytes, 1, NextSiblingField, InvalidFileIndex);
+		WriteLink(bytes, 0, LastChildField, 1);
+		WriteLink(bytes, 0, NumChildrenField, 1);
+		CheckRejected(bytes);
+	}
+	// Child index that does not match the child's position
+	{
+		std::vector<std::byte> bytes = valid;
+		WriteLink(bytes, 2, ChildIndexField, 0);
+		CheckRejected(bytes);
+	}
+	// Root with a sibling
+	{
+		std::vector<std::byte> bytes = valid;
+		WriteLink(bytes, 0, NextSiblingField, 1);
+		CheckRejected(bytes);
+	}
+	// Two entities that are each other's parent, every sibling list is consistent but neither is reachable from a root
+	{
+		std::vector<std::byte> bytes = valid;
+		WriteLink(bytes, 0, FirstChildField, InvalidFileIndex);
+		WriteLink(bytes, 0, LastChildField, InvalidFileIndex);
+		WriteLink(bytes, 0, NumChildrenField, 0);
+		for (uint32_t link : { 1u, 2u })
+		{
+			uint32_t const other = 3 - link;
+			WriteLink(bytes, link, FirstChildField, other);
+			WriteLink(bytes, link, LastChildField, other);
+			WriteLink(bytes, link, PreviousSiblingField, InvalidFileIndex);
+			WriteLink(bytes, link, NextSiblingField, InvalidFileIndex);
+			WriteLink(bytes, link, ParentField, other);
+			WriteLink(bytes, link, NumChildrenField, 1);
+			WriteLink(bytes, link, ChildIndexField, 0);
+		}
+		CheckRejected(bytes);
+	}
+}
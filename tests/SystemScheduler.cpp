@@ -0,0 +1,235 @@
+#include "doctest/doctest.h"
+
+#include "realsim/core/ThreadPool.h"
+#include "realsim/ecs/Entity.h"
+#include "realsim/ecs/Link.h"
+#include "realsim/ecs/Scene.h"
+#include "realsim/ecs/SystemScheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace RSim;
+
+namespace
+{
+	struct ComponentA {};
+	struct ComponentB {};
+	struct ComponentC {};
+}
+
+TEST_CASE("Conflicting systems run in the order they were added")
+{
+	Core::ThreadPool pool{ 4 };
+	ECS::Scene scene;
+	ECS::SystemScheduler scheduler;
+	scheduler.SetThreadPool(&pool);
+
+	std::mutex mutex;
+	std::vector<int> order;
+	auto const system = [&](int ID)
+	{
+		return [&, ID](ECS::Scene&, float, ECS::EntityCommandBuffer&)
+		{
+			std::lock_guard lock(mutex);
+			order.push_back(ID);
+		};
+	};
+
+	scheduler.AddSystem("Write A", ECS::SystemAccess{}.Write<ComponentA>(), system(0));
+	scheduler.AddSystem("Read A Write B", ECS::SystemAccess{}.Read<ComponentA>().Write<ComponentB>(), system(1));
+	scheduler.AddSystem("Write C", ECS::SystemAccess{}.Write<ComponentC>(), system(2));
+	scheduler.AddSystem("Read C", ECS::SystemAccess{}.Read<ComponentC>(), system(3));
+	scheduler.AddSystem("Read C again", ECS::SystemAccess{}.Read<ComponentC>(), system(4));
+	scheduler.AddSystem("Exclusive", ECS::SystemAccess{}.Exclusive(), system(5));
+
+	for (int frame = 0; frame < 100; ++frame)
+	{
+		order.clear();
+		scheduler.Run(scene, 0.0f);
+		REQUIRE(order.size() == 6);
+
+		auto const position = [&](int ID) { return std::find(order.begin(), order.end(), ID) - order.begin(); };
+		CHECK(position(0) < position(1));
+		CHECK(position(2) < position(3));
+		CHECK(position(2) < position(4));
+		CHECK(position(5) == 5);
+	}
+
+	scheduler.SetEnabled(0, false);
+	order.clear();
+	scheduler.Run(scene, 0.0f);
+	CHECK(order.size() == 5);
+}
+
+TEST_CASE("Jobs can wait for nested parallel loops on the work-stealing pool")
+{
+	Core::ThreadPool pool{ 3 };
+	std::atomic<std::size_t> sum{ 0 };
+	pool.ParallelFor(64, 1, [&](std::size_t Begin, std::size_t End, std::size_t)
+	{
+		for (std::size_t i = Begin; i < End; ++i)
+		{
+			pool.ParallelFor(1000, 10, [&](std::size_t InnerBegin, std::size_t InnerEnd, std::size_t)
+			{
+				sum += InnerEnd - InnerBegin;
+			});
+		}
+	});
+	CHECK(sum == 64 * 1000);
+}
+
+TEST_CASE("Structural changes recorded by parallel systems are played back in a fixed order")
+{
+	Core::ThreadPool pool{ 4 };
+	ECS::Scene scene;
+	ECS::Entity const target = scene.CreateEntity();
+	entt::entity const targetHandle = target;
+
+	scene.GetScheduler().SetThreadPool(&pool);
+	scene.GetScheduler().AddSystem("Spawn", ECS::SystemAccess{}.Read<ComponentA>(), [&](ECS::Scene&, float, ECS::EntityCommandBuffer& Commands)
+	{
+		Commands.ReserveTasks(pool.GetMaxParallelism());
+		pool.ParallelFor(1000, 100, [&](std::size_t Begin, std::size_t End, std::size_t TaskIndex)
+		{
+			for (std::size_t i = Begin; i < End; ++i)
+			{
+				ECS::DeferredEntity const entity = Commands.ForTask(TaskIndex).Create();
+				Commands.ForTask(TaskIndex).Emplace<ComponentB>(entity);
+			}
+		});
+	});
+	scene.GetScheduler().AddSystem("Tag", ECS::SystemAccess{}.Read<ComponentC>(), [&](ECS::Scene&, float, ECS::EntityCommandBuffer& Commands)
+	{
+		Commands.Emplace<ECS::BoxComponent>(targetHandle, ECS::BoxComponent{ { 1.0f, 2.0f } });
+	});
+
+	scene.Update(0.0f);
+
+	CHECK(scene.GetEnTTRegistry().view<ComponentB>().size() == 1000);
+	CHECK(scene.GetComponent<ECS::BoxComponent>(target).ScreenPosition.y == 2.0f);
+}
+
+TEST_CASE("A throwing system skips the systems after it, discards the frame's commands and is rethrown from Run()")
+{
+	for (bool const parallel : { false, true })
+	{
+		Core::ThreadPool pool{ 3 };
+		ECS::Scene scene;
+		ECS::SystemScheduler scheduler;
+		if (parallel)
+			scheduler.SetThreadPool(&pool);
+
+		std::atomic<int> numRun{ 0 };
+		bool fail = true;
+		scheduler.AddSystem("Spawn", ECS::SystemAccess{}.Write<ComponentA>(), [&](ECS::Scene&, float, ECS::EntityCommandBuffer& Commands)
+		{
+			++numRun;
+			ECS::DeferredEntity const entity = Commands.Create();
+			Commands.Emplace<ComponentB>(entity);
+		});
+		scheduler.AddSystem("Fail", ECS::SystemAccess{}.Read<ComponentA>(), [&](ECS::Scene&, float, ECS::EntityCommandBuffer&)
+		{
+			++numRun;
+			if (fail)
+				throw std::runtime_error("system failed");
+		});
+		scheduler.AddSystem("After", ECS::SystemAccess{}.Exclusive(), [&](ECS::Scene&, float, ECS::EntityCommandBuffer&)
+		{
+			++numRun;
+		});
+
+		CHECK_THROWS_AS(scheduler.Run(scene, 0.0f), std::runtime_error);
+		CHECK(numRun.load() == 2);
+		CHECK(scene.GetEnTTRegistry().view<ComponentB>().size() == 0);
+
+		// The next frame runs normally and only applies its own commands.
+		fail = false;
+		numRun = 0;
+		CHECK_NOTHROW(scheduler.Run(scene, 0.0f));
+		CHECK(numRun.load() == 3);
+		CHECK(scene.GetEnTTRegistry().view<ComponentB>().size() == 1);
+	}
+}
+
+TEST_CASE("Links and names conflict through the scene state they share, transforms do not")
+{
+	using ECS::SystemAccess;
+	CHECK(SystemAccess{}.Write<ECS::Link>().ConflictsWith(SystemAccess{}.Write<ECS::NameComponent>()));
+	CHECK(SystemAccess{}.Read<ECS::Link>().ConflictsWith(SystemAccess{}.Write<ECS::NameComponent>()));
+	CHECK(SystemAccess{}.Write<ECS::Link>().ConflictsWith(SystemAccess{}.Read<ECS::NameComponent>()));
+	CHECK_FALSE(SystemAccess{}.Read<ECS::Link>().ConflictsWith(SystemAccess{}.Read<ECS::NameComponent>()));
+	CHECK_FALSE(SystemAccess{}.Write<ECS::TransformComponent>().ConflictsWith(SystemAccess{}.Write<ECS::Link>()));
+
+	// A system moving entities and one re-parenting others run at the same time, both mark transforms dirty
+	constexpr std::size_t NumMoved = 2000;
+	constexpr std::size_t NumChildren = 200;
+	Core::ThreadPool pool{ 4 };
+	ECS::Scene scene;
+	scene.EnableNameIndex();
+	scene.SetThreadPool(&pool);
+	std::vector<ECS::Entity> moved;
+	for (std::size_t i = 0; i < NumMoved; ++i)
+	{
+		moved.push_back(scene.CreateEntity());
+	}
+	ECS::Entity first = scene.CreateEntity();
+	ECS::Entity second = scene.CreateEntity();
+	second.GetLocalTransform().Translation.x = 10.0f;
+	std::vector<ECS::Entity> children;
+	for (std::size_t i = 0; i < NumChildren; ++i)
+	{
+		children.push_back(scene.CreateEntity());
+		first.AddChild(children.back());
+	}
+	children.back().SetName("Last");
+	scene.Update(0.0f);
+
+	// Each system waits a while for the other one to start, so that they overlap if the scheduler lets them
+	std::atomic<int> numStarted{ 0 };
+	std::atomic<bool> overlapped{ false };
+	auto const waitForOther = [&]
+	{
+		++numStarted;
+		auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+		while (numStarted.load() < 2 && std::chrono::steady_clock::now() < deadline)
+			std::this_thread::yield();
+		if (numStarted.load() == 2)
+			overlapped = true;
+	};
+	scene.GetScheduler().AddSystem("Move", SystemAccess{}.Write<ECS::TransformComponent>(), [&](ECS::Scene&, float, ECS::EntityCommandBuffer&)
+	{
+		waitForOther();
+		pool.ParallelFor(NumMoved, 100, [&](std::size_t Begin, std::size_t End, std::size_t)
+		{
+			for (std::size_t i = Begin; i < End; ++i)
+				moved[i].GetLocalTransform().Translation.y = 1.0f;
+		});
+	});
+	scene.GetScheduler().AddSystem("Reparent", SystemAccess{}.Write<ECS::Link>(), [&](ECS::Scene&, float, ECS::EntityCommandBuffer&)
+	{
+		waitForOther();
+		for (ECS::Entity const& child : children)
+			second.AddChild(child);
+	});
+
+	scene.Update(0.0f);
+	CHECK(overlapped.load());
+	CHECK(first.GetLink().GetNumChildren() == 0);
+	CHECK(second.GetLink().GetNumChildren() == NumChildren);
+	CHECK(scene.GetEnTTRegistry().view<ECS::DirtyTransformTag>().empty());
+	bool correct = true;
+	for (ECS::Entity const& entity : moved)
+		correct = correct && scene.GetComponent<ECS::WorldTransformComponent>(entity).World._42 == 1.0f;
+	for (ECS::Entity const& child : children)
+		correct = correct && scene.GetComponent<ECS::WorldTransformComponent>(child).World._41 == 10.0f;
+	CHECK(correct);
+	CHECK(scene.FindChild(first, "Last").IsNull());
+	CHECK(scene.FindChild(second, "Last") == children.back());
+	scene.SetThreadPool(nullptr);
+}
@@ -0,0 +1,132 @@
+#include "doctest/doctest.h"
+
+#include "realsim/core/ThreadPool.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace RSim;
+
+namespace
+{
+	/**
+	 * \brief Runs ParallelFor over Count items and checks every item was visited exactly once, by a task within the parallelism.
+	 * \return The number of tasks.
+	 */
+	std::size_t CheckCoverage(Core::ThreadPool& Pool, std::size_t Count, std::size_t MinItemsPerTask)
+	{
+		std::vector<std::atomic<int>> visits(Count);
+		std::size_t const numTasks = Pool.ParallelFor(Count, MinItemsPerTask, [&](std::size_t Begin, std::size_t End, std::size_t TaskIndex)
+		{
+			CHECK(Begin < End);
+			CHECK(TaskIndex < Pool.GetMaxParallelism());
+			for (std::size_t i = Begin; i < End; ++i)
+			{
+				++visits[i];
+			}
+		});
+		for (auto const& visit : visits)
+		{
+			CHECK(visit.load() == 1);
+		}
+		return numTasks;
+	}
+}
+
+TEST_CASE("ParallelFor visits every item once and splits into at most one task per thread")
+{
+	Core::ThreadPool pool(3);
+	CHECK(pool.GetMaxParallelism() == 4);
+
+	CHECK(CheckCoverage(pool, 0, 1) == 0);
+	CHECK(CheckCoverage(pool, 1, 1) == 1);
+	// Fewer items than threads, one task per item.
+	CHECK(CheckCoverage(pool, 3, 1) == 3);
+	CHECK(CheckCoverage(pool, 10007, 1) == 4);
+	// MinItemsPerTask bounds the number of tasks.
+	CHECK(CheckCoverage(pool, 100, 40) == 3);
+	CHECK(CheckCoverage(pool, 100, 0) == 4);
+}
+
+TEST_CASE("A pool without workers runs everything on the calling thread")
+{
+	Core::ThreadPool pool(0);
+	CHECK(pool.GetMaxParallelism() == 1);
+	CHECK(CheckCoverage(pool, 100, 1) == 1);
+
+	int numRun = 0;
+	pool.Submit([&] { ++numRun; });
+	CHECK(numRun == 1);
+}
+
+TEST_CASE("ParallelFor can be nested inside its own tasks")
+{
+	Core::ThreadPool pool(3);
+	std::atomic<std::size_t> sum{ 0 };
+	pool.ParallelFor(8, 1, [&](std::size_t Begin, std::size_t End, std::size_t)
+	{
+		for (std::size_t outer = Begin; outer < End; ++outer)
+		{
+			pool.ParallelFor(100, 1, [&](std::size_t InnerBegin, std::size_t InnerEnd, std::size_t)
+			{
+				for (std::size_t inner = InnerBegin; inner < InnerEnd; ++inner)
+				{
+					sum += outer * 100 + inner;
+				}
+			});
+		}
+	});
+	// The sum of 0..799.
+	CHECK(sum.load() == 799 * 800 / 2);
+}
+
+TEST_CASE("An exception in a ParallelFor task is rethrown on the caller after every task has finished")
+{
+	Core::ThreadPool pool(3);
+	for (std::size_t throwingTask = 0; throwingTask < 4; ++throwingTask)
+	{
+		std::atomic<std::size_t> numFinished{ 0 };
+		bool caught = false;
+		try
+		{
+			pool.ParallelFor(4, 1, [&](std::size_t, std::size_t, std::size_t TaskIndex)
+			{
+				if (TaskIndex == throwingTask)
+					throw std::runtime_error("task failed");
+				++numFinished;
+			});
+		}
+		catch (std::runtime_error const&)
+		{
+			caught = true;
+		}
+		CHECK(caught);
+		CHECK(numFinished.load() == 3);
+	}
+
+	// The pool is still usable afterwards.
+	CHECK(CheckCoverage(pool, 1000, 1) == 4);
+}
+
+TEST_CASE("An exception thrown by a nested ParallelFor reaches the outer caller")
+{
+	Core::ThreadPool pool(2);
+	bool caught = false;
+	try
+	{
+		pool.ParallelFor(3, 1, [&](std::size_t, std::size_t, std::size_t TaskIndex)
+		{
+			pool.ParallelFor(3, 1, [&](std::size_t, std::size_t, std::size_t InnerTaskIndex)
+			{
+				if (TaskIndex == 2 && InnerTaskIndex == 1)
+					throw std::logic_error("inner task failed");
+			});
+		});
+	}
+	catch (std::logic_error const&)
+	{
+		caught = true;
+	}
+	CHECK(caught);
+}
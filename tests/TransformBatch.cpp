@@ -0,0 +1,104 @@
+#include "doctest/doctest.h"
+
+#include "realsim/ecs/TransformBatch.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace RSim;
+
+namespace
+{
+	void CheckEqual(DirectX::XMFLOAT4X4 const& Actual, DirectX::XMFLOAT4X4 const& Expected)
+	{
+		for (int row = 0; row < 4; ++row)
+		{
+			for (int column = 0; column < 4; ++column)
+			{
+				CHECK(Actual.m[row][column] == doctest::Approx(Expected.m[row][column]).epsilon(1e-5));
+			}
+		}
+	}
+}
+
+TEST_CASE("Batched transform matrices are equal to TransformComponent::GetTransform")
+{
+	std::mt19937 random{ 42 };
+	std::uniform_real_distribution<float> distribution{ -4.0f, 4.0f };
+
+	// Not a multiple of the lane count, so the scalar tail is covered as well
+	constexpr std::size_t NumTransforms = 8 * 16 + 5;
+	std::vector<ECS::TransformComponent> transforms;
+	ECS::TransformBatch batch;
+	for (std::size_t i = 0; i < NumTransforms; ++i)
+	{
+		DirectX::XMFLOAT4 rotation{ distribution(random), distribution(random), distribution(random), distribution(random) };
+		DirectX::XMStoreFloat4(&rotation, DirectX::XMQuaternionNormalize(DirectX::XMLoadFloat4(&rotation)));
+		transforms.emplace_back(DirectX::XMFLOAT3{ distribution(random), distribution(random), distribution(random) }, rotation,
+			DirectX::XMFLOAT3{ distribution(random), distribution(random), distribution(random) });
+		batch.Add(transforms.back());
+	}
+	REQUIRE(batch.Size() == NumTransforms);
+
+	std::vector<DirectX::XMFLOAT4X4> batched(NumTransforms);
+	std::vector<DirectX::XMFLOAT4X4> scalar(NumTransforms);
+	batch.BuildMatrices(batched.data());
+	batch.BuildMatricesScalar(scalar.data());
+
+	MESSAGE("AVX2 " << (ECS::TransformBatch::IsAVX2Enabled() ? "enabled" : "disabled"));
+#if defined(RSIM_EXPECT_AVX2)
+	// Configured with ENABLE_AVX2, the SIMD path has to be the one under test
+	CHECK(ECS::TransformBatch::IsAVX2Enabled());
+#endif
+	for (std::size_t i = 0; i < NumTransforms; ++i)
+	{
+		DirectX::XMFLOAT4X4 expected;
+		DirectX::XMStoreFloat4x4(&expected, transforms[i].GetTransform());
+		CheckEqual(batched[i], expected);
+		CheckEqual(scalar[i], expected);
+	}
+
+	batch.Clear();
+	CHECK(batch.Size() == 0);
+}
+
+TEST_CASE("A batch resized and written by index matches one filled with Add")
+{
+	std::vector<ECS::TransformComponent> transforms;
+	for (int i = 0; i < 21; ++i)
+	{
+		transforms.emplace_back(DirectX::XMFLOAT3{ (float)i, 1.0f, -2.0f }, DirectX::XMFLOAT4{ 0.0f, 0.0f, 0.0f, 1.0f },
+			DirectX::XMFLOAT3{ 1.0f, 0.5f * (float)i, 2.0f });
+	}
+
+	ECS::TransformBatch added;
+	for (auto const& transform : transforms)
+	{
+		added.Add(transform);
+	}
+
+	// Filled once with more transforms first, shrinking and rewriting it must not leave stale values behind
+	ECS::TransformBatch indexed;
+	indexed.Resize(64);
+	for (std::size_t i = 0; i < 64; ++i)
+	{
+		indexed.Set(i, transforms[i % transforms.size()]);
+	}
+	indexed.Clear();
+	indexed.Resize(transforms.size());
+	for (std::size_t i = transforms.size(); i-- > 0;)
+	{
+		indexed.Set(i, transforms[i]);
+	}
+	REQUIRE(indexed.Size() == added.Size());
+
+	std::vector<DirectX::XMFLOAT4X4> fromAdd(transforms.size());
+	std::vector<DirectX::XMFLOAT4X4> fromSet(transforms.size());
+	added.BuildMatrices(fromAdd.data());
+	indexed.BuildMatrices(fromSet.data());
+	for (std::size_t i = 0; i < transforms.size(); ++i)
+	{
+		CheckEqual(fromSet[i], fromAdd[i]);
+	}
+}
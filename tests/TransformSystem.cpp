@@ -0,0 +1,216 @@
+#include "doctest/doctest.h"
+
+#include "realsim/core/ThreadPool.h"
+#include "realsim/ecs/Scene.h"
+#include "realsim/ecs/Entity.h"
+#include "realsim/ecs/Link.h"
+
+#include <vector>
+
+using namespace RSim;
+
+namespace
+{
+	/**
+	 * \brief The world matrix the entity should have, composed from the local transforms up the hierarchy.
+	 */
+	DirectX::XMMATRIX ExpectedWorld(ECS::Entity const& Entity)
+	{
+		DirectX::XMMATRIX world = Entity.GetLocalTransform().GetTransform();
+		for (ECS::Entity parent = Entity.GetParent(); (entt::entity)parent != entt::null; parent = parent.GetParent())
+		{
+			ECS::Entity const& constParent = parent;
+			world = DirectX::XMMatrixMultiply(world, constParent.GetLocalTransform().GetTransform());
+		}
+		return world;
+	}
+
+	void CheckWorld(ECS::Scene& Scene, ECS::Entity const& Entity)
+	{
+		DirectX::XMFLOAT4X4 expected;
+		DirectX::XMStoreFloat4x4(&expected, ExpectedWorld(Entity));
+		DirectX::XMFLOAT4X4 const& actual = Scene.GetComponent<ECS::WorldTransformComponent>(Entity).World;
+		for (int row = 0; row < 4; ++row)
+		{
+			for (int column = 0; column < 4; ++column)
+			{
+				CHECK(actual.m[row][column] == doctest::Approx(expected.m[row][column]).epsilon(1e-5));
+			}
+		}
+	}
+
+	void SetTransform(ECS::Entity Entity, float X, float Y, float Z, float Scale, float Angle)
+	{
+		ECS::TransformComponent& transform = Entity.GetLocalTransform();
+		transform.Translation = DirectX::XMFLOAT3{ X, Y, Z };
+		transform.Scale = DirectX::XMFLOAT3{ Scale, Scale, Scale };
+		DirectX::XMStoreFloat4(&transform.Rotation, DirectX::XMQuaternionRotationRollPitchYaw(0.0f, Angle, 0.0f));
+	}
+}
+
+TEST_CASE("World transforms follow parent and child updates through a multi-level hierarchy")
+{
+	// root -> arm -> forearm -> hand, with a second child of the root next to the arm.
+	ECS::Scene scene;
+	ECS::Entity root = scene.CreateEntity();
+	ECS::Entity arm = scene.CreateEntity();
+	ECS::Entity forearm = scene.CreateEntity();
+	ECS::Entity hand = scene.CreateEntity();
+	ECS::Entity head = scene.CreateEntity();
+	root.AddChild(arm).AddChild(head);
+	arm.AddChild(forearm);
+	forearm.AddChild(hand);
+	std::vector<ECS::Entity> const all = { root, arm, forearm, hand, head };
+
+	SetTransform(root, 10.0f, 0.0f, 0.0f, 2.0f, 0.5f);
+	SetTransform(arm, 1.0f, 2.0f, 0.0f, 1.0f, 0.25f);
+	SetTransform(forearm, 0.0f, 3.0f, 1.0f, 0.5f, -0.75f);
+	SetTransform(hand, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f);
+	SetTransform(head, 0.0f, 5.0f, 0.0f, 1.0f, 0.0f);
+	scene.Update(0.0f);
+	CHECK(scene.GetTransformSystem().GetNumUpdatedLastFrame() == all.size());
+	CHECK(scene.GetEnTTRegistry().view<ECS::DirtyTransformTag>().empty());
+	for (ECS::Entity const& entity : all)
+	{
+		CheckWorld(scene, entity);
+	}
+
+	// Moving the arm moves everything below it, the root and the head stay where they are.
+	SetTransform(arm, -4.0f, 2.0f, 3.0f, 1.5f, 1.25f);
+	scene.Update(0.0f);
+	CHECK(scene.GetTransformSystem().GetNumUpdatedLastFrame() == 3);
+	for (ECS::Entity const& entity : all)
+	{
+		CheckWorld(scene, entity);
+	}
+
+	// A change to the leaf only recomputes the leaf.
+	SetTransform(hand, 0.0f, 2.0f, 0.0f, 1.0f, -1.0f);
+	scene.Update(0.0f);
+	CHECK(scene.GetTransformSystem().GetNumUpdatedLastFrame() == 1);
+	CheckWorld(scene, hand);
+
+	// A dirty child under a dirty parent is recomputed once, after its parent.
+	SetTransform(hand, 1.0f, 2.0f, 0.0f, 1.0f, 0.0f);
+	SetTransform(forearm, 0.0f, 1.0f, 1.0f, 2.0f, 0.0f);
+	scene.Update(0.0f);
+	CHECK(scene.GetTransformSystem().GetNumUpdatedLastFrame() == 2);
+	for (ECS::Entity const& entity : all)
+	{
+		CheckWorld(scene, entity);
+	}
+
+	// Re-parenting the forearm onto the head makes it and the hand follow the head.
+	head.AddChild(forearm);
+	scene.Update(0.0f);
+	for (ECS::Entity const& entity : all)
+	{
+		CheckWorld(scene, entity);
+	}
+
+	// Nothing changed, nothing is recomputed.
+	scene.Update(0.0f);
+	CHECK(scene.GetTransformSystem().GetNumUpdatedLastFrame() == 0);
+}
+
+TEST_CASE("Independent subtrees are updated in parallel with the same result")
+{
+	// Enough subtrees under the root for the walk to split them across the pool.
+	constexpr std::size_t NumSubtrees = 4 * ECS::TransformSystem::MinSubtreesPerTask;
+	Core::ThreadPool pool(3);
+	ECS::Scene scene;
+	scene.SetThreadPool(&pool);
+
+	ECS::Entity root = scene.CreateEntity();
+	std::vector<ECS::Entity> all{ root };
+	for (std::size_t i = 0; i < NumSubtrees; ++i)
+	{
+		ECS::Entity child = scene.CreateEntity();
+		ECS::Entity grandchild = scene.CreateEntity();
+		root.AddChild(child);
+		child.AddChild(grandchild);
+		SetTransform(child, (float)i, 1.0f, 0.0f, 1.0f, 0.01f * (float)i);
+		SetTransform(grandchild, 0.0f, 0.0f, 1.0f, 0.5f, 0.0f);
+		all.push_back(child);
+		all.push_back(grandchild);
+	}
+	SetTransform(root, 0.0f, 0.0f, 5.0f, 2.0f, 0.3f);
+
+	scene.Update(0.0f);
+	CHECK(scene.GetTransformSystem().GetNumUpdatedLastFrame() == all.size());
+	for (ECS::Entity const& entity : all)
+	{
+		CheckWorld(scene, entity);
+	}
+
+	SetTransform(root, 1.0f, 2.0f, 3.0f, 1.0f, -0.3f);
+	scene.Update(0.0f);
+	CHECK(scene.GetTransformSystem().GetNumUpdatedLastFrame() == all.size());
+	for (ECS::Entity const& entity : all)
+	{
+		CheckWorld(scene, entity);
+	}
+	scene.SetThreadPool(nullptr);
+}
+
+TEST_CASE("A system's moves are in the world transforms at the end of the same update")
+{
+	Core::ThreadPool pool(3);
+	ECS::Scene scene;
+	scene.SetThreadPool(&pool);
+	ECS::Entity parent = scene.CreateEntity();
+	ECS::Entity child = scene.CreateEntity();
+	parent.AddChild(child);
+	SetTransform(child, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f);
+	scene.Update(0.0f);
+
+	// Added after the transform system existed, a system that moves the parent every update
+	float x = 0.0f;
+	scene.GetScheduler().AddSystem("Mover", ECS::SystemAccess{}.Write<ECS::TransformComponent>(),
+		[&](ECS::Scene&, float, ECS::EntityCommandBuffer&)
+		{
+			x += 1.0f;
+			SetTransform(parent, x, 0.0f, 0.0f, 1.0f, 0.0f);
+		});
+
+	for (int update = 1; update <= 3; ++update)
+	{
+		scene.Update(0.0f);
+		CHECK(scene.GetComponent<ECS::WorldTransformComponent>(parent).World._41 == (float)update);
+		CHECK(scene.GetComponent<ECS::WorldTransformComponent>(child).World._41 == (float)update);
+		CHECK(scene.GetComponent<ECS::WorldTransformComponent>(child).World._42 == 1.0f);
+	}
+	scene.SetThreadPool(nullptr);
+}
+
+TEST_CASE("Transforms can be changed from inside a ParallelFor")
+{
+	constexpr std::size_t NumEntities = 10000;
+	Core::ThreadPool pool(3);
+	ECS::Scene scene;
+	std::vector<ECS::Entity> entities;
+	for (std::size_t i = 0; i < NumEntities; ++i)
+	{
+		entities.push_back(scene.CreateEntity());
+	}
+	scene.Update(0.0f);
+
+	// Marking an entity dirty is not a structural change, so the workers may do it concurrently
+	pool.ParallelFor(NumEntities, 256, [&](std::size_t Begin, std::size_t End, std::size_t)
+	{
+		for (std::size_t i = Begin; i < End; ++i)
+		{
+			entities[i].GetLocalTransform().Translation.z = (float)i;
+		}
+	});
+	CHECK(scene.GetEnTTRegistry().view<ECS::DirtyTransformTag>().empty());
+
+	scene.Update(0.0f);
+	CHECK(scene.GetTransformSystem().GetNumUpdatedLastFrame() == NumEntities);
+	bool moved = true;
+	for (std::size_t i = 0; i < NumEntities; ++i)
+	{
+		moved = moved && scene.GetComponent<ECS::WorldTransformComponent>(entities[i]).World._43 == (float)i;
+	}
+	CHECK(moved);
+}
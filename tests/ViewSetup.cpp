@@ -0,0 +1,89 @@
+#include "doctest/doctest.h"
+
+#include "realsim/ecs/PerspectiveCameraComponent.h"
+#include "realsim/graphics/ViewSetup.h"
+
+#include <cstring>
+#include <vector>
+
+using namespace RSim;
+
+namespace
+{
+	entt::entity CreateCamera(entt::registry& Registry, bool Primary, float Z)
+	{
+		entt::entity const camera = Registry.create();
+		auto& component = Registry.emplace<ECS::PerspectiveCameraComponent>(camera, Primary);
+		component.SetViewMatrix(DirectX::XMMatrixLookAtLH(DirectX::XMVectorSet(0.0f, 0.0f, Z, 1.0f), DirectX::XMVectorZero(),
+			DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)));
+		return camera;
+	}
+}
+
+TEST_CASE("Views are set up once per camera and reused while the camera does not change")
+{
+	entt::registry registry;
+	entt::entity const inactive = CreateCamera(registry, false, -20.0f);
+	entt::entity const secondary = CreateCamera(registry, false, -10.0f);
+	entt::entity const primary = CreateCamera(registry, true, -5.0f);
+	(void)inactive;
+
+	auto& secondaryCamera = registry.get<ECS::PerspectiveCameraComponent>(secondary);
+	secondaryCamera.IsActive = true;
+	secondaryCamera.ViewportX = 0.75f;
+	secondaryCamera.ViewportWidth = 0.25f;
+	secondaryCamera.ViewportHeight = 0.25f;
+
+	Graphics::ViewSetup setup;
+	REQUIRE(setup.Build(registry, 1600.0f, 900.0f) == 2);
+	CHECK(setup.GetNumRecomputedViews() == 2);
+
+	std::vector<Graphics::RenderView> const& views = setup.GetViews();
+	CHECK(views[0].Camera == primary);
+	CHECK(views[0].ViewportWidth == 1600.0f);
+	CHECK(views[1].Camera == secondary);
+	CHECK(views[1].ViewportX == 1200.0f);
+	CHECK(views[1].ViewportWidth == 400.0f);
+	CHECK(views[1].ViewportHeight == 225.0f);
+
+	auto const& primaryCamera = registry.get<ECS::PerspectiveCameraComponent>(primary);
+	DirectX::XMFLOAT4X4 expected;
+	DirectX::XMStoreFloat4x4(&expected, DirectX::XMMatrixMultiply(primaryCamera.GetViewMatrix(), primaryCamera.GetProjectionMatrix(1600.0f / 900.0f)));
+	CHECK(std::memcmp(&views[0].Constants.ViewProjection, &expected, sizeof(expected)) == 0);
+	CHECK(views[0].Constants.CameraPosition.z == doctest::Approx(-5.0f));
+
+	// Nothing changed, both views are reused
+	setup.Build(registry, 1600.0f, 900.0f);
+	CHECK(setup.GetNumRecomputedViews() == 0);
+
+	// Only the changed camera is recomputed
+	registry.get<ECS::PerspectiveCameraComponent>(primary).FarZ = 500.0f;
+	setup.Build(registry, 1600.0f, 900.0f);
+	CHECK(setup.GetNumRecomputedViews() == 1);
+
+	// A resize changes every viewport
+	setup.Build(registry, 800.0f, 600.0f);
+	CHECK(setup.GetNumRecomputedViews() == 2);
+}
+
+TEST_CASE("View constants are written one constant buffer slot apart")
+{
+	static_assert(Graphics::ViewSetup::ConstantsStride % Graphics::ViewSetup::ConstantsAlignment == 0);
+	static_assert(Graphics::ViewSetup::ConstantsStride >= sizeof(Graphics::ViewConstants));
+
+	entt::registry registry;
+	CreateCamera(registry, true, -5.0f);
+	registry.get<ECS::PerspectiveCameraComponent>(CreateCamera(registry, false, -10.0f)).IsActive = true;
+
+	Graphics::ViewSetup setup;
+	setup.Build(registry, 1280.0f, 720.0f);
+	REQUIRE(setup.GetConstantsSize() == 2 * Graphics::ViewSetup::ConstantsStride);
+
+	std::vector<std::byte> constants(setup.GetConstantsSize());
+	setup.WriteConstants(constants.data());
+	for (std::size_t i = 0; i < 2; ++i)
+	{
+		CHECK(std::memcmp(constants.data() + Graphics::ViewSetup::GetConstantsOffset(i), &setup.GetViews()[i].Constants,
+			sizeof(Graphics::ViewConstants)) == 0);
+	}
+}